@@ -178,6 +178,13 @@ public:
    virtual size_t RealtimeProcess(int group, float **inBuf, float **outBuf, size_t numSamples) = 0;
    virtual bool RealtimeProcessEnd() = 0;
 
+   // Whether the processors made by RealtimeAddProcessor() share no state,
+   // so that the host may apply the effect to several channel groups at once,
+   // calling RealtimeProcess() for different groups from different threads.
+   // Their output must then be that of ProcessBlock().  Effects that don't
+   // say so are processed one group at a time.
+   virtual bool SupportsParallelProcessing() { return false; }
+
    virtual bool ShowInterface(wxWindow *parent, bool forceModal = false) = 0;
    // Some effects will use define params to define what parameters they take.
    // If they do, they won't need to implement Get or SetAutomation parameters.
@@ -110,9 +110,11 @@ void PipeServer()
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <string>
 
 const char fifotmpl[] = "/tmp/audacity_script_pipe.%s.%d";
 
@@ -124,9 +126,10 @@ extern "C" int DoSrvMore( char * pOut, int nMax );
 void PipeServer()
 {
    FILE *fromFifo = NULL;
-   FILE *toFifo = NULL;
+   int toFifo = -1;
    int rc;
    char buf[nBuff];
+   char readBuf[nBuff * 16];
    char toFifoName[nBuff];
    char fromFifoName[nBuff];
 
@@ -147,8 +150,8 @@ void PipeServer()
    }
 
    // open to (incoming) pipe first.  
-   toFifo = fopen(toFifoName, "r");
-   if (toFifo == NULL)
+   toFifo = open(toFifoName, O_RDONLY);
+   if (toFifo < 0)
    {
       perror("Unable to open fifo to server from script");
       if (fromFifo != NULL)
@@ -164,27 +167,39 @@ void PipeServer()
       return;
    }
 
-   while (fgets(buf, sizeof(buf), toFifo) != NULL)
+   // Commands are newline terminated.  All complete lines that have arrived
+   // by the time of a read are sent to Audacity together, as one batch, so
+   // that a script which writes many commands before reading the responses
+   // pays for only one round trip to the main thread.
+   std::string pending;
+   ssize_t nRead;
+   while ((nRead = read(toFifo, readBuf, sizeof(readBuf))) > 0)
    {
-      int len = strlen(buf);
-      if (len <= 1)
+      pending.append(readBuf, nRead);
+
+      std::string::size_type end = pending.rfind('\n');
+      if (end == std::string::npos)
       {
          continue;
       }
 
-      buf[len - 1] = '\0';
+      std::string batch = pending.substr(0, end);
+      pending.erase(0, end + 1);
+
+      if (batch.find_first_not_of("\r\n") == std::string::npos)
+      {
+         continue;
+      }
 
-      printf("Server received %s\n", buf);
-      DoSrv(buf);
+      DoSrv(&batch[0]);
 
       while (true)
       {
-         len = DoSrvMore(buf, nBuff);
+         int len = DoSrvMore(buf, nBuff);
          if (len <= 1)
          {
             break;
          }
-         printf("Server sending %s",buf);
 
          // len - 1 because we do not send the null character
          fwrite(buf, 1, len - 1, fromFifo);
@@ -194,8 +209,8 @@ void PipeServer()
 
    printf("Read failed on fifo, quitting\n");
 
-   if (toFifo != NULL)
-      fclose(toFifo);
+   if (toFifo >= 0)
+      close(toFifo);
 
    if (fromFifo != NULL)
       fclose(fromFifo);
@@ -152,6 +152,8 @@ size_t currentPosition;
 
 // Send the received command to Audacity and build an array of response lines.
 // The response lines can be retrieved by calling DoSrvMore repeatedly.
+// pIn may hold several newline-separated commands, which Audacity runs as
+// one batch; their responses follow one another, each ended by an empty line.
 int DoSrv(char *pIn)
 {
    // Interpret string as unicode.
@@ -160,7 +162,6 @@ int DoSrv(char *pIn)
    // Important for filenames in commands.
    wxString Str1(pIn, wxConvUTF8); 
    Str1.Replace( wxT("\r"), wxT(""));
-   Str1.Replace( wxT("\n"), wxT(""));
    Str2 = wxEmptyString;
    (*pScriptServerFn)( &Str1 , &Str2);
 
@@ -72,6 +72,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "Benchmark.h"
 #include "Clipboard.h"
 #include "CrashReport.h"
+#include "Diags.h"
 #include "DirManager.h"
 #include "commands/CommandHandler.h"
 #include "commands/AppCommandEvent.h"
@@ -113,8 +114,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "prefs/KeyConfigPrefs.h"
 #endif
 
-//temporarily commented out till it is added to all projects
-//#include "Profiler.h"
+#include "Profiler.h"
 
 #include "ModuleManager.h"
 
@@ -462,6 +462,7 @@ void PopulatePreferences()
 
 static bool gInited = false;
 static bool gIsQuitting = false;
+static wxString gTraceFileName;
 
 static void QuitAudacity(bool bForce)
 {
@@ -511,10 +512,6 @@ static void QuitAudacity(bool bForce)
    //release ODManager Threads
    ODManager::Quit();
 
-   //print out profile if we have one by deleting it
-   //temporarily commented out till it is added to all projects
-   //DELETE Profiler::Instance();
-
    //remove our logger
    std::unique_ptr<wxLog>{ wxLog::SetActiveTarget(NULL) }; // DELETE
 
@@ -1395,10 +1392,14 @@ bool AudacityApp::OnInit()
    InitCommandHandler();
 
    // Initialize the PluginManager
+   TIMER_START( "PluginManager::Initialize", plugin_init_timer );
    PluginManager::Get().Initialize();
+   TIMER_STOP( plugin_init_timer );
 
    // Initialize the ModuleManager, including loading found modules
+   TIMER_START( "ModuleManager::Initialize", module_init_timer );
    ModuleManager::Get().Initialize(*mCmdHandler);
+   TIMER_STOP( module_init_timer );
 
    // Parse command line and handle options that might require
    // immediate exit...no need to initialize all of the audio
@@ -1443,6 +1444,20 @@ bool AudacityApp::OnInit()
       exit(1);
    }
 
+   if (parser->Found(wxT("benchmark"), &fileName))
+   {
+      // Needs no project, so finish before any window is made; OnRun
+      // returns the status instead of entering the main loop
+      mBenchmarkStatus = RunHeadlessBenchmark(fileName) ? 0 : 1;
+      return true;
+   }
+
+   if (parser->Found(wxT("trace"), &gTraceFileName))
+   {
+      Profiler::Instance()->StartTracing();
+      Profiler::Instance()->SetThreadName("Main");
+   }
+
    // BG: Create a temporary window to set as the top window
    wxImage logoimage((const char **)AudacityLogoWithName_xpm);
    logoimage.Rescale(logoimage.GetWidth() / 2, logoimage.GetHeight() / 2);
@@ -2005,6 +2020,18 @@ std::unique_ptr<wxCmdLineParser> AudacityApp::ParseCommandLine()
    parser->AddOption(wxT("d"), wxT("decode"), _("decode an autosave file"),
                      wxCMD_LINE_VAL_STRING);
 
+   /*i18n-hint: This runs speed tests of Audacity itself, writing the
+    *           results to the named file */
+   parser->AddLongOption(wxT("benchmark"),
+                         _("run the benchmark suite and write JSON results to a file"),
+                         wxCMD_LINE_VAL_STRING);
+
+   /*i18n-hint: This records what Audacity's threads do over time, writing
+    *           a timeline to the named file on exit */
+   parser->AddLongOption(wxT("trace"),
+                         _("record a Chrome trace of the session to a file"),
+                         wxCMD_LINE_VAL_STRING);
+
    /*i18n-hint: This displays a list of available options */
    parser->AddSwitch(wxT("h"), wxT("help"), _("this help message"),
                      wxCMD_LINE_OPTION_HELP);
@@ -2061,8 +2088,25 @@ void AudacityApp::OnEndSession(wxCloseEvent & event)
    }
 }
 
+int AudacityApp::OnRun()
+{
+   if (mBenchmarkStatus >= 0)
+      return mBenchmarkStatus;
+
+   return wxApp::OnRun();
+}
+
 int AudacityApp::OnExit()
 {
+   if (mBenchmarkStatus >= 0)
+   {
+      // The benchmark ran before the file history and importers were
+      // loaded, so don't save them over the user's
+      FinishPreferences();
+      PluginManager::Get().Terminate();
+      return 0;
+   }
+
    gIsQuitting = true;
    while(Pending())
    {
@@ -2095,6 +2139,14 @@ int AudacityApp::OnExit()
 
    AudioIO::Deinit();
 
+   if (!gTraceFileName.empty())
+   {
+      // Audio and on-demand threads have stopped by now
+      Profiler::Instance()->StopTracing();
+      if (!Profiler::Instance()->WriteTrace(gTraceFileName))
+         wxPrintf(wxT("Could not write trace to %s\n"), gTraceFileName);
+   }
+
    // Terminate the PluginManager (must be done before deleting the locale)
    PluginManager::Get().Terminate();
 
@@ -45,6 +45,7 @@ class AudacityApp final : public wxApp {
    AudacityApp();
    ~AudacityApp();
    bool OnInit(void) override;
+   int OnRun(void) override;
    int OnExit(void) override;
    void OnFatalException() override;
    bool OnExceptionInMainLoop() override;
@@ -106,6 +107,9 @@ class AudacityApp final : public wxApp {
 
    wxTimer mTimer;
 
+   // Exit status of a headless benchmark run, or -1 if none ran
+   int mBenchmarkStatus{ -1 };
+
    void InitCommandHandler();
 
    bool InitTempDir();
@@ -427,6 +427,7 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include <math.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <chrono>
 
 #ifdef __WXMSW__
 #include <malloc.h>
@@ -451,6 +452,7 @@ time warp info and AudioIOListener and whether the playback is looped.
 
 #include "MissingAliasFileDialog.h"
 #include "Mix.h"
+#include "Profiler.h"
 #include "Resample.h"
 #include "RingBuffer.h"
 #include "prefs/GUISettings.h"
@@ -977,6 +979,9 @@ AudioIO::AudioIO()
    mNumCaptureChannels = 0;
    mPaused = false;
 
+   mCompensationLatency = 0;
+   mMaxCompensationLatency = 0;
+
    mUpdateMeters = false;
    mUpdatingMeters = false;
 
@@ -1347,6 +1352,9 @@ bool AudioIO::StartPortAudioStream(const AudioIOStartStreamOptions &options,
       maxTries = 5;
 #endif
 
+   // The callback must not allocate its trace buffer
+   Profiler::Instance()->ReserveThreadBuffer();
+
    for (unsigned int tries = 0; tries < maxTries; tries++) {
       mLastPaError = Pa_OpenStream( &mPortStreamV19,
                                     useCapture ? &captureParameters : NULL,
@@ -1467,6 +1475,8 @@ int AudioIO::StartStream(const TransportTracks &tracks,
    if( IsBusy() )
       return 0;
 
+   mHealth.Reset();
+
    // We just want to set mStreamToken to -1 - this way avoids
    // an extremely rare but possible race condition, if two functions
    // somehow called StartStream at the same time...
@@ -1556,6 +1566,7 @@ int AudioIO::StartStream(const TransportTracks &tracks,
 
    mPlaybackBuffers.reset();
    mPlaybackMixers.reset();
+   mLatencyCompensation.reset();
    mCaptureBuffers.reset();
    mResample.reset();
    mTimeQueue.mData.reset();
@@ -1857,6 +1868,15 @@ bool AudioIO::AllocateBuffers(
 
             mPlaybackBuffers.reinit(mPlaybackTracks.size());
             mPlaybackMixers.reinit(mPlaybackTracks.size());
+            mLatencyCompensation.reinit(mPlaybackTracks.size());
+            mCompensationLatency = 0;
+
+            // The realtime effects may change their latency while playing,
+            // so allocate here the rings for the longest that we compensate
+            mMaxCompensationLatency =
+               (size_t)lrint(mRate * MaxCompensationLatencySecs);
+            for (unsigned int i = 0; i < mPlaybackTracks.size(); i++)
+               mLatencyCompensation[i].buffer.reinit(mMaxCompensationLatency);
 
             const Mixer::WarpOptions &warpOptions =
 #ifdef EXPERIMENTAL_SCRUBBING_SUPPORT
@@ -1895,7 +1915,11 @@ bool AudioIO::AllocateBuffers(
 
                // use track time for the end time, not real time!
                WaveTrackConstArray mixTracks;
-               mixTracks.push_back(mPlaybackTracks[i]);
+               std::shared_ptr< const WaveTrack > source;
+               if (options.playbackSource)
+                  source = options.playbackSource(*mPlaybackTracks[i], mRate);
+               mixTracks.push_back(
+                  source ? source : mPlaybackTracks[i] );
 
                double endTime;
                if (make_iterator_range(tracks.prerollTracks)
@@ -1988,6 +2012,7 @@ void AudioIO::StartStreamCleanup(bool bOnlyBuffers)
 
    mPlaybackBuffers.reset();
    mPlaybackMixers.reset();
+   mLatencyCompensation.reset();
    mCaptureBuffers.reset();
    mResample.reset();
    mTimeQueue.mData.reset();
@@ -2294,6 +2319,7 @@ void AudioIO::StopStream()
       {
          mPlaybackBuffers.reset();
          mPlaybackMixers.reset();
+         mLatencyCompensation.reset();
          mTimeQueue.mData.reset();
       }
 
@@ -2538,6 +2564,7 @@ finished:
 
 AudioThread::ExitCode AudioThread::Entry()
 {
+   Profiler::Instance()->SetThreadName("Audio");
    AudioIO *gAudioIO;
    while( !TestDestroy() &&
       nullptr != ( gAudioIO = AudioIO::Get() ) )
@@ -2629,6 +2656,13 @@ size_t AudioIO::GetCommonlyAvailCapture()
 // (which communicates with the audio device).
 void AudioIO::FillBuffers()
 {
+   PROFILE_SCOPE("AudioIO::FillBuffers");
+   const auto fillStart = std::chrono::steady_clock::now();
+   auto recordHealth = finally( [&] {
+      mHealth.mFillBuffersTime.Add( std::chrono::duration<double, std::milli>(
+         std::chrono::steady_clock::now() - fillStart ).count() );
+   } );
+
    unsigned int i;
 
    auto delayedHandler = [this] ( AudacityException * pException ) {
@@ -2972,9 +3006,13 @@ void AudioIO::FillBuffers()
 
                // Now append
                // see comment in second handler about guarantee
+               const auto appendStart = std::chrono::steady_clock::now();
                mCaptureTracks[i]->Append(temp.ptr(), format,
                   size, 1,
                   &appendLog);
+               mHealth.mDiskWriteTime.Add(
+                  std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - appendStart ).count() );
 
                if (!appendLog.IsEmpty())
                {
@@ -3745,6 +3783,51 @@ void AudioIoCallback::AddToOutputChannel( unsigned int chan,
       outputFloats[numPlaybackChannels*i+chan] += (oldGain + deltaGain * i) *tempBuf[i];
 };
 
+// Called when the realtime effects change the delay of the tracks they
+// process.  The rings were allocated with the stream, so this only clamps
+// the delay to their length and restarts them from silence.
+void AudioIoCallback::SetCompensationLatency(size_t latency)
+{
+   mCompensationLatency = std::min(latency, mMaxCompensationLatency);
+   for (unsigned t = 0; t < mPlaybackTracks.size(); t++)
+   {
+      auto &compensation = mLatencyCompensation[t];
+      compensation.pos = 0;
+      compensation.active = false;
+   }
+}
+
+// Delays the samples of a track that skipped the realtime effects, in
+// place, by exchanging them with the oldest in the track's ring
+void AudioIoCallback::CompensateLatency(
+   unsigned t, float *buffer, unsigned long len)
+{
+   const auto latency = mCompensationLatency;
+   auto &compensation = mLatencyCompensation[t];
+   float *ring = compensation.buffer.get();
+
+   // Start from silence, not from what the track played when it was
+   // last delayed
+   if (!compensation.active)
+   {
+      std::fill(ring, ring + latency, 0.0f);
+      compensation.pos = 0;
+      compensation.active = true;
+   }
+
+   auto pos = compensation.pos;
+   for (decltype(len) i = 0; i < len;)
+   {
+      const auto n = std::min<size_t>(len - i, latency - pos);
+      std::swap_ranges(buffer + i, buffer + i + n, ring + pos);
+      i += n;
+      pos += n;
+      if (pos == latency)
+         pos = 0;
+   }
+   compensation.pos = pos;
+}
+
 // Limit values to -1.0..+1.0
 void ClampBuffer(float * pBuffer, unsigned long len){
    for(unsigned i = 0; i < len; i++)
@@ -3789,22 +3872,114 @@ bool AudioIoCallback::FillOutputBuffers(
       return true;
    }
 
+   auto & em = RealtimeEffectManager::Get();
+   em.RealtimeProcessStart();
+
+   // Groups (tracks) are read into a batch of slots, and each full batch
+   // goes through the realtime effects at once, so that they can work on
+   // its groups in parallel, before the groups are mixed in order.
+   struct PlaybackGroup
+   {
+      WaveTrack **chans;
+      unsigned *tracks;
+      float **bufs;
+      int chanCnt;
+      int group;
+      bool selected;
+      bool drop;
+      bool dropQuickly;
+      decltype(framesPerBuffer) len;
+   };
+   const size_t batchSize = std::max<size_t>(1,
+      std::min<size_t>(em.GetRealtimeConcurrency(), numPlaybackTracks));
+
    // ------ MEMORY ALLOCATION ----------------------
    // These are small structures.
-   WaveTrack **chans = (WaveTrack **) alloca(numPlaybackChannels * sizeof(WaveTrack *));
-   float **tempBufs = (float **) alloca(numPlaybackChannels * sizeof(float *));
-
-   // And these are larger structures....
-   for (unsigned int c = 0; c < numPlaybackChannels; c++)
-      tempBufs[c] = (float *) alloca(framesPerBuffer * sizeof(float));
+   auto batch = (PlaybackGroup *) alloca(batchSize * sizeof(PlaybackGroup));
+   auto groups = (RealtimeEffectManager::Group *)
+      alloca(batchSize * sizeof(RealtimeEffectManager::Group));
+   for (size_t ii = 0; ii < batchSize; ++ii)
+   {
+      auto &slot = batch[ii];
+      slot.chans = (WaveTrack **) alloca(numPlaybackChannels * sizeof(WaveTrack *));
+      slot.tracks = (unsigned *) alloca(numPlaybackChannels * sizeof(unsigned));
+      slot.bufs = (float **) alloca(numPlaybackChannels * sizeof(float *));
+
+      // And these are larger structures....
+      for (unsigned int c = 0; c < numPlaybackChannels; c++)
+         slot.bufs[c] = (float *) alloca(framesPerBuffer * sizeof(float));
+   }
    // ------ End of MEMORY ALLOCATION ---------------
 
-   auto & em = RealtimeEffectManager::Get();
-   em.RealtimeProcessStart();
+   size_t nSlots = 0;
+   bool processed = false;
+   const auto flushBatch = [&]{
+      // Apply the effects to the batch
+      size_t nGroups = 0;
+      for (size_t ii = 0; ii < nSlots; ++ii)
+      {
+         const auto &slot = batch[ii];
+         if( !slot.dropQuickly && slot.selected )
+            groups[nGroups++] = {
+               slot.group, (unsigned) slot.chanCnt, slot.bufs, slot.len };
+      }
+      if (nGroups > 0)
+      {
+         const auto latency = em.RealtimeProcess(groups, nGroups);
+         if (latency != mCompensationLatency)
+            SetCompensationLatency(latency);
+         processed = true;
+      }
+
+      for (size_t ii = 0; ii < nSlots; ++ii)
+      {
+         const auto &slot = batch[ii];
+         const auto len = slot.len;
+
+         // Keep the groups that the effects skipped in step with those
+         // that they delayed
+         if (mCompensationLatency > 0 && !slot.dropQuickly)
+         {
+            for (int c = 0; c < slot.chanCnt; c++)
+            {
+               if (slot.selected)
+                  mLatencyCompensation[slot.tracks[c]].active = false;
+               else
+                  CompensateLatency(slot.tracks[c], slot.bufs[c], len);
+            }
+         }
+
+         CallbackCheckCompletion(mCallbackReturn, len);
+         if (slot.dropQuickly) // no samples to process, they've been discarded
+            continue;
+
+         // Our channels aren't silent.  We need to pass their data on.
+         //
+         // Note that there are two kinds of channel count.
+         // c and chanCnt are counting channels in the Tracks.
+         // chan (and numPlayBackChannels) is counting output channels on the device.
+         // chan = 0 is left channel
+         // chan = 1 is right channel.
+         //
+         // Each channel in the tracks can output to more than one channel on the device.
+         // For example mono channels output to both left and right output channels.
+         if (len > 0) for (int c = 0; c < slot.chanCnt; c++)
+         {
+            const auto vt = slot.chans[c];
+
+            if (vt->GetChannelIgnoringPan() == Track::LeftChannel ||
+                  vt->GetChannelIgnoringPan() == Track::MonoChannel )
+               AddToOutputChannel( 0, outputMeterFloats, outputFloats, tempFloats, slot.bufs[c], slot.drop, len, vt);
+
+            if (vt->GetChannelIgnoringPan() == Track::RightChannel ||
+                  vt->GetChannelIgnoringPan() == Track::MonoChannel  )
+               AddToOutputChannel( 1, outputMeterFloats, outputFloats, tempFloats, slot.bufs[c], slot.drop, len, vt);
+         }
+      }
+      nSlots = 0;
+   };
 
-   bool selected = false;
    int group = 0;
-   int chanCnt = 0;
 
    // Choose a common size to take from all ring buffers
    const auto toGet =
@@ -3823,12 +3998,11 @@ bool AudioIoCallback::FillOutputBuffers(
    // I would expect us not to need the fast paths, since linearly interpolated gain
    // is very cheap to process.
 
-   bool drop = false;        // Track should become silent.
-   bool dropQuickly = false; // Track has already been faded to silence.
    for (unsigned t = 0; t < numPlaybackTracks; t++)
    {
       WaveTrack *vt = mPlaybackTracks[t].get();
-      chans[chanCnt] = vt;
+      auto &slot = batch[nSlots];
+      auto &chanCnt = slot.chanCnt;
 
       // TODO: more-than-two-channels
       auto nextTrack =
@@ -3843,22 +4017,27 @@ bool AudioIoCallback::FillOutputBuffers(
 
       if ( firstChannel )
       {
-         selected = vt->GetSelected();
+         chanCnt = 0;
+         slot.group = group;
+         slot.selected = vt->GetSelected();
          // IF mono THEN clear 'the other' channel.
          if ( lastChannel && (numPlaybackChannels>1)) {
             // TODO: more-than-two-channels
-            memset(tempBufs[1], 0, framesPerBuffer * sizeof(float));
+            memset(slot.bufs[1], 0, framesPerBuffer * sizeof(float));
          }
-         drop = TrackShouldBeSilent( *vt );
-         dropQuickly = drop;
+         slot.drop = TrackShouldBeSilent( *vt );
+         slot.dropQuickly = slot.drop;
       }
 
+      slot.chans[chanCnt] = vt;
+      slot.tracks[chanCnt] = t;
+
       if( mbMicroFades )
-         dropQuickly = dropQuickly && TrackHasBeenFadedOut( *vt );
+         slot.dropQuickly = slot.dropQuickly && TrackHasBeenFadedOut( *vt );
          
       decltype(framesPerBuffer) len = 0;
 
-      if (dropQuickly)
+      if (slot.dropQuickly)
       {
          len = mPlaybackBuffers[t]->Discard(framesPerBuffer);
          // keep going here.  
@@ -3866,7 +4045,7 @@ bool AudioIoCallback::FillOutputBuffers(
       }
       else
       {
-         len = mPlaybackBuffers[t]->Get((samplePtr)tempBufs[chanCnt],
+         len = mPlaybackBuffers[t]->Get((samplePtr)slot.bufs[chanCnt],
                                                    floatSample,
                                                    toGet);
          // wxASSERT( len == toGet );
@@ -3877,7 +4056,7 @@ bool AudioIoCallback::FillOutputBuffers(
             // real-time demand in this thread (see bug 1932).  We
             // must supply something to the sound card, so pad it with
             // zeroes and not random garbage.
-            memset((void*)&tempBufs[chanCnt][len], 0,
+            memset((void*)&slot.bufs[chanCnt][len], 0,
                (framesPerBuffer - len) * sizeof(float));
          chanCnt++;
       }
@@ -3895,41 +4074,17 @@ bool AudioIoCallback::FillOutputBuffers(
          continue;
 
       // Last channel of a track seen now
-      len = mMaxFramesOutput;
-
-      if( !dropQuickly && selected )
-         len = em.RealtimeProcess(group, chanCnt, tempBufs, len);
+      slot.len = mMaxFramesOutput;
       group++;
 
-      CallbackCheckCompletion(mCallbackReturn, len);
-      if (dropQuickly) // no samples to process, they've been discarded
-         continue;
-
-      // Our channels aren't silent.  We need to pass their data on.
-      //
-      // Note that there are two kinds of channel count.
-      // c and chanCnt are counting channels in the Tracks.
-      // chan (and numPlayBackChannels) is counting output channels on the device.
-      // chan = 0 is left channel
-      // chan = 1 is right channel.
-      //
-      // Each channel in the tracks can output to more than one channel on the device.
-      // For example mono channels output to both left and right output channels.
-      if (len > 0) for (int c = 0; c < chanCnt; c++)
-      {
-         vt = chans[c];
-
-         if (vt->GetChannelIgnoringPan() == Track::LeftChannel ||
-               vt->GetChannelIgnoringPan() == Track::MonoChannel )
-            AddToOutputChannel( 0, outputMeterFloats, outputFloats, tempFloats, tempBufs[c], drop, len, vt);
-
-         if (vt->GetChannelIgnoringPan() == Track::RightChannel ||
-               vt->GetChannelIgnoringPan() == Track::MonoChannel  )
-            AddToOutputChannel( 1, outputMeterFloats, outputFloats, tempFloats, tempBufs[c], drop, len, vt);
-      }
-
-      chanCnt = 0;
+      if (++nSlots == batchSize)
+         flushBatch();
    }
+   flushBatch();
+
+   // Without effects applied, there is nothing to keep in step with
+   if (!processed && mCompensationLatency > 0)
+      SetCompensationLatency(0);
 
    // Poke: If there are no playback tracks, then the earlier check
    // about the time indicator being past the end won't happen;
@@ -4316,6 +4471,31 @@ int AudioIoCallback::AudioCallback(const void *inputBuffer, void *outputBuffer,
                           const PaStreamCallbackTimeInfo *timeInfo,
                           const PaStreamCallbackFlags statusFlags, void * WXUNUSED(userData) )
 {
+   PROFILE_SCOPE("AudioIoCallback::AudioCallback");
+   const auto callbackStart = std::chrono::steady_clock::now();
+   auto recordHealth = finally( [&] {
+      mHealth.RecordCallback(
+         std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - callbackStart ).count(),
+         framesPerBuffer / mRate,
+         (statusFlags & paOutputUnderflow) != 0,
+         (statusFlags & paInputOverflow) != 0 );
+   } );
+
+   // Ring buffer occupancy before this callback drains or fills them
+   if (mPlaybackTracks.size() > 0) {
+      const auto filled = mPlaybackBuffers[0]->AvailForGet();
+      const auto size = filled + mPlaybackBuffers[0]->AvailForPut();
+      if (size > 0)
+         mHealth.mPlaybackFill.Add( 100.0 * filled / size );
+   }
+   if (mCaptureTracks.size() > 0) {
+      const auto filled = mCaptureBuffers[0]->AvailForGet();
+      const auto size = filled + mCaptureBuffers[0]->AvailForPut();
+      if (size > 0)
+         mHealth.mCaptureFill.Add( 100.0 * filled / size );
+   }
+
    mbHasSoloTracks = CountSoloingTracks() > 0 ;
    mCallbackReturn = paContinue;
 
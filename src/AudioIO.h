@@ -16,6 +16,7 @@
 #include "Audacity.h" // for USE_* macros
 
 #include "AudioIOBase.h" // to inherit
+#include "AudioIOHealth.h" // member variable
 
 #include "Experimental.h"
 
@@ -281,6 +282,8 @@ public:
       unsigned long framesPerBuffer,
       float * tempFloats, float *outputMeterFloats
    );
+   void SetCompensationLatency(size_t latency);
+   void CompensateLatency(unsigned t, float *buffer, unsigned long len);
    void FillInputBuffers(
       const void *inputBuffer, 
       unsigned long framesPerBuffer,
@@ -425,6 +428,24 @@ public:
    WaveTrackArray      mPlaybackTracks;
 
    ArrayOf<std::unique_ptr<Mixer>> mPlaybackMixers;
+
+   // Delays a playback track that the realtime effects skip, by as much as
+   // they delay the tracks they process
+   struct LatencyCompensation
+   {
+      Floats buffer;
+      size_t pos{ 0 };
+      // Whether the track was delayed in the previous callback, so that
+      // the buffer holds its recent samples
+      bool active{ false };
+   };
+   ArrayOf<LatencyCompensation> mLatencyCompensation;
+   size_t              mCompensationLatency;
+   // Length of each compensation ring; longer latencies are compensated
+   // only in part
+   size_t              mMaxCompensationLatency;
+   static constexpr double MaxCompensationLatencySecs = 2.0;
+
    static int          mNextStreamToken;
    double              mFactor;
    unsigned long       mMaxFramesOutput; // The actual number of frames output.
@@ -448,6 +469,8 @@ public:
    unsigned int        mNumPlaybackChannels;
    sampleFormat        mCaptureFormat;
    unsigned long long  mLostSamples{ 0 };
+   /// Callback, ring buffer and disk timing of the current stream
+   AudioIOHealth       mHealth;
    volatile bool       mAudioThreadShouldCallFillBuffersOnce;
    volatile bool       mAudioThreadFillBuffersLoopRunning;
    volatile bool       mAudioThreadFillBuffersLoopActive;
@@ -33,6 +33,7 @@ class AudacityProject;
 class AudioIOListener;
 class BoundedEnvelope;
 class MeterPanelBase;
+class WaveTrack;
 using PRCrossfadeData = std::vector< std::vector < float > >;
 
 #define BAD_STREAM_TIME (-DBL_MAX)
@@ -107,6 +108,11 @@ struct AudioIOStartStreamOptions
    // we can't use a separate polling thread.
    // The return value is a number of milliseconds to sleep before calling again
    std::function< unsigned long() > playbackStreamPrimer;
+
+   // May give, for a playback track, a rendering of it at the given rate
+   // with its envelope applied, to read instead of the track; or null
+   std::function< std::shared_ptr< const WaveTrack >
+      ( const WaveTrack &track, double rate ) > playbackSource;
 };
 
 ///\brief A singleton object supporting queries of the state of any active
@@ -0,0 +1,146 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  AudioIOHealth.cpp
+
+*******************************************************************//**
+
+\class HealthHistogram
+\brief Counts values into bins of fixed edges, without locking.
+
+\class AudioIOHealth
+\brief Histograms and counters of how close the audio engine runs to
+dropping samples.
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "AudioIOHealth.h"
+
+#include <algorithm>
+#include <limits>
+#include <wx/string.h>
+
+HealthHistogram::HealthHistogram( std::initializer_list<double> edges )
+   : mEdges( edges )
+   , mCounts( mEdges.size() + 1 )
+{
+   Reset();
+}
+
+void HealthHistogram::Add( double value )
+{
+   const auto bin =
+      std::lower_bound( mEdges.begin(), mEdges.end(), value ) - mEdges.begin();
+   mCounts[bin].fetch_add( 1, std::memory_order_relaxed );
+   mTotal.fetch_add( 1, std::memory_order_relaxed );
+
+   // There is only one writer, so load and store need not be one atomic step
+   mSum.store( mSum.load( std::memory_order_relaxed ) + value,
+      std::memory_order_relaxed );
+   if ( value > mMax.load( std::memory_order_relaxed ) )
+      mMax.store( value, std::memory_order_relaxed );
+}
+
+void HealthHistogram::Reset()
+{
+   for ( size_t bin = 0; bin < NumBins(); ++bin )
+      mCounts[bin].store( 0, std::memory_order_relaxed );
+   mTotal.store( 0, std::memory_order_relaxed );
+   mSum.store( 0, std::memory_order_relaxed );
+   mMax.store( 0, std::memory_order_relaxed );
+}
+
+double HealthHistogram::UpperEdge( size_t bin ) const
+{
+   if ( bin < mEdges.size() )
+      return mEdges[bin];
+   return std::numeric_limits<double>::infinity();
+}
+
+double HealthHistogram::Mean() const
+{
+   const auto total = Total();
+   if ( total == 0 )
+      return 0;
+   return mSum.load( std::memory_order_relaxed ) / total;
+}
+
+AudioIOHealth::AudioIOHealth()
+   : mCallbackLoad{ 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 150 }
+   , mPlaybackFill{ 10, 20, 30, 40, 50, 60, 70, 80, 90 }
+   , mCaptureFill{ 10, 20, 30, 40, 50, 60, 70, 80, 90 }
+   , mFillBuffersTime{ 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 500 }
+   , mDiskWriteTime{ 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 500 }
+{
+   Reset();
+}
+
+void AudioIOHealth::Reset()
+{
+   mCallbackLoad.Reset();
+   mPlaybackFill.Reset();
+   mCaptureFill.Reset();
+   mFillBuffersTime.Reset();
+   mDiskWriteTime.Reset();
+   mCallbacks.store( 0, std::memory_order_relaxed );
+   mLateCallbacks.store( 0, std::memory_order_relaxed );
+   mOutputUnderflows.store( 0, std::memory_order_relaxed );
+   mInputOverflows.store( 0, std::memory_order_relaxed );
+}
+
+void AudioIOHealth::RecordCallback( double seconds, double period,
+   bool outputUnderflow, bool inputOverflow )
+{
+   mCallbacks.fetch_add( 1, std::memory_order_relaxed );
+   if ( period > 0 )
+      mCallbackLoad.Add( 100 * seconds / period );
+   if ( seconds > period )
+      mLateCallbacks.fetch_add( 1, std::memory_order_relaxed );
+   if ( outputUnderflow )
+      mOutputUnderflows.fetch_add( 1, std::memory_order_relaxed );
+   if ( inputOverflow )
+      mInputOverflows.fetch_add( 1, std::memory_order_relaxed );
+}
+
+void AudioIOHealth::VisitHistograms( const HistogramVisitor &visitor ) const
+{
+   visitor( wxT("CallbackLoad"), wxT("%"), mCallbackLoad );
+   visitor( wxT("PlaybackFill"), wxT("%"), mPlaybackFill );
+   visitor( wxT("CaptureFill"), wxT("%"), mCaptureFill );
+   visitor( wxT("FillBuffersTime"), wxT("ms"), mFillBuffersTime );
+   visitor( wxT("DiskWriteTime"), wxT("ms"), mDiskWriteTime );
+}
+
+wxString AudioIOHealth::Report() const
+{
+   wxString result;
+   result += wxString::Format( wxT("Callbacks: %llu\n"),
+      mCallbacks.load( std::memory_order_relaxed ) );
+   result += wxString::Format( wxT("Late callbacks: %llu\n"),
+      mLateCallbacks.load( std::memory_order_relaxed ) );
+   result += wxString::Format( wxT("Output underflows: %llu\n"),
+      mOutputUnderflows.load( std::memory_order_relaxed ) );
+   result += wxString::Format( wxT("Input overflows: %llu\n"),
+      mInputOverflows.load( std::memory_order_relaxed ) );
+
+   VisitHistograms( [&]( const wxString &name, const wxString &unit,
+      const HealthHistogram &histogram ) {
+      result += wxString::Format(
+         wxT("\n%s (%s): count %llu, mean %.3f, max %.3f\n"),
+         name, unit, histogram.Total(), histogram.Mean(), histogram.Max() );
+      const auto total = histogram.Total();
+      for ( size_t bin = 0; bin < histogram.NumBins(); ++bin ) {
+         const auto count = histogram.Count( bin );
+         const auto edge = histogram.UpperEdge( bin );
+         const auto label = bin + 1 < histogram.NumBins()
+            ? wxString::Format( wxT("<= %g"), edge )
+            : wxString::Format( wxT(" > %g"), histogram.UpperEdge( bin - 1 ) );
+         result += wxString::Format( wxT("   %-10s %10llu  %5.1f%%\n"),
+            label, count, total ? 100.0 * count / total : 0.0 );
+      }
+   } );
+
+   return result;
+}
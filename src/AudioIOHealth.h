@@ -0,0 +1,94 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  AudioIOHealth.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_AUDIO_IO_HEALTH__
+#define __AUDACITY_AUDIO_IO_HEALTH__
+
+#include "MemoryX.h"
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+class wxString;
+
+///\brief Counts values into bins of fixed edges.  One thread may add
+///values while others read them; nothing locks.
+class HealthHistogram
+{
+public:
+   /// Upper edges of all bins but the last, increasing; the last bin is
+   /// unbounded
+   HealthHistogram( std::initializer_list<double> edges );
+
+   /// Only one thread may add values to a histogram
+   void Add( double value );
+   void Reset();
+
+   size_t NumBins() const { return mEdges.size() + 1; }
+   /// Infinity for the last bin
+   double UpperEdge( size_t bin ) const;
+   unsigned long long Count( size_t bin ) const
+   { return mCounts[bin].load( std::memory_order_relaxed ); }
+
+   unsigned long long Total() const
+   { return mTotal.load( std::memory_order_relaxed ); }
+   double Mean() const;
+   double Max() const
+   { return mMax.load( std::memory_order_relaxed ); }
+
+private:
+   const std::vector<double> mEdges;
+   ArrayOf< std::atomic<unsigned long long> > mCounts;
+   std::atomic<unsigned long long> mTotal;
+   std::atomic<double> mSum;
+   std::atomic<double> mMax;
+};
+
+///\brief Telemetry of the audio engine, to size hardware and tune the
+///buffer settings.  The PortAudio callback and the Audio thread write it;
+///AudioIO resets it when a stream starts.
+class AudioIOHealth
+{
+public:
+   AudioIOHealth();
+
+   void Reset();
+
+   /// Called by the PortAudio thread at the end of every callback
+   void RecordCallback( double seconds, double period,
+      bool outputUnderflow, bool inputOverflow );
+
+   /// Percentage of the buffer period that each callback takes
+   HealthHistogram mCallbackLoad;
+   /// Percentage of the playback ring buffer filled, seen by the callback
+   HealthHistogram mPlaybackFill;
+   /// Percentage of the capture ring buffer filled, seen by the callback
+   HealthHistogram mCaptureFill;
+   /// Milliseconds spent in each AudioIO::FillBuffers
+   HealthHistogram mFillBuffersTime;
+   /// Milliseconds spent appending recorded samples to a track
+   HealthHistogram mDiskWriteTime;
+
+   std::atomic<unsigned long long> mCallbacks;
+   /// Callbacks that took longer than their buffer period
+   std::atomic<unsigned long long> mLateCallbacks;
+   /// Counts of flags that PortAudio passed to the callback
+   std::atomic<unsigned long long> mOutputUnderflows;
+   std::atomic<unsigned long long> mInputOverflows;
+
+   using HistogramVisitor = std::function< void(
+      const wxString &name, const wxString &unit,
+      const HealthHistogram &histogram ) >;
+   void VisitHistograms( const HistogramVisitor &visitor ) const;
+
+   /// Plain text summary, for display
+   wxString Report() const;
+};
+
+#endif
@@ -113,6 +113,7 @@ bool RecordingRecoveryHandler::HandleXMLTag(const wxChar *tag,
 
       seq->AppendBlockFile(blockFile);
       clip->UpdateEnvelopeTrackLen();
+      clip->NoteLayoutChange();
 
    } else if (wxStrcmp(tag, wxT("recordingrecovery")) == 0)
    {
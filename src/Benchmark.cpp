@@ -12,6 +12,11 @@
 \brief BenchmarkDialog is used for measuring performance and accuracy
 of the BlockFile system.
 
+RunHeadlessBenchmark() times sequence editing, block file input and
+output, wave display and spectrogram computation, mixing, and some
+built-in effects, without a project, and writes the results as JSON for
+comparing builds.
+
 *//*******************************************************************/
 
 
@@ -25,6 +30,7 @@ of the BlockFile system.
 #include <wx/checkbox.h>
 #include <wx/choice.h>
 #include <wx/dialog.h>
+#include <wx/ffile.h>
 #include <wx/filedlg.h>
 #include <wx/sizer.h>
 #include <wx/stattext.h>
@@ -35,6 +41,7 @@ of the BlockFile system.
 #include <wx/intl.h>
 
 #include "DirManager.h"
+#include "Mix.h"
 #include "ShuttleGui.h"
 #include "Project.h"
 #include "WaveClip.h"
@@ -44,6 +51,10 @@ of the BlockFile system.
 #include "ViewInfo.h"
 
 #include "FileNames.h"
+#include "effects/Amplify.h"
+#include "effects/Equalization.h"
+#include "effects/NoiseReduction.h"
+#include "effects/Normalize.h"
 #include "widgets/AudacityMessageBox.h"
 #include "widgets/wxPanelWrapper.h"
 
@@ -560,3 +571,318 @@ void BenchmarkDialog::OnRun( wxCommandEvent & WXUNUSED(event))
    Printf(_("Benchmark completed successfully.\n"));
    HoldPrint(false);
 }
+
+//
+// Headless benchmark
+//
+
+namespace {
+
+const double kRate = 44100;
+const int kSeconds = 300;
+const int kEdits = 1000;
+const int kMixerTracks = 8;
+const double kEffectSeconds = 60;
+
+struct BenchmarkResult
+{
+   wxString name;
+   long ms;
+   // How much work was done, counted in units such as samples or pixels
+   double count;
+   wxString units;
+};
+
+class HeadlessBenchmark
+{
+public:
+   HeadlessBenchmark();
+
+   // Returns false if any test could not run
+   bool Run();
+   wxString ToJSON() const;
+
+private:
+   template< typename Function >
+   void Time(const wxString &name, double count, const wxString &units,
+             const Function &function);
+
+   void TestAppend();
+   void TestRead();
+   void TestEdits();
+   void TestWaveDisplay();
+   void TestSpectrogram();
+   void TestMixer(const wxString &name, double rate);
+   void TestEffects();
+   bool StartEffect(const wxString &name, Effect &effect);
+   void TestEffect(const wxString &name, Effect &effect);
+
+   std::vector<BenchmarkResult> mResults;
+   bool mFailed{ false };
+
+   ZoomInfo mZoomInfo;
+   std::shared_ptr<DirManager> mDirManager;
+   TrackFactory mFactory;
+   std::shared_ptr<WaveTrack> mTrack;
+};
+
+HeadlessBenchmark::HeadlessBenchmark()
+   : mZoomInfo(0.0, ZoomInfo::GetDefaultZoom())
+   , mDirManager(DirManager::Create())
+   , mFactory(mDirManager, &mZoomInfo)
+{
+   mTrack = mFactory.NewWaveTrack(floatSample, kRate);
+}
+
+template< typename Function >
+void HeadlessBenchmark::Time(const wxString &name,
+   double count, const wxString &units, const Function &function)
+{
+   wxStopWatch timer;
+   function();
+   mResults.push_back({ name, timer.Time(), count, units });
+}
+
+bool HeadlessBenchmark::Run()
+{
+   // Later tests use the track made by the first
+   TestAppend();
+   TestRead();
+   TestWaveDisplay();
+   TestSpectrogram();
+   TestMixer(wxT("mixer_same_rate"), kRate);
+   TestMixer(wxT("mixer_resampled"), 48000);
+   TestEffects();
+   TestEdits();
+   return !mFailed;
+}
+
+// Also measures writing of block files
+void HeadlessBenchmark::TestAppend()
+{
+   const size_t chunkSize = 4096;
+   const auto nChunks = size_t(kSeconds * kRate) / chunkSize;
+
+   Floats chunk{ chunkSize };
+   srand(1);
+   for (size_t i = 0; i < chunkSize; i++)
+      chunk[i] = (rand() / float(RAND_MAX)) * 2.0f - 1.0f;
+
+   Time(wxT("append"), double(nChunks * chunkSize), wxT("samples"), [&]{
+      for (size_t i = 0; i < nChunks; i++)
+         mTrack->Append((samplePtr)chunk.get(), floatSample, chunkSize);
+      mTrack->Flush();
+   });
+}
+
+// Also measures reading of block files
+void HeadlessBenchmark::TestRead()
+{
+   const auto len = mTrack->TimeToLongSamples(mTrack->GetEndTime());
+   Floats buffer{ mTrack->GetMaxBlockSize() };
+
+   Time(wxT("read"), len.as_double(), wxT("samples"), [&]{
+      for (sampleCount pos = 0; pos < len;) {
+         const auto block = limitSampleBufferSize(
+            mTrack->GetBestBlockSize(pos), len - pos);
+         mTrack->Get((samplePtr)buffer.get(), floatSample, pos, block);
+         pos += block;
+      }
+   });
+}
+
+// Random cuts and pastes, as in the interactive benchmark, exercising
+// Sequence::Delete and Sequence::Paste
+void HeadlessBenchmark::TestEdits()
+{
+   const auto len = mTrack->TimeToLongSamples(mTrack->GetEndTime());
+   const auto nChunks = (len / 1000).as_long_long();
+   srand(2);
+
+   Time(wxT("cut_paste"), kEdits, wxT("edits"), [&]{
+      for (int z = 0; z < kEdits; z++) {
+         const auto x0 = rand() % nChunks;
+         const auto xlen = 1 + (rand() % std::min(nChunks - x0, 100LL));
+         auto tmp = mTrack->Cut(x0 * 1000 / kRate, (x0 + xlen) * 1000 / kRate);
+         const auto y0 = rand() % (nChunks - xlen + 1);
+         mTrack->Paste(y0 * 1000 / kRate, tmp.get());
+      }
+   });
+}
+
+void HeadlessBenchmark::TestWaveDisplay()
+{
+   const size_t width = 1920;
+   const auto sequence = mTrack->GetClipByIndex(0)->GetSequence();
+   const auto len = sequence->GetNumSamples();
+
+   Floats min{ width }, max{ width }, rms{ width };
+   ArrayOf<int> bl{ width };
+   ArrayOf<sampleCount> where{ width + 1 };
+
+   for (long samplesPerPixel : { 1L, 64L, 4096L, 65536L }) {
+      const auto span = sampleCount{ samplesPerPixel * long(width) };
+      // Enough screens to cover a fair part of the track at every zoom
+      const int screens = std::max(1, std::min(200,
+         int((len / span).as_long_long())));
+
+      Time(wxString::Format(wxT("wave_display_%ld"), samplesPerPixel),
+         double(screens * width), wxT("pixels"), [&]{
+         for (int ii = 0; ii < screens; ii++) {
+            const auto start = span * ii;
+            for (size_t p = 0; p <= width; p++)
+               where[p] = std::min(len, start + samplesPerPixel * long(p));
+            sequence->GetWaveDisplay(min.get(), max.get(), rms.get(),
+               bl.get(), width, where.get());
+         }
+      });
+   }
+}
+
+void HeadlessBenchmark::TestSpectrogram()
+{
+   const size_t width = 1920;
+   const int screens = 20;
+   const double pixelsPerSecond = 100;
+   const auto clip = mTrack->GetClipByIndex(0);
+   WaveTrackCache cache(mTrack);
+
+   const float *spectrogram;
+   const sampleCount *where;
+   Time(wxT("spectrogram"), double(screens * width), wxT("pixels"), [&]{
+      for (int ii = 0; ii < screens; ii++) {
+         // Defeat the cache so that every screen is computed afresh
+         clip->MarkChanged();
+         clip->GetSpectrogram(cache, spectrogram, where, width,
+            ii * width / pixelsPerSecond, pixelsPerSecond);
+      }
+   });
+}
+
+void HeadlessBenchmark::TestMixer(const wxString &name, double rate)
+{
+   const size_t bufferSize = 4096;
+   const double duration = 60;
+
+   WaveTrackConstArray tracks;
+   for (int ii = 0; ii < kMixerTracks; ii++) {
+      auto track = std::static_pointer_cast<WaveTrack>(mTrack->Duplicate());
+      track->SetRate(rate);
+      track->SetPan(ii % 2 ? -0.5f : 0.5f);
+      tracks.push_back(track);
+   }
+
+   Mixer mixer(tracks, true, Mixer::WarpOptions{ nullptr },
+      0.0, duration, 2, bufferSize, true, kRate, floatSample);
+
+   Time(name, duration * kRate * kMixerTracks, wxT("samples"), [&]{
+      while (mixer.Process(bufferSize) > 0)
+         ;
+   });
+}
+
+// Applies each effect with its factory settings to a minute of the track,
+// through Effect::DoEffect as the menus do, but without a project
+void HeadlessBenchmark::TestEffects()
+{
+   EffectAmplify amplify;
+   if (StartEffect(wxT("effect_amplify"), amplify))
+      TestEffect(wxT("effect_amplify"), amplify);
+
+   EffectNormalize normalize;
+   if (StartEffect(wxT("effect_normalize"), normalize))
+      TestEffect(wxT("effect_normalize"), normalize);
+
+   // The first application takes the noise profile, the second reduces
+   EffectNoiseReduction noiseReduction;
+   if (StartEffect(wxT("effect_noise_reduction"), noiseReduction)) {
+      TestEffect(wxT("effect_noise_profile"), noiseReduction);
+      TestEffect(wxT("effect_noise_reduction"), noiseReduction);
+   }
+
+   EffectEqualization equalization;
+   if (StartEffect(wxT("effect_equalization"), equalization))
+      TestEffect(wxT("effect_equalization"), equalization);
+}
+
+bool HeadlessBenchmark::StartEffect(const wxString &name, Effect &effect)
+{
+   if (!effect.Startup(nullptr)) {
+      wxPrintf(_("Could not start %s.\n"), name);
+      mFailed = true;
+      return false;
+   }
+   // Time the same settings on every run, whatever the user last chose
+   effect.LoadFactoryDefaults();
+   return true;
+}
+
+void HeadlessBenchmark::TestEffect(const wxString &name, Effect &effect)
+{
+   auto tracks = TrackList::Create();
+   auto track = mTrack->Copy(0.0, kEffectSeconds, false);
+   track->SetSelected(true);
+   tracks->Add(track);
+
+   NotifyingSelectedRegion region;
+   region.setTimes(0.0, kEffectSeconds);
+
+   bool success = false;
+   Time(name, kEffectSeconds * kRate, wxT("samples"), [&]{
+      success = effect.DoEffect(nullptr, kRate, tracks.get(), &mFactory,
+         region, false);
+   });
+   if (!success) {
+      mResults.pop_back();
+      wxPrintf(_("Could not apply %s.\n"), name);
+      mFailed = true;
+   }
+}
+
+wxString HeadlessBenchmark::ToJSON() const
+{
+   wxString json;
+   json += wxT("{\n");
+   json += wxString::Format(wxT("  \"version\": \"%s\",\n"),
+      AUDACITY_VERSION_STRING);
+   json += wxT("  \"results\": [\n");
+   for (size_t ii = 0; ii < mResults.size(); ii++) {
+      const auto &result = mResults[ii];
+      const double perSecond = result.ms > 0
+         ? result.count * 1000.0 / result.ms
+         : 0.0;
+      json += wxString::Format(
+         wxT("    { \"name\": \"%s\", \"ms\": %ld, \"units\": \"%s\", \"count\": %.0f, \"per_second\": %.1f }%s\n"),
+         result.name, result.ms,
+         result.units, result.count, perSecond,
+         ii + 1 < mResults.size() ? wxT(",") : wxT(""));
+   }
+   json += wxT("  ]\n");
+   json += wxT("}\n");
+   return json;
+}
+
+}
+
+bool RunHeadlessBenchmark(const wxString &fileName)
+{
+   wxString json;
+   bool success = false;
+   try {
+      HeadlessBenchmark benchmark;
+      success = benchmark.Run();
+      json = benchmark.ToJSON();
+   }
+   catch (const AudacityException &) {
+      wxPrintf(_("Benchmark failed.\n"));
+      return false;
+   }
+
+   wxFFile file(fileName, wxT("w"));
+   if (!file.IsOpened() || !file.Write(json) || !file.Close()) {
+      wxPrintf(_("Could not write benchmark results to %s\n"), fileName);
+      return false;
+   }
+
+   return success;
+}
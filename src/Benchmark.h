@@ -13,4 +13,7 @@
 
 void RunBenchmark(wxWindow *parent);
 
+// Run the benchmark suite without a project, writing JSON results to the file
+bool RunHeadlessBenchmark(const wxString &fileName);
+
 #endif // define __AUDACITY_BENCHMARK__
@@ -0,0 +1,90 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BlockCache.cpp
+
+*******************************************************************//**
+
+\class BlockCache
+\brief Process-wide, bounded, least-recently-used store of the samples of
+block files, decoded to float.
+
+Block files never change their samples once written, so mixers, the
+spectrogram and effects reading the same region of a track can all share
+one read and one conversion.  Entries are keyed by the block file, not by
+track position, so edits of tracks never make them stale.  Blocks whose
+samples are still being computed on demand are read but not kept.
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "BlockCache.h"
+
+#include "BlockFile.h"
+
+namespace {
+// Bound on the decoded samples kept, in bytes
+const size_t MaxBytes = 64 * 1024 * 1024;
+}
+
+BlockCache &BlockCache::Get()
+{
+   static BlockCache instance;
+   return instance;
+}
+
+BlockCache::BlockCache()
+{
+}
+
+auto BlockCache::Read(const BlockFilePtr &pBlock, bool mayThrow) -> Samples
+{
+   if (!pBlock)
+      return {};
+
+   const auto key = pBlock.get();
+   {
+      wxCriticalSectionLocker locker(mCriticalSection);
+      auto found = mIndex.find(key);
+      if (found != mIndex.end()) {
+         const auto iter = found->second;
+         if (iter->block.lock() == pBlock) {
+            mNodes.splice(mNodes.begin(), mNodes, iter);
+            return iter->samples;
+         }
+         Erase(iter);
+      }
+   }
+
+   // Read outside of the lock so that a slow disk does not stall other
+   // threads.  Two threads might race to read the same block; that is
+   // harmless, and only one result is kept.
+   const bool keep = pBlock->IsDataAvailable();
+   const auto len = pBlock->GetLength();
+   auto samples = std::make_shared<Floats>(len);
+   if (pBlock->ReadData(
+         samplePtr(samples->get()), floatSample, 0, len, mayThrow) != len)
+      return {};
+   if (!keep)
+      return samples;
+
+   const size_t bytes = len * sizeof(float);
+   wxCriticalSectionLocker locker(mCriticalSection);
+   auto found = mIndex.find(key);
+   if (found != mIndex.end())
+      return found->second->samples;
+   mNodes.push_front({ key, pBlock, samples, bytes });
+   mIndex[key] = mNodes.begin();
+   mBytes += bytes;
+   while (mBytes > MaxBytes && mNodes.size() > 1)
+      Erase(std::prev(mNodes.end()));
+   return samples;
+}
+
+void BlockCache::Erase(Nodes::iterator iter)
+{
+   mBytes -= iter->bytes;
+   mIndex.erase(iter->key);
+   mNodes.erase(iter);
+}
@@ -0,0 +1,56 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BlockCache.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_BLOCK_CACHE__
+#define __AUDACITY_BLOCK_CACHE__
+
+#include "MemoryX.h"
+#include <list>
+#include <unordered_map>
+#include <wx/thread.h>
+
+class BlockFile;
+using BlockFilePtr = std::shared_ptr<BlockFile>;
+
+///\brief Process-wide, bounded, least-recently-used store of the samples of
+///block files, decoded to float.  Safe to use from any thread.
+class BlockCache
+{
+public:
+   /// All samples of one block file; shared, and never modified once read
+   using Samples = std::shared_ptr<const Floats>;
+
+   static BlockCache &Get();
+
+   /// Returns the samples of the whole block, decoding them only if no
+   /// reader did so recently.  Returns null on failure if !mayThrow.
+   Samples Read(const BlockFilePtr &pBlock, bool mayThrow);
+
+private:
+   BlockCache();
+
+   struct Node
+   {
+      const BlockFile *key;
+      // Detects a dead block whose address was reused
+      std::weak_ptr<BlockFile> block;
+      Samples samples;
+      size_t bytes;
+   };
+   using Nodes = std::list<Node>;
+
+   void Erase(Nodes::iterator iter);
+
+   wxCriticalSection mCriticalSection;
+   // Most recently used first
+   Nodes mNodes;
+   std::unordered_map<const BlockFile*, Nodes::iterator> mIndex;
+   size_t mBytes{ 0 };
+};
+
+#endif
@@ -216,6 +216,7 @@ void BlockFile::CalcSummaryFromBuffer(const float *fbuffer, size_t len,
    float min, max;
    float sumsq;
    double totalSquares = 0.0;
+   double total = 0.0;
    double fraction { 0.0 };
 
    // Recalc 256 summaries
@@ -231,8 +232,10 @@ void BlockFile::CalcSummaryFromBuffer(const float *fbuffer, size_t len,
          jcount = len - i * 256;
          fraction = 1.0 - (jcount / 256.0);
       }
+      total += min;
       for (decltype(jcount) j = 1; j < jcount; j++) {
          float f1 = fbuffer[i * 256 + j];
+         total += f1;
          sumsq += ((float)f1) * ((float)f1);
          if (f1 < min)
             min = f1;
@@ -258,6 +261,7 @@ void BlockFile::CalcSummaryFromBuffer(const float *fbuffer, size_t len,
 
    // Calculate now while we can do it accurately
    mRMS = sqrt(totalSquares/len);
+   SetSum(total);
 
    // Recalc 64K summaries
    sumLen = (len + 65535) / 65536;
@@ -409,6 +413,36 @@ auto BlockFile::GetMinMaxRMS(bool)
    return { mMin, mMax, mRMS };
 }
 
+/// Retrieves the sum of all samples of this block, which gives the DC
+/// offset of long regions without reading their samples.  The sum is
+/// computed with the summary, but blocks loaded from older projects must
+/// be read once.
+double BlockFile::GetSum(bool mayThrow) const
+{
+   if (mSumKnown)
+      return mSum;
+
+   // Samples still being computed on demand may not be the final ones
+   const bool keep = IsDataAvailable();
+   SampleBuffer blockData(mLen, floatSample);
+   this->ReadData(blockData.ptr(), floatSample, 0, mLen, mayThrow);
+
+   const auto data = (const float *)blockData.ptr();
+   double total = 0.0;
+   for (decltype(mLen) i = 0; i < mLen; ++i)
+      total += data[i];
+   if (keep)
+      SetSum(total);
+   return total;
+}
+
+void BlockFile::SetSum(double sum) const
+{
+   mSum = sum;
+   // Publish the sum only after storing it, for readers on other threads
+   mSumKnown = true;
+}
+
 /// Retrieves a portion of the 256-byte summary buffer from this BlockFile.  This
 /// data provides information about the minimum value, the maximum
 /// value, and the maximum RMS value for every group of 256 samples in the
@@ -18,6 +18,7 @@
 
 #include "ondemand/ODTaskThread.h"
 
+#include <atomic>
 #include <functional>
 
 class XMLWriter;
@@ -137,6 +138,11 @@ class PROFILE_DLL_API BlockFile /* not final, abstract */ {
                           bool mayThrow = true) const;
    /// Gets extreme values for the entire block
    virtual MinMaxRMS GetMinMaxRMS(bool mayThrow = true) const;
+   /// Gets the sum of all samples of the block, reading them only if it is
+   /// not yet known
+   double GetSum(bool mayThrow = true) const;
+   /// Returns whether GetSum() needs no reading
+   bool IsSumKnown() const { return mSumKnown; }
    /// Returns the 256 byte summary data block
    virtual bool Read256(float *buffer, size_t start, size_t len);
    /// Returns the 64K summary data block
@@ -220,6 +226,9 @@ class PROFILE_DLL_API BlockFile /* not final, abstract */ {
    // Common, nonvirtual calculation routine for the use of the above
    void CalcSummaryFromBuffer(const float *fbuffer, size_t len,
                               float *summary256, float *summary64K);
+   /// Record the sum of the samples, as computed with their summary or
+   /// saved with the project
+   void SetSum(double sum) const;
 
    /// Read the summary section of the file.  Derived classes implement.
    virtual bool ReadSummary(ArrayOf<char> &data) = 0;
@@ -246,6 +255,12 @@ class PROFILE_DLL_API BlockFile /* not final, abstract */ {
    SummaryInfo mSummaryInfo;
    float mMin, mMax, mRMS;
    mutable bool mSilentLog;
+
+ private:
+   // Not saved in the summary of the file, so unknown for blocks of projects
+   // of older versions until first read
+   mutable std::atomic<double> mSum{ 0.0 };
+   mutable std::atomic<bool> mSumKnown{ false };
 };
 
 /// A BlockFile that refers to data in an existing file
@@ -1670,8 +1670,10 @@ void DirManager::FindMissingAUs(
             fileName.SetName(key);
             fileName.SetExt(wxT("au"));
             const auto path = fileName.GetFullPath();
-            if (!fileName.FileExists() ||
-                wxFile{ path }.Length() == 0)
+            // One query gives both existence and length, rather than
+            // a stat followed by opening every file in the project
+            const auto size = fileName.GetSize();
+            if (size == wxInvalidSize || size == 0)
             {
                missingAUHash[key] = b;
                wxLogWarning(_("Missing data block file: '%s'"), path);
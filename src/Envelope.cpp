@@ -892,6 +892,30 @@ void Envelope::BinarySearchForTime( int &Lo, int &Hi, double t ) const
 /// @param Hi returns first index at or after this time, maybe past the end
 void Envelope::BinarySearchForTime_LeftLimit( int &Lo, int &Hi, double t ) const
 {
+   // The same optimizations as in BinarySearchForTime
+   {
+      if (mSearchGuess >= 0 && mSearchGuess < (int)mEnv.size()) {
+         if (t > mEnv[mSearchGuess].GetT() &&
+             (1 + mSearchGuess == (int)mEnv.size() ||
+              t <= mEnv[1 + mSearchGuess].GetT())) {
+            Lo = mSearchGuess;
+            Hi = 1 + mSearchGuess;
+            return;
+         }
+      }
+
+      ++mSearchGuess;
+      if (mSearchGuess >= 0 && mSearchGuess < (int)mEnv.size()) {
+         if (t > mEnv[mSearchGuess].GetT() &&
+             (1 + mSearchGuess == (int)mEnv.size() ||
+              t <= mEnv[1 + mSearchGuess].GetT())) {
+            Lo = mSearchGuess;
+            Hi = 1 + mSearchGuess;
+            return;
+         }
+      }
+   }
+
    Lo = -1;
    Hi = mEnv.size();
 
@@ -941,34 +965,40 @@ void Envelope::GetValuesRelative
    const auto epsilon = tstep / 2;
    int len = mEnv.size();
 
+   // Get easiest cases out the way first...
+   // IF empty envelope THEN default value
+   if (len <= 0) {
+      std::fill(buffer, buffer + std::max(0, bufferLen), mDefaultValue);
+      return;
+   }
+   // IF one point THEN it is the value before and after it
+   if (len == 1) {
+      std::fill(buffer, buffer + std::max(0, bufferLen), mEnv[0].GetVal());
+      return;
+   }
+
+   const double tFirst = mEnv[0].GetT();
+   const double tLast = mEnv[len - 1].GetT();
+
    double t = t0;
    double increment = 0;
-   if ( len > 1 && t <= mEnv[0].GetT() && mEnv[0].GetT() == mEnv[1].GetT() )
+   if ( t <= tFirst && tFirst == mEnv[1].GetT() )
       increment = leftLimit ? -epsilon : epsilon;
 
    double tprev, vprev, tnext = 0, vnext, vstep = 0;
 
    for (int b = 0; b < bufferLen; b++) {
 
-      // Get easiest cases out the way first...
-      // IF empty envelope THEN default value
-      if (len <= 0) {
-         buffer[b] = mDefaultValue;
-         t += tstep;
-         continue;
-      }
-
       auto tplus = t + increment;
 
       // IF before envelope THEN first value
-      if ( leftLimit ? tplus <= mEnv[0].GetT() : tplus < mEnv[0].GetT() ) {
+      if ( leftLimit ? tplus <= tFirst : tplus < tFirst ) {
          buffer[b] = mEnv[0].GetVal();
          t += tstep;
          continue;
       }
       // IF after envelope THEN last value
-      if ( leftLimit
-            ? tplus > mEnv[len - 1].GetT() : tplus >= mEnv[len - 1].GetT() ) {
+      if ( leftLimit ? tplus > tLast : tplus >= tLast ) {
          buffer[b] = mEnv[len - 1].GetVal();
          t += tstep;
          continue;
@@ -1035,15 +1065,47 @@ void Envelope::GetValuesRelative
          }
 
          buffer[b] = v;
+         t += tstep;
+
+         // Stay in this interval for as many samples as it covers, stepping
+         // the value by recurrence, without the full tests above; since
+         // the interval ends no later than the last point, only the
+         // first point needs checking, and only while time moves forward
+         if (tstep <= 0)
+            continue;
+
+         int bb = b + 1;
+         if (mDB) {
+            for (; bb < bufferLen; bb++) {
+               tplus = t + increment;
+               if ( leftLimit
+                     ? ( tplus > tnext || tplus <= tFirst )
+                     : ( tplus >= tnext || tplus < tFirst ) )
+                  break;
+               buffer[bb] = buffer[bb - 1] * vstep;
+               t += tstep;
+            }
+         }
+         else {
+            for (; bb < bufferLen; bb++) {
+               tplus = t + increment;
+               if ( leftLimit
+                     ? ( tplus > tnext || tplus <= tFirst )
+                     : ( tplus >= tnext || tplus < tFirst ) )
+                  break;
+               buffer[bb] = buffer[bb - 1] + vstep;
+               t += tstep;
+            }
+         }
+         b = bb - 1;
       } else {
          if (mDB){
             buffer[b] = buffer[b - 1] * vstep;
          }else{
             buffer[b] = buffer[b - 1] + vstep;
          }
+         t += tstep;
       }
-
-      t += tstep;
    }
 }
 
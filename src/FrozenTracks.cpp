@@ -0,0 +1,177 @@
+/**********************************************************************
+
+Audacity: A Digital Audio Editor
+
+FrozenTracks.cpp
+
+*******************************************************************//**
+
+\class FrozenTracks
+\brief Caches renderings of wave tracks for playback.
+
+*//*******************************************************************/
+
+#include "FrozenTracks.h"
+
+#include "Envelope.h"
+#include "Mix.h"
+#include "Project.h"
+#include "Sequence.h"
+#include "UndoManager.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+
+#include <algorithm>
+
+static AudacityProject::AttachedObjects::RegisteredFactory sFrozenTracksKey {
+   []( AudacityProject &project ) {
+      return std::make_shared< FrozenTracks >( project );
+   }
+};
+
+FrozenTracks &FrozenTracks::Get( AudacityProject &project )
+{
+   return project.AttachedObjects::Get< FrozenTracks >( sFrozenTracksKey );
+}
+
+const FrozenTracks &FrozenTracks::Get( const AudacityProject &project )
+{
+   return Get( const_cast< AudacityProject & >( project ) );
+}
+
+// Everything in a channel that the rendering depends on.  Block files are
+// never modified, only replaced, so holding them detects any change of the
+// samples, and keeps the comparison safe from reuse of addresses.
+struct FrozenTracks::Signature
+{
+   explicit Signature( const WaveTrack &track )
+   {
+      for (const auto clip : track.SortedClipArray()) {
+         numbers.push_back( clip->GetOffset() );
+         numbers.push_back( clip->GetRate() );
+         numbers.push_back( clip->GetNumSamples().as_double() );
+
+         const auto envelope = clip->GetEnvelope();
+         numbers.push_back( envelope->GetOffset() );
+         numbers.push_back( envelope->GetTrackLen() );
+         numbers.push_back( envelope->GetExponential() );
+         const auto nPoints = envelope->GetNumberOfPoints();
+         numbers.push_back( nPoints );
+         for (size_t ii = 0; ii < nPoints; ++ii) {
+            const auto &point = (*envelope)[ii];
+            numbers.push_back( point.GetT() );
+            numbers.push_back( point.GetVal() );
+         }
+
+         for (const auto &block : clip->GetSequence()->GetBlockArray()) {
+            blocks.push_back( block.f );
+            numbers.push_back( block.start.as_double() );
+         }
+      }
+   }
+
+   bool operator == ( const Signature &other ) const
+   {
+      return numbers == other.numbers && blocks == other.blocks;
+   }
+
+   std::vector< double > numbers;
+   std::vector< BlockFilePtr > blocks;
+};
+
+struct FrozenTracks::Entry
+{
+   Signature signature;
+   std::shared_ptr< const WaveTrack > rendering;
+};
+
+FrozenTracks::FrozenTracks( AudacityProject &project )
+   : mProject{ project }
+{
+   mProject.Bind( EVT_UNDO_PUSHED, &FrozenTracks::OnUndoChange, this );
+   mProject.Bind( EVT_UNDO_MODIFIED, &FrozenTracks::OnUndoChange, this );
+   mProject.Bind( EVT_UNDO_OR_REDO, &FrozenTracks::OnUndoChange, this );
+   mProject.Bind( EVT_UNDO_RESET, &FrozenTracks::OnUndoChange, this );
+}
+
+FrozenTracks::~FrozenTracks()
+{
+   mProject.Unbind( EVT_UNDO_PUSHED, &FrozenTracks::OnUndoChange, this );
+   mProject.Unbind( EVT_UNDO_MODIFIED, &FrozenTracks::OnUndoChange, this );
+   mProject.Unbind( EVT_UNDO_OR_REDO, &FrozenTracks::OnUndoChange, this );
+   mProject.Unbind( EVT_UNDO_RESET, &FrozenTracks::OnUndoChange, this );
+}
+
+bool FrozenTracks::Freeze( const WaveTrack &track, double rate,
+   const ProgressFunction &progress )
+{
+   Unfreeze( track );
+
+   const auto t0 = track.GetStartTime();
+   const auto t1 = track.GetEndTime();
+
+   auto &trackFactory = TrackFactory::Get( mProject );
+   auto rendering = trackFactory.NewWaveTrack( floatSample, rate );
+   rendering->SetOffset( t0 );
+
+   if (t1 > t0) {
+      const auto maxBlockLen = rendering->GetIdealBlockSize();
+      Mixer mixer( { track.SharedPointer< const WaveTrack >() },
+         // Throw to abort freezing if read fails:
+         true,
+         // No time warp, which playback applies to the rendering as to the
+         // track
+         Mixer::WarpOptions{ nullptr },
+         t0, t1, 1, maxBlockLen, false,
+         rate, floatSample );
+      // Gains are applied at playback
+      mixer.ApplyTrackGains( false );
+
+      while (auto blockLen = mixer.Process( maxBlockLen )) {
+         rendering->Append( mixer.GetBuffer(), floatSample, blockLen );
+         if (!progress( (mixer.MixGetCurrentTime() - t0) / (t1 - t0) ))
+            return false;
+      }
+   }
+   rendering->Flush();
+
+   mEntries.emplace( track.GetId(),
+      Entry{ Signature{ track }, std::move( rendering ) } );
+   return true;
+}
+
+void FrozenTracks::Unfreeze( const WaveTrack &track )
+{
+   mEntries.erase( track.GetId() );
+}
+
+std::shared_ptr< const WaveTrack > FrozenTracks::Find(
+   const WaveTrack &track, double rate ) const
+{
+   auto iter = mEntries.find( track.GetId() );
+   if (iter == mEntries.end() ||
+       iter->second.rendering->GetRate() != rate ||
+       !(iter->second.signature == Signature{ track }))
+      return {};
+   return iter->second.rendering;
+}
+
+void FrozenTracks::OnUndoChange( wxCommandEvent &evt )
+{
+   evt.Skip();
+   DropStale();
+}
+
+void FrozenTracks::DropStale()
+{
+   // Free the block files of renderings that can no longer be used
+   auto &tracks = TrackList::Get( mProject );
+   for (auto iter = mEntries.begin(); iter != mEntries.end();) {
+      auto pTrack = dynamic_cast< const WaveTrack * >(
+         tracks.FindById( iter->first ) );
+      if (pTrack && iter->second.signature == Signature{ *pTrack })
+         ++iter;
+      else
+         iter = mEntries.erase( iter );
+   }
+}
@@ -0,0 +1,67 @@
+/**********************************************************************
+
+Audacity: A Digital Audio Editor
+
+FrozenTracks.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_FROZEN_TRACKS__
+#define __AUDACITY_FROZEN_TRACKS__
+
+#include "ClientData.h"
+#include "Track.h"
+
+#include <functional>
+#include <map>
+#include <wx/event.h>
+
+class AudacityProject;
+class WaveTrack;
+
+///\brief Caches renderings of wave tracks, with envelopes and rate
+///conversion applied, so that playback reads them instead of mixing the
+///tracks again.
+/// Each channel is rendered by itself into a float track whose blocks
+/// DirManager owns.  Gain and pan are left out, because playback applies
+/// them live.  A rendering is used only while the track is unchanged since
+/// it was made; changes to the project drop the renderings gone stale.
+class FrozenTracks final
+   : public ClientData::Base
+{
+public:
+   static FrozenTracks &Get( AudacityProject &project );
+   static const FrozenTracks &Get( const AudacityProject &project );
+
+   explicit FrozenTracks( AudacityProject &project );
+   FrozenTracks( const FrozenTracks & ) PROHIBITED;
+   FrozenTracks &operator=( const FrozenTracks & ) PROHIBITED;
+   ~FrozenTracks() override;
+
+   /// Receives the fraction done; returns false to cancel
+   using ProgressFunction = std::function< bool( double ) >;
+
+   /// Render one channel at the given rate, replacing any older rendering.
+   /// Returns false, keeping nothing, if cancelled.  May throw for disk
+   /// errors.
+   bool Freeze( const WaveTrack &track, double rate,
+      const ProgressFunction &progress );
+   void Unfreeze( const WaveTrack &track );
+
+   /// The rendering of the channel at the rate, or null if there is none
+   /// or the track has changed since
+   std::shared_ptr< const WaveTrack > Find(
+      const WaveTrack &track, double rate ) const;
+
+private:
+   void OnUndoChange( wxCommandEvent &evt );
+   void DropStale();
+
+   struct Signature;
+   struct Entry;
+
+   AudacityProject &mProject;
+   std::map< TrackId, Entry > mEntries;
+};
+
+#endif
@@ -10,12 +10,22 @@
 
 #include "InterpolateAudio.h"
 
+#include <algorithm>
 #include <math.h>
 #include <stdlib.h>
 
 #include <wx/defs.h>
 
-#include "Matrix.h"
+#include "SampleFormat.h"
+
+// Bounds on the order of the autoregression.  Short gaps do well with
+// a low order, but long gaps need the higher orders to keep pitched
+// sounds going rather than let them decay into silence.
+static const int MinMaxOrder = 50;
+static const int MaxOrder = 256;
+
+// Rows of the normal equations handled between progress reports
+static const size_t ProgressInterval = 256;
 
 static inline int imin(int x, int y)
 {
@@ -77,10 +87,148 @@ static void LinearInterpolateAudio(float *buffer, int len,
    }
 }
 
+// Finds the prediction error filter c of order P, with c[P] equal to 1,
+// that best makes the sum of c[k] * s[i + k], for k from 0 to P, vanish.
+// Uses the autocorrelation of each run of good samples, and solves the
+// Toeplitz system for it with the Levinson-Durbin recursion, which takes
+// time proportional to len * P rather than to P cubed.
+static bool FindAutoregression(const float *buffer, size_t len,
+                               size_t firstBad, size_t numBad,
+                               size_t P, double *c)
+{
+   Doubles r{ P + 1, true };
+   const auto accumulate = [&](size_t start, size_t end) {
+      for(size_t lag=0; lag<=P; lag++)
+         for(size_t i=start; i+lag<end; i++)
+            r[lag] += (double)buffer[i] * buffer[i+lag];
+   };
+   accumulate(0, firstBad);
+   accumulate(firstBad + numBad, len);
+
+   // Pretend there is a tiny amount of white noise in the signal, about
+   // 1 bit in 16-bit audio.  This is an extremely effective way to avoid
+   // nearly-singular systems, even when the audio is digital silence.
+   r[0] += (len - numBad) * 1e-9;
+
+   // phi[j] is the weight of s[i - j] in the prediction of s[i]
+   Doubles phi{ P + 1, true };
+   Doubles prev{ P + 1, true };
+   double error = r[0];
+   for(size_t m=1; m<=P; m++) {
+      double acc = r[m];
+      for(size_t j=1; j<m; j++)
+         acc -= phi[j] * r[m-j];
+      const double k = acc / error;
+      if (!(fabs(k) < 1.0))
+         return false;
+      for(size_t j=1; j<m; j++)
+         prev[j] = phi[j];
+      for(size_t j=1; j<m; j++)
+         phi[j] = prev[j] - k * prev[m-j];
+      phi[m] = k;
+      error *= 1.0 - k * k;
+   }
+
+   for(size_t j=1; j<=P; j++)
+      c[P-j] = -phi[j];
+   c[P] = 1.0;
+   return true;
+}
+
+// Finds the values of the bad samples that minimize the sum of the
+// squared prediction errors c[0] * s[i] + ... + c[P] * s[i + P] that
+// involve them.  The normal equations for this are banded, with P
+// diagonals on either side, so a banded Cholesky factorization solves
+// them in time proportional to numBad * P * P, and space proportional
+// to numBad * P.  Sets cancelled, leaving the buffer alone, if progress
+// returns false.
+static bool SolveBadSamples(float *buffer, size_t len,
+                            size_t firstBad, size_t numBad,
+                            size_t P, const double *c,
+                            const InterpolateProgress &progress,
+                            bool &cancelled)
+{
+   // Building the equations and factoring them take about as long, so
+   // each reports half of the progress
+   const auto report = [&](size_t done, size_t total, double start) {
+      if (!progress || done % ProgressInterval != 0)
+         return true;
+      cancelled = !progress(start + 0.5 * done / total);
+      return !cancelled;
+   };
+
+   const size_t endBad = firstBad + numBad;
+   const size_t width = P + 1;
+   // band[j * width + d] holds the element at row j and column j - d
+   // of the lower triangle
+   Doubles band{ numBad * width, true };
+   Doubles x{ numBad, true };
+
+   const size_t firstRow = firstBad > P ? firstBad - P : 0;
+   const size_t endRow = std::min(endBad, len - P);
+   for(size_t row=firstRow; row<endRow; row++) {
+      if (!report(row - firstRow, endRow - firstRow, 0.0))
+         return false;
+
+      // The part of the prediction error that the good samples make
+      double known = 0;
+      for(size_t k=0; k<=P; k++)
+         if (row+k < firstBad || row+k >= endBad)
+            known += c[k] * buffer[row+k];
+
+      const size_t kFirst = std::max(row, firstBad) - row;
+      const size_t kEnd = std::min(row + width, endBad) - row;
+      for(size_t k1=kFirst; k1<kEnd; k1++) {
+         const size_t j = row + k1 - firstBad;
+         x[j] -= c[k1] * known;
+         for(size_t k2=kFirst; k2<=k1; k2++)
+            band[j * width + (k1 - k2)] += c[k1] * c[k2];
+      }
+   }
+
+   // Factor in place into L times its transpose
+   for(size_t j=0; j<numBad; j++) {
+      if (!report(j, numBad, 0.5))
+         return false;
+
+      const size_t first = j > P ? j - P : 0;
+      for(size_t i=first; i<=j; i++) {
+         double sum = band[j * width + (j - i)];
+         for(size_t k=first; k<i; k++)
+            sum -= band[j * width + (j - k)] * band[i * width + (i - k)];
+         if (i < j)
+            band[j * width + (j - i)] = sum / band[i * width];
+         else if (sum > 0)
+            band[j * width] = sqrt(sum);
+         else
+            return false;
+      }
+   }
+
+   // Substitute forward through L, then back through its transpose
+   for(size_t j=0; j<numBad; j++) {
+      const size_t first = j > P ? j - P : 0;
+      for(size_t k=first; k<j; k++)
+         x[j] -= band[j * width + (j - k)] * x[k];
+      x[j] /= band[j * width];
+   }
+   for(size_t j=numBad; j-- > 0;) {
+      const size_t last = std::min(j + P, numBad - 1);
+      for(size_t i=j+1; i<=last; i++)
+         x[j] -= band[i * width + (i - j)] * x[i];
+      x[j] /= band[j * width];
+   }
+
+   for(size_t i=0; i<numBad; i++)
+      buffer[firstBad+i] = (float)x[i];
+   return true;
+}
+
 // Here's the main interpolate function, using
 // Least Squares AutoRegression (LSAR):
-void InterpolateAudio(float *buffer, const size_t len,
-                      size_t firstBad, size_t numBad)
+bool InterpolateAudio(float *buffer, const size_t len,
+                      size_t firstBad, size_t numBad,
+                      const InterpolateProgress &progress)
 {
    const auto N = len;
 
@@ -90,7 +238,7 @@ void InterpolateAudio(float *buffer, const size_t len,
             firstBad+numBad <= len);
 
    if(numBad >= len)
-      return;  //should never have been called!
+      return true;  //should never have been called!
 
    if (firstBad == 0) {
       // The algorithm below has a weird asymmetry in that it
@@ -100,105 +248,38 @@ void InterpolateAudio(float *buffer, const size_t len,
       Floats buffer2{ len };
       for(size_t i=0; i<len; i++)
          buffer2[len-1-i] = buffer[i];
-      InterpolateAudio(buffer2.get(), len, len-numBad, numBad);
+      if (!InterpolateAudio(buffer2.get(), len, len-numBad, numBad, progress))
+         return false;
       for(size_t i=0; i<len; i++)
          buffer[len-1-i] = buffer2[i];
-      return;
+      return true;
    }
 
-   Vector s(len, buffer);
-
    // Choose P, the order of the autoregression equation
+   const int maxOrder = imin(imax(numBad / 4, MinMaxOrder), MaxOrder);
    const int IP =
-      imin(imin(numBad * 3, 50), imax(firstBad - 1, len - (firstBad + numBad) - 1));
+      imin(imin(numBad * 3, maxOrder),
+           imax(firstBad - 1, len - (firstBad + numBad) - 1));
 
    if (IP < 3 || IP >= (int)N) {
       LinearInterpolateAudio(buffer, len, firstBad, numBad);
-      return;
+      return true;
    }
 
    size_t P(IP);
 
-   // Add a tiny amount of random noise to the input signal -
-   // this sounds like a bad idea, but the amount we're adding
-   // is only about 1 bit in 16-bit audio, and it's an extremely
-   // effective way to avoid nearly-singular matrices.  If users
-   // run it more than once they get slightly different results;
-   // this is sometimes even advantageous.
-   for(size_t i=0; i<N; i++)
-      s[i] += (rand()-(RAND_MAX/2))/(RAND_MAX*10000.0);
-
-   // Solve for the best autoregression coefficients
-   // using a least-squares fit to all of the non-bad
-   // data we have in the buffer
-   Matrix X(P, P);
-   Vector b(P);
-
-   for(size_t i = 0; i + P < len; i++)
-      if (i+P < firstBad || i >= (firstBad + numBad))
-         for(size_t row=0; row<P; row++) {
-            for(size_t col=0; col<P; col++)
-               X[row][col] += (s[i+row] * s[i+col]);
-            b[row] += s[i+P] * s[i+row];
-         }
-
-   Matrix Xinv(P, P);
-   if (!InvertMatrix(X, Xinv)) {
-      // The matrix is singular!  Fall back on linear...
-      // In practice I have never seen this happen if
-      // we add the tiny bit of random noise.
-      LinearInterpolateAudio(buffer, len, firstBad, numBad);
-      return;
-   }
-
-   // This vector now contains the autoregression coefficients
-   const Vector &a = Xinv * b;
-
-   // Create a matrix (a "Toeplitz" matrix, as it turns out)
-   // which encodes the autoregressive relationship between
-   // elements of the sequence.
-   Matrix A(N-P, N);
-   for(size_t row=0; row<N-P; row++) {
-      for(size_t col=0; col<P; col++)
-         A[row][row+col] = -a[col];
-      A[row][row+P] = 1;
-   }
-
-   // Split both the Toeplitz matrix and the signal into
-   // two pieces.  Note that this code could be made to
-   // work even in the case where the "bad" samples are
-   // not contiguous, but currently it assumes they are.
-   //   "u" is for unknown (bad)
-   //   "k" is for known (good)
-   Matrix Au = MatrixSubset(A, 0, N-P, firstBad, numBad);
-   Matrix A_left = MatrixSubset(A, 0, N-P, 0, firstBad);
-   Matrix A_right = MatrixSubset(A, 0, N-P,
-                                 firstBad+numBad, N-(firstBad+numBad));
-   Matrix Ak = MatrixConcatenateCols(A_left, A_right);
-
-   const Vector &s_left = VectorSubset(s, 0, firstBad);
-   const Vector &s_right = VectorSubset(s, firstBad+numBad,
-                                 N-(firstBad+numBad));
-   const Vector &sk = VectorConcatenate(s_left, s_right);
-
-   // Do some linear algebra to find the best possible
-   // values that fill in the "bad" area
-   Matrix AuT = TransposeMatrix(Au);
-   Matrix X1 = MatrixMultiply(AuT, Au);
-   Matrix X2(X1.Rows(), X1.Cols());
-   if (!InvertMatrix(X1, X2)) {
-      // The matrix is singular!  Fall back on linear...
+   // Solve for the best autoregression coefficients,
+   // then for the values that fill in the "bad" area
+   // most consistently with them.  Either can fail only
+   // in nearly singular cases; then fall back on linear.
+   Doubles c{ P + 1 };
+   bool cancelled = false;
+   if (!FindAutoregression(buffer, len, firstBad, numBad, P, c.get()) ||
+       !SolveBadSamples(buffer, len, firstBad, numBad, P, c.get(),
+                        progress, cancelled)) {
+      if (cancelled)
+         return false;
       LinearInterpolateAudio(buffer, len, firstBad, numBad);
-      return;
    }
-   Matrix X2b = X2 * -1.0;
-   Matrix X3 = MatrixMultiply(X2b, AuT);
-   Matrix X4 = MatrixMultiply(X3, Ak);
-   // This vector contains our best guess as to the
-   // unknown values
-   const Vector &su = X4 * sk;
-
-   // Put the results into the return buffer
-   for(size_t i=0; i<numBad; i++)
-      buffer[firstBad+i] = (float)su[i];
+   return true;
 }
@@ -11,7 +11,7 @@
 \file Matrix.h
 \brief General routine to interpolate (or even extrapolate small amounts)
  audio when a few of the samples are bad.  Works great for a few
- dozen bad samples, but not so well with hundreds.  Uses the
+ dozen bad samples, and less well as the gap grows.  Uses the
  least-squares autoregression (LSAR) algorithm, as described in:
 
  Simon Godsill, Peter Rayner, and Olivier Cappe.  Digital Audio Restoration.
@@ -27,6 +27,10 @@
 
 #include "Audacity.h"
 #include <cstddef>
+#include <functional>
+
+/// Receives the fraction done; returns false to cancel
+using InterpolateProgress = std::function< bool( double ) >;
 
 // See top of file for a description of the algorithm.  Interpolates
 // the samples from buffer[firstBad] through buffer[firstBad+numBad-1],
@@ -35,8 +39,11 @@
 // samples are in the middle, with several times as much data on either
 // side (6x the number of bad samples on either side is great).  However,
 // it will work with less data, and with the bad samples on one end or
-// the other.
-void AUDACITY_DLL_API InterpolateAudio(float *buffer, size_t len,
-                                       size_t firstBad, size_t numBad);
+// the other.  Time grows in proportion to numBad, and with the order
+// of the autoregression, which grows with numBad up to 256.  Returns
+// false, leaving the buffer unchanged, if progress cancels.
+bool AUDACITY_DLL_API InterpolateAudio(float *buffer, size_t len,
+                                       size_t firstBad, size_t numBad,
+                                       const InterpolateProgress &progress = {});
 
 #endif // __AUDACITY_INTERPOLATE_AUDIO__
@@ -357,32 +357,103 @@ void MixBuffers(unsigned numChannels, int *channelFlags, float *gains,
                 samplePtr src, SampleBuffer *dests,
                 int len, bool interleaved)
 {
+   const float *temp = (const float *)src;
+
+   if (!interleaved) {
+      // Contiguous source and destination, which the compiler can vectorize
+      for (unsigned int c = 0; c < numChannels; c++) {
+         if (!channelFlags[c])
+            continue;
+
+         const float gain = gains[c];
+         float *dest = (float *)dests[c].ptr();
+         for (int j = 0; j < len; j++)
+            dest[j] += temp[j] * gain;   // the actual mixing process
+      }
+      return;
+   }
+
+   float *dest = (float *)dests[0].ptr();
+
+   // The usual case of a mono track, or a stereo pair, into stereo:
+   // read each source sample once and mix it into the whole frame
+   if (numChannels == 2 && channelFlags[0] && channelFlags[1]) {
+      const float gain0 = gains[0], gain1 = gains[1];
+      for (int j = 0; j < len; j++) {
+         const float sample = temp[j];
+         dest[2 * j] += sample * gain0;
+         dest[2 * j + 1] += sample * gain1;
+      }
+      return;
+   }
+
    for (unsigned int c = 0; c < numChannels; c++) {
       if (!channelFlags[c])
          continue;
 
-      samplePtr destPtr;
-      unsigned skip;
+      const float gain = gains[c];
+      float *destC = dest + c;
+      for (int j = 0; j < len; j++)
+         destC[j * numChannels] += temp[j] * gain;
+   }
+}
+
+namespace {
+   /// Copy samples fetched from a track into a mixing buffer, applying the
+   /// envelope in the same pass, and reversing them if playing backwards.
+   /// src may be null, for a region that could not be read.
+   void ApplyEnvelope(float *dest, constSamplePtr src, const double *env,
+                      size_t len, bool backwards)
+   {
+      if (!src) {
+         memset(dest, 0, sizeof(float) * len);
+         return;
+      }
 
-      if (interleaved) {
-         destPtr = dests[0].ptr() + c*SAMPLE_SIZE(floatSample);
-         skip = numChannels;
-      } else {
-         destPtr = dests[c].ptr();
-         skip = 1;
+      const float *samples = (const float *)src;
+      if (backwards) {
+         float *end = dest + len - 1;
+         for (size_t i = 0; i < len; i++)
+            end[-(ptrdiff_t)i] = samples[i] * env[i];
+      }
+      else {
+         for (size_t i = 0; i < len; i++)
+            dest[i] = samples[i] * env[i];
       }
+   }
 
-      float gain = gains[c];
-      float *dest = (float *)destPtr;
-      float *temp = (float *)src;
-      for (int j = 0; j < len; j++) {
-         *dest += temp[j] * gain;   // the actual mixing process
-         dest += skip;
+   /// Mix samples fetched from a track straight into the output buffers,
+   /// applying the envelope, channel gains and routing in one pass, and
+   /// reversing them if playing backwards.  Each sample is read and
+   /// enveloped once, then added to every channel it is routed to.
+   /// src may be null, for a region that could not be read, which adds
+   /// nothing.
+   void MixEnvelopedSamples(unsigned numChannels, const int *channelFlags,
+                            const float *gains, constSamplePtr src,
+                            const double *env, SampleBuffer *dests,
+                            size_t len, bool interleaved, bool backwards)
+   {
+      if (!src)
+         return;
+
+      const float *samples = (const float *)src;
+      float *const interleavedDest = (float *)dests[0].ptr();
+      const size_t stride = interleaved ? numChannels : 1;
+      for (size_t i = 0; i < len; i++) {
+         const float sample = samples[i] * env[i];
+         const size_t j = (backwards ? len - 1 - i : i) * stride;
+         for (unsigned int c = 0; c < numChannels; c++) {
+            if (!channelFlags[c])
+               continue;
+
+            float *dest = interleaved
+               ? interleavedDest + c
+               : (float *)dests[c].ptr();
+            dest[j] += sample * gains[c];
+         }
       }
    }
-}
 
-namespace {
    //Note: The meaning of this function has changed (December 2012)
    //Previously this function did something that was close to the opposite (but not entirely accurate).
    /** @brief Compute the integral warp factor between two non-warped time points
@@ -453,38 +524,23 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
          if (getLen > 0) {
             if (backwards) {
                auto results = cache.Get(floatSample, *pos - (getLen - 1), getLen, mMayThrow);
-               if (results)
-                  memcpy(&queue[*queueLen], results, sizeof(float) * getLen);
-               else
-                  memset(&queue[*queueLen], 0, sizeof(float) * getLen);
-
                track->GetEnvelopeValues(mEnvValues.get(),
                                         getLen,
                                         (*pos - (getLen- 1)).as_double() / trackRate);
+               ApplyEnvelope(&queue[*queueLen], results, mEnvValues.get(),
+                             getLen, true);
                *pos -= getLen;
             }
             else {
                auto results = cache.Get(floatSample, *pos, getLen, mMayThrow);
-               if (results)
-                  memcpy(&queue[*queueLen], results, sizeof(float) * getLen);
-               else
-                  memset(&queue[*queueLen], 0, sizeof(float) * getLen);
-
                track->GetEnvelopeValues(mEnvValues.get(),
                                         getLen,
                                         (*pos).as_double() / trackRate);
-
+               ApplyEnvelope(&queue[*queueLen], results, mEnvValues.get(),
+                             getLen, false);
                *pos += getLen;
             }
 
-            for (decltype(getLen) i = 0; i < getLen; i++) {
-               queue[(*queueLen) + i] *= mEnvValues[i];
-            }
-
-            if (backwards)
-               ReverseSamples((samplePtr)&queue[0], floatSample,
-                              *queueLen, getLen);
-
             *queueLen += getLen;
          }
       }
@@ -573,41 +629,31 @@ size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
       sampleCount{ (backwards ? t - tEnd : tEnd - t) * track->GetRate() + 0.5 }
    );
 
+   for(size_t c=0; c<mNumChannels; c++)
+      if (mApplyTrackGains)
+         mGains[c] = track->GetChannelGain(c);
+      else
+         mGains[c] = 1.0;
+
+   // With no resampling in between, the envelope, gains and routing are
+   // all applied while copying out of the cache
    if (backwards) {
       auto results = cache.Get(floatSample, *pos - (slen - 1), slen, mMayThrow);
-      if (results)
-         memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
-      else
-         memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
       track->GetEnvelopeValues(mEnvValues.get(), slen, t - (slen - 1) / mRate);
-      for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
-      ReverseSamples((samplePtr)mFloatBuffer.get(), floatSample, 0, slen);
-
+      MixEnvelopedSamples(mNumChannels, channelFlags, mGains.get(), results,
+                          mEnvValues.get(), mTemp.get(), slen, mInterleaved,
+                          true);
       *pos -= slen;
    }
    else {
       auto results = cache.Get(floatSample, *pos, slen, mMayThrow);
-      if (results)
-         memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
-      else
-         memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
       track->GetEnvelopeValues(mEnvValues.get(), slen, t);
-      for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
-
+      MixEnvelopedSamples(mNumChannels, channelFlags, mGains.get(), results,
+                          mEnvValues.get(), mTemp.get(), slen, mInterleaved,
+                          false);
       *pos += slen;
    }
 
-   for(size_t c=0; c<mNumChannels; c++)
-      if (mApplyTrackGains)
-         mGains[c] = track->GetChannelGain(c);
-      else
-         mGains[c] = 1.0;
-
-   MixBuffers(mNumChannels, channelFlags, mGains.get(),
-              (samplePtr)mFloatBuffer.get(), mTemp.get(), slen, mInterleaved);
-
    return slen;
 }
 
@@ -605,11 +605,12 @@ bool ModuleManager::IsPluginValid(const PluginID & providerID,
                                   const PluginPath & path,
                                   bool bFast)
 {
-   if (mDynModules.find(providerID) == mDynModules.end())
+   auto iter = mDynModules.find(providerID);
+   if (iter == mDynModules.end())
    {
       return false;
    }
 
-   return mDynModules[providerID]->IsPluginValid(path, bFast);
+   return iter->second->IsPluginValid(path, bFast);
 }
 
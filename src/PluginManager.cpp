@@ -35,6 +35,7 @@ for shared and private configs - which need to move out.
 #include <wx/log.h>
 #include <wx/radiobut.h>
 #include <wx/string.h>
+#include <wx/sstream.h>
 #include <wx/tokenzr.h>
 #include <wx/wfstream.h>
 #include <wx/utils.h>
@@ -51,6 +52,7 @@ for shared and private configs - which need to move out.
 #include "widgets/ProgressDialog.h"
 
 #include <unordered_map>
+#include <unordered_set>
 
 // ============================================================================
 //
@@ -2232,11 +2234,10 @@ void PluginManager::LoadGroup(wxFileConfig *pRegistry, PluginType type)
 
 void PluginManager::Save()
 {
-   // Create/Open the registry
-   wxFileConfig registry(wxEmptyString, wxEmptyString, FileNames::PluginRegistry());
-
-   // Clear it out
-   registry.DeleteAll();
+   // Build the registry in memory rather than opening the existing file,
+   // which would parse every old entry only to delete it again
+   wxStringInputStream empty{ wxString{} };
+   wxFileConfig registry(empty);
 
    // Write the version string
    registry.Write(REGVERKEY, REGVERCUR);
@@ -2255,8 +2256,12 @@ void PluginManager::Save()
    // And now the providers
    SaveGroup(&registry, PluginTypeModule);
 
-   // Just to be safe
-   registry.Flush();
+   // Write it out in one go, replacing the old file only on success
+   wxTempFileOutputStream out(FileNames::PluginRegistry());
+   if (registry.Save(out))
+      out.Commit();
+   else
+      out.Discard();
 }
 
 void PluginManager::SaveGroup(wxFileConfig *pRegistry, PluginType type)
@@ -2350,7 +2355,9 @@ void PluginManager::CheckForUpdates(bool bFast)
    // Get ModuleManager reference
    ModuleManager & mm = ModuleManager::Get();
 
-   wxArrayString pathIndex;
+   // Hashed, because with thousands of plugins installed a linear search
+   // for each path reported by the providers is quadratic
+   std::unordered_set<wxString> pathIndex;
    for (PluginMap::iterator iter = mPlugins.begin(); iter != mPlugins.end(); ++iter)
    {
       PluginDescriptor & plug = iter->second;
@@ -2361,7 +2368,7 @@ void PluginManager::CheckForUpdates(bool bFast)
          continue;
       }
 
-      pathIndex.push_back(plug.GetPath().BeforeFirst(wxT(';')));
+      pathIndex.insert(plug.GetPath().BeforeFirst(wxT(';')));
    }
 
    // Check all known plugins to ensure they are still valid and scan for NEW ones.
@@ -2406,7 +2413,7 @@ void PluginManager::CheckForUpdates(bool bFast)
             for (size_t i = 0, cnt = paths.size(); i < cnt; i++)
             {
                wxString path = paths[i].BeforeFirst(wxT(';'));;
-               if ( ! make_iterator_range( pathIndex ).contains( path ) )
+               if ( pathIndex.find( path ) == pathIndex.end() )
                {
                   PluginID ID = plugID + wxT("_") + path;
                   PluginDescriptor & plug2 = mPlugins[ID];  // This will create a NEW descriptor
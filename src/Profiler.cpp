@@ -12,8 +12,8 @@
 
 \class Profiler
 \brief A simple profiler to measure the average time lengths that a
-particular task/function takes.  Currently not thread-safe and not thread-smart,
-but it will probably work fine if you use it on a high level.
+particular task/function takes, and a tracer that records nested scopes
+of every thread for viewing on a timeline.
 
 \class TaskProfile
 \brief a simple class to keep track of one task that may be called multiple times.
@@ -23,9 +23,63 @@ but it will probably work fine if you use it on a high level.
 #include "Audacity.h"
 #include "Profiler.h"
 
+#include <chrono>
 #include <stdio.h>
 #include <string.h>
+#include <string>
 #include <wx/crt.h>
+#include <wx/ffile.h>
+
+///One entry of a trace
+struct TraceEvent
+{
+   const char* name;
+   long long start;
+   long long duration;
+   char phase;
+};
+
+///The events of one thread.  Only that thread appends, so it needs no lock;
+///WriteTrace reads the first mCount events, which are never changed again.
+///When the thread ends, the next thread to start recording takes the buffer
+///over and appends after its events.
+struct TraceBuffer
+{
+   // Events past this are dropped rather than allocating on a thread, like
+   // the audio callback, that must not wait
+   static const size_t Capacity = 1 << 17;
+
+   TraceBuffer(int threadId) : mThreadId{ threadId }, mEvents( Capacity ) {}
+
+   const int mThreadId;
+   std::string mName;
+   ArrayOf<TraceEvent> mEvents;
+   std::atomic<size_t> mCount{ 0 };
+   std::atomic<size_t> mDropped{ 0 };
+   std::atomic<bool> mInUse{ false };
+};
+
+namespace {
+
+///Gives the buffer of a thread back to the Profiler when the thread ends
+struct ThreadBufferHolder
+{
+   ~ThreadBufferHolder()
+   {
+      if (buffer)
+         buffer->mInUse.store(false, std::memory_order_release);
+   }
+   TraceBuffer* buffer{ nullptr };
+};
+
+}
+
+std::atomic<bool> Profiler::sTracing{ false };
+
+Profiler::Profiler()
+   : mTraceStart{ Now() }
+{
+}
 
 ///write to a profile at the end of the test.
 Profiler::~Profiler()
@@ -66,6 +120,8 @@ void Profiler::Begin(const char* fileName, int lineNum, const char* taskDescript
    mTasksMutex.Lock();
    GetOrCreateTaskProfile(fileName,lineNum)->Begin(fileName,lineNum,taskDescription);
    mTasksMutex.Unlock();
+   if (IsTracing())
+      Record(taskDescription, 'B', Now());
 }
 
 ///end the task timer.
@@ -77,17 +133,211 @@ void Profiler::End(const char* fileName, int lineNum, const char* taskDescriptio
    if(tp)
       tp->End(fileName,lineNum,taskDescription);
    mTasksMutex.Unlock();
+   if (IsTracing())
+      Record(taskDescription, 'E', Now());
 }
 
 ///Gets the singleton instance
 Profiler* Profiler::Instance()
 {
+   // Initialization of a function-local static is thread-safe
    static Profiler pro;
-   //this isn't 100% threadsafe but I think Okay for this purpose.
 
    return &pro;
 }
 
+void Profiler::StartTracing()
+{
+   sTracing.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::StopTracing()
+{
+   sTracing.store(false, std::memory_order_relaxed);
+}
+
+long long Profiler::Now()
+{
+   using namespace std::chrono;
+   return duration_cast<nanoseconds>(
+      steady_clock::now().time_since_epoch()).count();
+}
+
+TraceBuffer* Profiler::GetThreadBuffer()
+{
+   static thread_local ThreadBufferHolder holder;
+   if (!holder.buffer)
+      holder.buffer = AcquireBuffer();
+   return holder.buffer;
+}
+
+TraceBuffer* Profiler::AcquireBuffer()
+{
+   // Take over a free buffer without locking, so that a thread which made
+   // no buffer in advance still does not wait
+   const auto count = mNumBuffers.load(std::memory_order_acquire);
+   for (size_t i = 0; i < count; ++i)
+   {
+      bool inUse = false;
+      if (mBuffers[i]->mInUse.compare_exchange_strong(inUse, true))
+         return mBuffers[i].get();
+   }
+
+   mBuffersMutex.Lock();
+   auto buffer = AddBuffer();
+   if (buffer)
+      buffer->mInUse.store(true, std::memory_order_relaxed);
+   mBuffersMutex.Unlock();
+   return buffer;
+}
+
+TraceBuffer* Profiler::AddBuffer()
+{
+   const auto count = mNumBuffers.load(std::memory_order_relaxed);
+   if (count >= MaxBuffers)
+      return nullptr;
+   mBuffers[count] = std::make_unique<TraceBuffer>((int)count + 1);
+   mNumBuffers.store(count + 1, std::memory_order_release);
+   return mBuffers[count].get();
+}
+
+void Profiler::ReserveThreadBuffer()
+{
+   if (!IsTracing())
+      return;
+   mBuffersMutex.Lock();
+   bool free = false;
+   const auto count = mNumBuffers.load(std::memory_order_relaxed);
+   for (size_t i = 0; i < count && !free; ++i)
+      free = !mBuffers[i]->mInUse.load(std::memory_order_relaxed);
+   if (!free)
+      AddBuffer();
+   mBuffersMutex.Unlock();
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+   if (!IsTracing())
+      return;
+   auto buffer = GetThreadBuffer();
+   if (!buffer)
+      return;
+   mBuffersMutex.Lock();
+   buffer->mName = name;
+   mBuffersMutex.Unlock();
+}
+
+void Profiler::Record(const char* name, char phase, long long start, long long duration)
+{
+   auto buffer = GetThreadBuffer();
+   if (!buffer)
+      return;
+   auto count = buffer->mCount.load(std::memory_order_relaxed);
+   if (count >= TraceBuffer::Capacity)
+   {
+      buffer->mDropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+   }
+   buffer->mEvents[count] = { name, start, duration, phase };
+   buffer->mCount.store(count + 1, std::memory_order_release);
+}
+
+namespace {
+
+void AppendJSONString(std::string &out, const char* str)
+{
+   out += '"';
+   for (; *str; ++str)
+   {
+      const char c = *str;
+      if (c == '"' || c == '\\')
+      {
+         out += '\\';
+         out += c;
+      }
+      else if ((unsigned char)c < 0x20)
+         out += ' ';
+      else
+         out += c;
+   }
+   out += '"';
+}
+
+}
+
+bool Profiler::WriteTrace(const wxString &fileName)
+{
+   wxFFile file(fileName, wxT("wb"));
+   if (!file.IsOpened())
+      return false;
+
+   std::string out;
+   char number[64];
+   bool ok = true;
+   bool first = true;
+   auto startEvent = [&]{
+      out += first ? "\n" : ",\n";
+      first = false;
+   };
+   // Timestamps are in microseconds
+   auto appendTime = [&](const char* key, long long nanoseconds){
+      snprintf(number, sizeof number, ",\"%s\":%.3f", key, nanoseconds / 1000.0);
+      out += number;
+   };
+
+   out += "{\"traceEvents\":[";
+   mBuffersMutex.Lock();
+   const auto numBuffers = mNumBuffers.load(std::memory_order_relaxed);
+   for (size_t b = 0; b < numBuffers; ++b)
+   {
+      const auto &buffer = mBuffers[b];
+      snprintf(number, sizeof number, "\"pid\":1,\"tid\":%d", buffer->mThreadId);
+      const std::string ids = number;
+
+      if (!buffer->mName.empty())
+      {
+         startEvent();
+         out += "{\"name\":\"thread_name\",\"ph\":\"M\"," + ids + ",\"args\":{\"name\":";
+         AppendJSONString(out, buffer->mName.c_str());
+         out += "}}";
+      }
+
+      const auto count = buffer->mCount.load(std::memory_order_acquire);
+      for (size_t i = 0; i < count; ++i)
+      {
+         const auto &event = buffer->mEvents[i];
+         startEvent();
+         out += "{\"name\":";
+         AppendJSONString(out, event.name);
+         out += ",\"ph\":\"";
+         out += event.phase;
+         out += "\"," + ids;
+         appendTime("ts", event.start - mTraceStart);
+         if (event.phase == 'X')
+            appendTime("dur", event.duration);
+         out += '}';
+      }
+
+      const auto dropped = buffer->mDropped.load(std::memory_order_relaxed);
+      if (dropped > 0)
+      {
+         startEvent();
+         snprintf(number, sizeof number, "%llu", (unsigned long long)dropped);
+         out += "{\"name\":\"dropped_events\",\"ph\":\"M\"," + ids +
+            ",\"args\":{\"count\":" + number + "}}";
+      }
+
+      // Don't keep the whole trace in memory at once
+      ok = ok && file.Write(out.data(), out.size()) == out.size();
+      out.clear();
+   }
+   mBuffersMutex.Unlock();
+   out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+   ok = ok && file.Write(out.data(), out.size()) == out.size();
+   return file.Close() && ok;
+}
+
 ///find a taskProfile for the given task, otherwise create
 TaskProfile* Profiler::GetOrCreateTaskProfile(const char* fileName, int lineNum)
 {
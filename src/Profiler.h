@@ -12,8 +12,14 @@
 
 \class Profiler
 \brief A simple profiler to measure the average time lengths that a
-particular task/function takes.  Currently not thread-safe and not thread-smart,
-but it will probably work fine if you use it on a high level.
+particular task/function takes, and a tracer that records nested scopes
+of every thread for viewing on a timeline.
+
+The averages of BEGIN_TASK_PROFILING/END_TASK_PROFILING pairs are appended
+to AudacityProfilerLog.txt on exit.  Tracing is off until StartTracing();
+after that, PROFILE_SCOPE and the task macros add events to a buffer owned
+by the calling thread, without locking, and WriteTrace() saves them in the
+Chrome trace-event format (chrome://tracing, Perfetto).
 
 \class TaskProfile
 \brief a simple class to keep track of one task that may be called multiple times.
@@ -26,15 +32,23 @@ but it will probably work fine if you use it on a high level.
 
 #ifndef __AUDACITY_PROFILER__
 #define __AUDACITY_PROFILER__
+#include <atomic>
 #include <vector>
 #include <time.h>
 #include "ondemand/ODTaskThread.h"
 
+class wxString;
 
 #define BEGIN_TASK_PROFILING(TASK_DESCRIPTION) Profiler::Instance()->Begin(__FILE__,__LINE__,TASK_DESCRIPTION)
 #define END_TASK_PROFILING(TASK_DESCRIPTION) Profiler::Instance()->End(__FILE__,__LINE__,TASK_DESCRIPTION)
 
+#define PROFILER_CONCAT2(a, b) a ## b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT2(a, b)
+///trace the rest of the enclosing block; NAME must be a string literal
+#define PROFILE_SCOPE(NAME) Profiler::Scope PROFILER_CONCAT(profilerScope, __LINE__){ NAME }
+
 class TaskProfile;
+struct TraceBuffer;
 class Profiler
 {
  public:
@@ -50,9 +64,62 @@ class Profiler
    ///Gets the singleton instance
    static Profiler* Instance();
 
+   ///start recording trace events, on all threads
+   void StartTracing();
+   ///stop recording; events recorded so far are kept
+   void StopTracing();
+   static bool IsTracing()
+   { return sTracing.load(std::memory_order_relaxed); }
+
+   ///label the calling thread in the trace
+   void SetThreadName(const char* name);
+
+   ///make sure that a free buffer waits for the next thread to record, so
+   ///that a thread which must not allocate, like the audio callback, can
+   ///start recording; call it before starting that thread
+   void ReserveThreadBuffer();
+
+   ///write the events of all threads as Chrome trace-event JSON
+   bool WriteTrace(const wxString &fileName);
+
+   ///record one event for the calling thread; name must outlive the Profiler
+   void Record(const char* name, char phase, long long start, long long duration = 0);
+
+   ///steady clock, in nanoseconds
+   static long long Now();
+
+   ///traces the time from construction to destruction as one complete event
+   class Scope
+   {
+   public:
+      explicit Scope(const char* name)
+         : mName{ IsTracing() ? name : nullptr }
+         , mStart{ mName ? Now() : 0 }
+      {}
+      ~Scope()
+      {
+         if (mName)
+            Instance()->Record(mName, 'X', mStart, Now() - mStart);
+      }
+      Scope(const Scope&) = delete;
+      Scope &operator= (const Scope&) = delete;
+
+   private:
+      const char* mName;
+      long long mStart;
+   };
+
   protected:
    ///private constructor - Singleton.
-   Profiler(){};
+   Profiler();
+
+   ///the calling thread's buffer, taken on its first event; null if there
+   ///are too many threads
+   TraceBuffer* GetThreadBuffer();
+   ///a buffer that no running thread uses, made if there is none
+   TraceBuffer* AcquireBuffer();
+   ///make a buffer; call with mBuffersMutex locked
+   TraceBuffer* AddBuffer();
 
    ///find a taskProfile for the given task, otherwise create
    TaskProfile* GetOrCreateTaskProfile(const char* fileName, int lineNum);
@@ -63,6 +130,17 @@ class Profiler
    //mutex for above variable
    ODLock mTasksMutex;
 
+   static std::atomic<bool> sTracing;
+   long long mTraceStart;
+   //Buffers of all threads that recorded events, kept after the threads end
+   //and given to later threads.  The array never moves, so threads can look
+   //for a free buffer among the first mNumBuffers without locking.
+   static const size_t MaxBuffers = 256;
+   std::unique_ptr<TraceBuffer> mBuffers[MaxBuffers];
+   std::atomic<size_t> mNumBuffers{ 0 };
+   //mutex for adding buffers, for thread names, and for writing
+   ODLock mBuffersMutex;
+
 };
 
  class TaskProfile
@@ -20,6 +20,7 @@ Paul Licameli split from ProjectManager.cpp
 #include "AutoRecovery.h"
 #include "CommonCommandFlags.h"
 #include "DirManager.h"
+#include "FrozenTracks.h"
 #include "LabelTrack.h"
 #include "Menus.h"
 #include "Project.h"
@@ -957,6 +958,9 @@ DefaultPlayOptions( AudacityProject &project )
    auto timeTrack = *TrackList::Get( project ).Any<TimeTrack>().begin();
    options.envelope = timeTrack ? timeTrack->GetEnvelope() : nullptr;
    options.listener = ProjectAudioManager::Get( project ).shared_from_this();
+   options.playbackSource = [&project]( const WaveTrack &track, double rate ){
+      return FrozenTracks::Get( project ).Find( track, rate );
+   };
    return options;
 }
 
@@ -976,6 +980,9 @@ DefaultSpeedPlayOptions( AudacityProject &project )
    auto timeTrack = *TrackList::Get( project ).Any<TimeTrack>().begin();
    options.envelope = timeTrack ? timeTrack->GetEnvelope() : nullptr;
    options.listener = ProjectAudioManager::Get( project ).shared_from_this();
+   options.playbackSource = [&project]( const WaveTrack &track, double rate ){
+      return FrozenTracks::Get( project ).Find( track, rate );
+   };
    return options;
 }
 
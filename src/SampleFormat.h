@@ -79,6 +79,11 @@ public:
       mPtr = 0;
    }
 
+   void Swap(SampleBuffer &other)
+   {
+      std::swap(mPtr, other.mPtr);
+   }
+
    samplePtr ptr() const { return mPtr; }
 
 
@@ -896,6 +896,18 @@ bool Sequence::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
          }
       } // while
 
+      // Reserve the block array up front, so that projects with very many
+      // blocks do not pay for repeated reallocation while loading.
+      // Blocks are normally at least half of mMaxSamples; the estimate is
+      // capped so that a corrupt numsamples attribute cannot force a huge
+      // allocation.
+      if (mNumSamples > 0) {
+         const auto estimate =
+            mNumSamples.as_double() / std::max< size_t >( 1, mMaxSamples / 2 );
+         const size_t maxReserve = 1 << 20;
+         mBlock.reserve( 1 + std::min( estimate, (double)maxReserve ) );
+      }
+
       //// Both mMaxSamples and mSampleFormat should have been set.
       //// Check that mMaxSamples is right for mSampleFormat, using the calculations from the constructor.
       //if ((mMinSamples != sMaxDiskBlockSize / SAMPLE_SIZE(mSampleFormat) / 2) ||
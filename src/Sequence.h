@@ -176,6 +176,10 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
    // This returns a possibly large or negative value
    sampleCount GetBlockStart(sampleCount position) const;
 
+   // The block containing position, which must be in range
+   const SeqBlock &GetBlockAt(sampleCount position) const
+   { return mBlock[FindBlock(position)]; }
+
    // These return a nonnegative number of samples meant to size a memory buffer
    size_t GetBestBlockSize(sampleCount start) const;
    size_t GetMaxBlockSize() const;
@@ -0,0 +1,120 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SilenceFinder.cpp
+
+*******************************************************************//**
+
+\class SilenceFinder
+\brief Classifies stretches of a track as silent or not, from the summaries
+of its blocks.
+
+Whole blocks are judged first by the minimum and maximum kept in memory.
+Only blocks that are neither all silent nor all loud have their
+256-sample summaries read, and only frames that are still undecided
+need their samples read by the caller.  Gaps between clips count as
+zeroes.
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "SilenceFinder.h"
+
+#include "BlockFile.h"
+#include "WaveTrack.h"
+
+namespace {
+const size_t FrameSize = 256;
+}
+
+SilenceFinder::SilenceFinder(const WaveTrack &track, float threshold)
+   : mTrack{ track }
+   , mThreshold{ threshold }
+{
+}
+
+auto SilenceFinder::KindOf(float min, float max) const -> Kind
+{
+   if (min > -mThreshold && max < mThreshold)
+      return kSilent;
+   if (min >= mThreshold || max <= -mThreshold)
+      return kLoud;
+   return kMixed;
+}
+
+const float *SilenceFinder::GetSummary256(const BlockFilePtr &pBlock)
+{
+   if (pBlock != mSummaryBlock) {
+      const auto frames = (pBlock->GetLength() + FrameSize - 1) / FrameSize;
+      mSummary.reinit(frames * 3);
+      mSummaryBlock = pBlock;
+      // Read256 fills with zeroes on failure, which must not pass for silence
+      mSummaryValid = pBlock->Read256(mSummary.get(), 0, frames);
+   }
+   return mSummaryValid ? mSummary.get() : nullptr;
+}
+
+auto SilenceFinder::Classify(sampleCount start, sampleCount end) -> Run
+{
+   bool first = true;
+   Kind kind = kMixed;
+   // Whether the next stretch continues the run
+   auto extend = [&](Kind next) {
+      if (first)
+         first = false, kind = next;
+      return kind == next;
+   };
+
+   auto pos = start;
+   while (pos < end) {
+      sampleCount blockStart;
+      const auto pBlock = mTrack.GetBlockAt(pos, blockStart);
+      if (!pBlock) {
+         if (!extend(KindOf(0, 0)))
+            break;
+         if (blockStart < 0 || blockStart >= end) {
+            pos = end;
+            break;
+         }
+         pos = blockStart;
+         continue;
+      }
+
+      const auto len = pBlock->GetLength();
+      const auto blockEnd = blockStart + len;
+      const float *summary = nullptr;
+      if (pBlock->IsSummaryAvailable()) {
+         const auto results = pBlock->GetMinMaxRMS();
+         const auto blockKind = KindOf(results.min, results.max);
+         if (blockKind != kMixed) {
+            if (!extend(blockKind))
+               break;
+            pos = blockEnd;
+            continue;
+         }
+         summary = GetSummary256(pBlock);
+      }
+
+      if (!summary) {
+         if (!extend(kMixed))
+            break;
+         pos = blockEnd;
+         continue;
+      }
+
+      // Refine by frames, starting with the one containing pos
+      const auto frames = (len + FrameSize - 1) / FrameSize;
+      auto frame = (pos - blockStart).as_size_t() / FrameSize;
+      for (; frame < frames; ++frame)
+         if (!extend(KindOf(summary[3 * frame], summary[3 * frame + 1])))
+            break;
+      if (frame < frames) {
+         pos = std::max(pos, blockStart + frame * FrameSize);
+         break;
+      }
+      pos = blockEnd;
+   }
+
+   return { kind, std::min(pos, end) - start };
+}
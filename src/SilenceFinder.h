@@ -0,0 +1,62 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SilenceFinder.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SILENCE_FINDER__
+#define __AUDACITY_SILENCE_FINDER__
+
+#include "MemoryX.h"
+#include "audacity/Types.h"
+
+class BlockFile;
+using BlockFilePtr = std::shared_ptr<BlockFile>;
+class WaveTrack;
+
+///\brief Classifies stretches of a track as silent or not, from the summaries
+///of its blocks, so that callers read samples only where summaries can't tell
+class SilenceFinder
+{
+public:
+   enum Kind {
+      /// All samples have absolute value below the threshold
+      kSilent,
+      /// No sample has absolute value below the threshold
+      kLoud,
+      /// The summaries can't tell; samples must be read
+      kMixed,
+   };
+
+   struct Run
+   {
+      Kind kind;
+      sampleCount length;
+   };
+
+   SilenceFinder(const WaveTrack &track, float threshold);
+   SilenceFinder(const SilenceFinder&) PROHIBITED;
+   SilenceFinder &operator= (const SilenceFinder&) PROHIBITED;
+
+   /// Returns the kind of the sample at start, and the number of samples
+   /// from there, not going past end, known to be of the same kind.
+   /// Precondition: start < end
+   Run Classify(sampleCount start, sampleCount end);
+
+private:
+   Kind KindOf(float min, float max) const;
+   // Returns the 256-sample summary of the block, or null if unreadable
+   const float *GetSummary256(const BlockFilePtr &pBlock);
+
+   const WaveTrack &mTrack;
+   const float mThreshold;
+
+   // Summary of the last block refined by frames
+   BlockFilePtr mSummaryBlock;
+   Floats mSummary;
+   bool mSummaryValid{ false };
+};
+
+#endif
@@ -0,0 +1,131 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ThreadPool.cpp
+
+*******************************************************************//**
+
+\class ThreadPool
+\brief A fixed set of worker threads running queued tasks.
+
+Tasks must not touch the user interface, nor modify data that other
+threads may read at the same time.
+
+\class ThreadPool::Batch
+\brief Tasks posted to a pool and waited for together, passing exceptions
+back to the waiting thread.
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include "Profiler.h"
+
+ThreadPool &ThreadPool::Get()
+{
+   static ThreadPool instance{
+      std::max< size_t >( 1, std::thread::hardware_concurrency() ) };
+   return instance;
+}
+
+ThreadPool::ThreadPool( size_t nThreads )
+{
+   mThreads.reserve( nThreads );
+   for ( size_t ii = 0; ii < nThreads; ++ii )
+      mThreads.emplace_back( [this]{ Run(); } );
+}
+
+ThreadPool::~ThreadPool()
+{
+   {
+      std::lock_guard< std::mutex > lock{ mMutex };
+      mStopping = true;
+   }
+   mAvailable.notify_all();
+   for ( auto &thread : mThreads )
+      thread.join();
+}
+
+void ThreadPool::Post( Task task )
+{
+   {
+      std::lock_guard< std::mutex > lock{ mMutex };
+      mTasks.push_back( std::move( task ) );
+   }
+   mAvailable.notify_one();
+}
+
+void ThreadPool::Run()
+{
+   Profiler::Instance()->SetThreadName( "Worker" );
+   while ( true ) {
+      Task task;
+      {
+         std::unique_lock< std::mutex > lock{ mMutex };
+         mAvailable.wait( lock, [this]{ return mStopping || !mTasks.empty(); } );
+         if ( mTasks.empty() )
+            return;
+         task = std::move( mTasks.front() );
+         mTasks.pop_front();
+      }
+      task();
+   }
+}
+
+ThreadPool::Batch::Batch( ThreadPool &pool )
+   : mPool{ pool }
+{
+}
+
+ThreadPool::Batch::~Batch()
+{
+   std::unique_lock< std::mutex > lock{ mMutex };
+   mDone.wait( lock, [this]{ return mPending == 0; } );
+}
+
+void ThreadPool::Batch::Add( Task task )
+{
+   {
+      std::lock_guard< std::mutex > lock{ mMutex };
+      ++mPending;
+   }
+   mPool.Post( [this, task]{
+      std::exception_ptr exception;
+      try {
+         task();
+      }
+      catch ( ... ) {
+         exception = std::current_exception();
+      }
+      std::lock_guard< std::mutex > lock{ mMutex };
+      if ( exception && !mException )
+         mException = exception;
+      // Notify while still locked, because the waiter may destroy this
+      // batch as soon as it sees the count reach zero
+      if ( --mPending == 0 )
+         mDone.notify_all();
+   } );
+}
+
+bool ThreadPool::Batch::WaitFor( int milliseconds )
+{
+   std::unique_lock< std::mutex > lock{ mMutex };
+   return mDone.wait_for( lock, std::chrono::milliseconds( milliseconds ),
+      [this]{ return mPending == 0; } );
+}
+
+void ThreadPool::Batch::Wait()
+{
+   std::exception_ptr exception;
+   {
+      std::unique_lock< std::mutex > lock{ mMutex };
+      mDone.wait( lock, [this]{ return mPending == 0; } );
+      std::swap( exception, mException );
+   }
+   if ( exception )
+      std::rethrow_exception( exception );
+}
@@ -0,0 +1,74 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ThreadPool.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_THREAD_POOL__
+#define __AUDACITY_THREAD_POOL__
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///\brief A fixed set of worker threads running queued tasks
+class ThreadPool
+{
+public:
+   using Task = std::function< void() >;
+
+   /// The pool shared by the whole program, with one thread per processor
+   static ThreadPool &Get();
+
+   explicit ThreadPool( size_t nThreads );
+   ThreadPool( const ThreadPool& ) = delete;
+   ThreadPool &operator= ( const ThreadPool& ) = delete;
+   /// Finishes the queued tasks first
+   ~ThreadPool();
+
+   size_t GetThreadCount() const { return mThreads.size(); }
+
+   ///\brief Tasks posted to a pool and waited for together
+   class Batch
+   {
+   public:
+      explicit Batch( ThreadPool &pool );
+      Batch( const Batch& ) = delete;
+      Batch &operator= ( const Batch& ) = delete;
+      /// Waits for the tasks still to finish, but drops their exceptions
+      ~Batch();
+
+      void Add( Task task );
+
+      /// Returns whether all tasks finished within the time
+      bool WaitFor( int milliseconds );
+      /// Waits for all tasks, then rethrows the first exception any of
+      /// them threw
+      void Wait();
+
+   private:
+      ThreadPool &mPool;
+      std::mutex mMutex;
+      std::condition_variable mDone;
+      size_t mPending{ 0 };
+      std::exception_ptr mException;
+   };
+
+private:
+   void Post( Task task );
+   void Run();
+
+   std::mutex mMutex;
+   std::condition_variable mAvailable;
+   std::deque< Task > mTasks;
+   bool mStopping{ false };
+   std::vector< std::thread > mThreads;
+};
+
+#endif
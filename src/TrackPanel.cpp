@@ -70,6 +70,7 @@ is time to refresh some aspect of the screen.
 #include "float_cast.h"
 
 #include "Prefs.h"
+#include "Profiler.h"
 #include "RefreshCode.h"
 #include "TrackArtist.h"
 #include "TrackPanelAx.h"
@@ -844,6 +845,7 @@ void TrackPanel::OnAudioIO(wxCommandEvent & evt)
 /// actual contents of each track are drawn by the TrackArtist.
 void TrackPanel::DrawTracks(wxDC * dc)
 {
+   PROFILE_SCOPE("TrackPanel::DrawTracks");
    wxRegion region = GetUpdateRegion();
 
    const wxRect clip = GetRect();
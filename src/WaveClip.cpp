@@ -24,6 +24,7 @@
 #include "Experimental.h"
 
 #include <math.h>
+#include <atomic>
 #include <functional>
 #include <vector>
 #include <wx/log.h>
@@ -385,11 +386,19 @@ WaveClip::~WaveClip()
 {
 }
 
+void WaveClip::NoteLayoutChange()
+// NOFAIL-GUARANTEE
+{
+   if (mLayoutGeneration)
+      ++*mLayoutGeneration;
+}
+
 void WaveClip::SetOffset(double offset)
 // NOFAIL-GUARANTEE
 {
     mOffset = offset;
     mEnvelope->SetOffset(mOffset);
+    NoteLayoutChange();
 }
 
 bool WaveClip::GetSamples(samplePtr buffer, sampleFormat format,
@@ -1072,6 +1081,7 @@ void SpecCache::Populate
     sampleCount numSamples,
     double offset, double rate, double pixelsPerSecond)
 {
+   PROFILE_SCOPE("SpecCache::Populate");
    const int &frequencyGainSetting = settings.frequencyGain;
    const size_t windowSizeSetting = settings.WindowSize();
    const bool autocorrelation =
@@ -1526,8 +1536,10 @@ bool WaveClip::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
 
 void WaveClip::HandleXMLEndTag(const wxChar *tag)
 {
-   if (!wxStrcmp(tag, wxT("waveclip")))
+   if (!wxStrcmp(tag, wxT("waveclip"))) {
       UpdateEnvelopeTrackLen();
+      NoteLayoutChange();
+   }
 }
 
 XMLTagHandler *WaveClip::HandleXMLChild(const wxChar *tag)
@@ -1612,6 +1624,7 @@ void WaveClip::Paste(double t0, const WaveClip* other)
 
    // Assume NOFAIL-GUARANTEE in the remaining
    MarkChanged();
+   NoteLayoutChange();
    auto sampleTime = 1.0 / GetRate();
    mEnvelope->PasteEnvelope
       (s0.as_double()/mRate + mOffset, pastedClip->mEnvelope.get(), sampleTime);
@@ -1652,6 +1665,7 @@ void WaveClip::InsertSilence( double t, double len, double *pEnvelopeValue )
       pEnvelope->InsertSpace( t, len );
 
    MarkChanged();
+   NoteLayoutChange();
 }
 
 void WaveClip::AppendSilence( double len, double envelopeValue )
@@ -1720,6 +1734,7 @@ void WaveClip::Clear(double t0, double t1)
       Offset(-(GetStartTime() - t0));
 
    MarkChanged();
+   NoteLayoutChange();
 }
 
 void WaveClip::ClearAndAddCutLine(double t0, double t1)
@@ -1773,6 +1788,7 @@ void WaveClip::ClearAndAddCutLine(double t0, double t1)
       Offset(-(GetStartTime() - t0));
 
    MarkChanged();
+   NoteLayoutChange();
 
    mCutLines.push_back(std::move(newClip));
 }
@@ -1881,6 +1897,7 @@ void WaveClip::SetRate(int rate)
    auto newLength = mSequence->GetNumSamples().as_double() / mRate;
    mEnvelope->RescaleTimes( newLength );
    MarkChanged();
+   NoteLayoutChange();
 }
 
 void WaveClip::Resample(int rate, ProgressDialog *progress)
@@ -1965,6 +1982,7 @@ void WaveClip::Resample(int rate, ProgressDialog *progress)
 
       mSequence = std::move(newSequence);
       mRate = rate;
+      NoteLayoutChange();
    }
 }
 
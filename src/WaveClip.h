@@ -22,6 +22,7 @@
 
 #include <wx/longlong.h>
 
+#include <atomic>
 #include <vector>
 
 class BlockArray;
@@ -248,6 +249,17 @@ public:
    Sequence* GetSequence() { return mSequence.get(); }
    const Sequence* GetSequence() const { return mSequence.get(); }
 
+   /** Counts changes to the position or length of the clips of one track,
+    * so that the WaveTrack can tell when its sorted index of clips is out of
+    * date.  Shared, because a clip may outlive the track that held it. */
+   using LayoutGeneration = std::shared_ptr< std::atomic<unsigned long> >;
+   /** WaveTrack calls this when it takes ownership of the clip. */
+   void SetLayoutGeneration(const LayoutGeneration &generation)
+      { mLayoutGeneration = generation; }
+   /** Called after the clip moves or changes length other than by growing
+    * at its end, as Append() and Flush() do. */
+   void NoteLayoutChange(); // NOFAIL-GUARANTEE
+
    /** WaveTrack calls this whenever data in the wave clip changes. It is
     * called automatically when WaveClip has a chance to know that something
     * has changed, like when member functions SetSamples() etc. are called. */
@@ -275,7 +287,8 @@ public:
 
    /** Whenever you do an operation to the sequence that will change the number
     * of samples (that is, the length of the clip), you will want to call this
-    * function to tell the envelope about it. */
+    * function to tell the envelope about it.  Call NoteLayoutChange() too,
+    * unless the samples were appended to the rightmost clip of the track. */
    void UpdateEnvelopeTrackLen();
 
    /// You must call Flush after the last Append
@@ -388,6 +401,8 @@ protected:
 
    // AWD, Oct. 2009: for whitespace-at-end-of-selection pasting
    bool mIsPlaceholder { false };
+
+   LayoutGeneration mLayoutGeneration;
 };
 
 #endif
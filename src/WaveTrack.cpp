@@ -40,6 +40,7 @@ Track classes.
 #include <float.h>
 #include <math.h>
 #include <algorithm>
+#include <limits>
 
 #include "float_cast.h"
 
@@ -135,7 +136,7 @@ WaveTrack::WaveTrack(const WaveTrack &orig):
    Init(orig);
 
    for (const auto &clip : orig.mClips)
-      mClips.push_back
+      PushClip
          ( std::make_unique<WaveClip>( *clip, mDirManager, true ) );
 }
 
@@ -551,7 +552,7 @@ Track::Holder WaveTrack::Copy(double t0, double t1, bool forClipboard) const
          // Whole clip is in copy region
          //wxPrintf("copy: clip %i is in copy region\n", (int)clip);
 
-         newTrack->mClips.push_back
+         newTrack->PushClip
             (std::make_unique<WaveClip>(*clip, mDirManager, ! forClipboard));
          WaveClip *const newClip = newTrack->mClips.back().get();
          newClip->Offset(-t0);
@@ -573,7 +574,7 @@ Track::Holder WaveTrack::Copy(double t0, double t1, bool forClipboard) const
          if (newClip->GetOffset() < 0)
             newClip->SetOffset(0);
 
-         newTrack->mClips.push_back(std::move(newClip)); // transfer ownership
+         newTrack->PushClip(std::move(newClip)); // transfer ownership
       }
    }
 
@@ -591,7 +592,7 @@ Track::Holder WaveTrack::Copy(double t0, double t1, bool forClipboard) const
       placeholder->SetIsPlaceholder(true);
       placeholder->InsertSilence(0, (t1 - t0) - newTrack->GetEndTime());
       placeholder->Offset(newTrack->GetEndTime());
-      newTrack->mClips.push_back(std::move(placeholder)); // transfer ownership
+      newTrack->PushClip(std::move(placeholder)); // transfer ownership
    }
 
    return result;
@@ -921,6 +922,7 @@ std::shared_ptr<WaveClip> WaveTrack::RemoveAndReturnClip(WaveClip* clip)
    if (it != mClips.end()) {
       auto result = std::move(*it); // Array stops owning the clip, before we shrink it
       mClips.erase(it);
+      NoteLayoutChange();
       return result;
    }
    else
@@ -931,7 +933,7 @@ void WaveTrack::AddClip(std::shared_ptr<WaveClip> &&clip)
 {
    // Uncomment the following line after we correct the problem of zero-length clips
    //if (CanInsertClip(clip))
-      mClips.push_back(std::move(clip)); // transfer ownership
+      PushClip(std::move(clip)); // transfer ownership
 }
 
 void WaveTrack::HandleClear(double t0, double t1,
@@ -1066,9 +1068,10 @@ void WaveTrack::HandleClear(double t0, double t1,
       else
          wxASSERT(false);
    }
+   NoteLayoutChange();
 
    for (auto &clip: clipsToAdd)
-      mClips.push_back(std::move(clip)); // transfer ownership
+      PushClip(std::move(clip)); // transfer ownership
 }
 
 void WaveTrack::SyncLockAdjust(double oldT1, double newT1)
@@ -1261,7 +1264,7 @@ void WaveTrack::Paste(double t0, const Track *src)
             newClip->Resample(mRate);
             newClip->Offset(t0);
             newClip->MarkChanged();
-            mClips.push_back(std::move(newClip)); // transfer ownership
+            PushClip(std::move(newClip)); // transfer ownership
          }
       }
       return true;
@@ -1322,7 +1325,7 @@ void WaveTrack::InsertSilence(double t, double len)
       auto clip = std::make_unique<WaveClip>(mDirManager, mFormat, mRate, this->GetWaveColorIndex());
       clip->InsertSilence(0, len);
       // use NOFAIL-GUARANTEE
-      mClips.push_back( std::move( clip ) );
+      PushClip( std::move( clip ) );
       return;
    }
    else {
@@ -1475,6 +1478,7 @@ void WaveTrack::Join(double t0, double t1)
 
       auto it = FindClip(mClips, clip);
       mClips.erase(it); // deletes the clip
+      NoteLayoutChange();
    }
 }
 
@@ -1854,6 +1858,130 @@ float WaveTrack::GetRMS(double t0, double t1, bool mayThrow) const
    return length > 0 ? sqrt(sumsq / length.as_double()) : 0.0;
 }
 
+struct WaveTrack::ClipIndex
+{
+   struct Entry
+   {
+      WaveClip *clip;
+      double startTime;
+      sampleCount startSample;
+      // Greatest end of the clips starting before this one, so that a
+      // backward scan for overlapping clips knows when to stop.  The
+      // rightmost clips are left out, and so they may grow without making
+      // the index stale.
+      double maxEndTimeBefore;
+      sampleCount maxEndSampleBefore;
+   };
+
+   unsigned long generation;
+   std::vector<Entry> entries;
+
+   // Visit, from last to first, the clips overlapping the interval [t0, t1)
+   template< typename Function >
+   void VisitTimes(double t0, double t1, const Function &function) const
+   {
+      auto it = std::lower_bound(entries.begin(), entries.end(), t1,
+         [](const Entry &entry, double t){ return entry.startTime < t; });
+      bool stopping = false;
+      double stop = 0;
+      while (it != entries.begin()) {
+         --it;
+         if (stopping && it->startTime < stop)
+            break;
+         if (it->clip->GetEndTime() > t0)
+            function(it->clip);
+         // Only clips starting with this one may still overlap
+         if (!stopping && it->maxEndTimeBefore <= t0)
+            stopping = true, stop = it->startTime;
+      }
+   }
+
+   // Visit, from last to first, the clips overlapping the samples [s0, s1)
+   template< typename Function >
+   void VisitSamples(sampleCount s0, sampleCount s1,
+                     const Function &function) const
+   {
+      auto it = std::lower_bound(entries.begin(), entries.end(), s1,
+         [](const Entry &entry, sampleCount s){ return entry.startSample < s; });
+      bool stopping = false;
+      sampleCount stop = 0;
+      while (it != entries.begin()) {
+         --it;
+         if (stopping && it->startSample < stop)
+            break;
+         if (it->clip->GetEndSample() > s0)
+            function(it->clip);
+         if (!stopping && it->maxEndSampleBefore <= s0)
+            stopping = true, stop = it->startSample;
+      }
+   }
+};
+
+auto WaveTrack::GetClipIndex() const -> std::shared_ptr<const ClipIndex>
+{
+   // Get() may be called from the audio thread while the main thread
+   // looks up clips
+   wxCriticalSectionLocker locker(mClipIndexCriticalSection);
+
+   const auto generation = mLayoutGeneration->load();
+   if (mClipIndex &&
+       mClipIndex->generation == generation &&
+       mClipIndex->entries.size() == mClips.size())
+      return mClipIndex;
+
+   auto index = std::make_shared<ClipIndex>();
+   index->generation = generation;
+   auto &entries = index->entries;
+   entries.reserve(mClips.size());
+   for (const auto &clip : mClips)
+      entries.push_back({ clip.get(),
+         clip->GetStartTime(), clip->GetStartSample(), 0, 0 });
+   std::stable_sort(entries.begin(), entries.end(),
+      [](const ClipIndex::Entry &a, const ClipIndex::Entry &b)
+   { return a.startTime < b.startTime; });
+   auto maxEndTime = std::numeric_limits<double>::lowest();
+   sampleCount maxEndSample =
+      std::numeric_limits<sampleCount::type>::min();
+   for (size_t ii = 0, first = 0; ii < entries.size(); ++ii) {
+      // Clips starting together share the bound of the clips before them
+      if (entries[ii].startTime != entries[first].startTime) {
+         for (; first < ii; ++first) {
+            maxEndTime = std::max(maxEndTime, entries[first].clip->GetEndTime());
+            maxEndSample =
+               std::max(maxEndSample, entries[first].clip->GetEndSample());
+         }
+      }
+      entries[ii].maxEndTimeBefore = maxEndTime;
+      entries[ii].maxEndSampleBefore = maxEndSample;
+   }
+
+   mClipIndex = index;
+   return mClipIndex;
+}
+
+BlockFilePtr WaveTrack::GetBlockAt(sampleCount s, sampleCount &start) const
+{
+   BlockFilePtr result;
+   const auto index = GetClipIndex();
+   // Where clips overlap, take the block of the one starting first, whose
+   // samples Get() copies last
+   index->VisitSamples(s, s + 1, [&](const WaveClip *clip)
+   {
+      const auto clipStart = clip->GetStartSample();
+      const auto &block = clip->GetSequence()->GetBlockAt(s - clipStart);
+      result = block.f;
+      start = clipStart + block.start;
+   });
+   if (!result) {
+      auto &entries = index->entries;
+      auto it = std::upper_bound(entries.begin(), entries.end(), s,
+         [](sampleCount s, const ClipIndex::Entry &entry)
+         { return s < entry.startSample; });
+      start = (it == entries.end()) ? sampleCount{ -1 } : it->startSample;
+   }
+   return result;
+}
+
 bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
                     sampleCount start, size_t len, fillFormat fill,
                     bool mayThrow, sampleCount * pNumCopied) const
@@ -1864,14 +1992,12 @@ bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
    bool doClear = true;
    bool result = true;
    sampleCount samplesCopied = 0;
-   for (const auto &clip: mClips)
+   const auto index = GetClipIndex();
+   index->VisitSamples(start, start + 1, [&](const WaveClip *clip)
    {
       if (start >= clip->GetStartSample() && start+len <= clip->GetEndSample())
-      {
          doClear = false;
-         break;
-      }
-   }
+   });
    if (doClear)
    {
       // Usually we fill in empty space with zero
@@ -1891,45 +2017,43 @@ bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
       }
    }
 
-   for (const auto &clip: mClips)
+   // Clips are copied from last to first in order of start, so where they
+   // overlap, the one starting first wins
+   index->VisitSamples(start, start + len, [&](const WaveClip *clip)
    {
       auto clipStart = clip->GetStartSample();
-      auto clipEnd = clip->GetEndSample();
 
-      if (clipEnd > start && clipStart < start+len)
+      // Clip sample region and Get/Put sample region overlap
+      auto samplesToCopy =
+         std::min( start+len - clipStart, clip->GetNumSamples() );
+      auto startDelta = clipStart - start;
+      decltype(startDelta) inclipDelta = 0;
+      if (startDelta < 0)
       {
-         // Clip sample region and Get/Put sample region overlap
-         auto samplesToCopy =
-            std::min( start+len - clipStart, clip->GetNumSamples() );
-         auto startDelta = clipStart - start;
-         decltype(startDelta) inclipDelta = 0;
-         if (startDelta < 0)
-         {
-            inclipDelta = -startDelta; // make positive value
-            samplesToCopy -= inclipDelta;
-            // samplesToCopy is now either len or
-            //    (clipEnd - clipStart) - (start - clipStart)
-            //    == clipEnd - start > 0
-            // samplesToCopy is not more than len
-            //
-            startDelta = 0;
-            // startDelta is zero
-         }
-         else {
-            // startDelta is nonnegative and less than than len
-            // samplesToCopy is positive and not more than len
-         }
-
-         if (!clip->GetSamples(
-               (samplePtr)(((char*)buffer) +
-                           startDelta.as_size_t() *
-                           SAMPLE_SIZE(format)),
-               format, inclipDelta, samplesToCopy.as_size_t(), mayThrow ))
-            result = false;
-         else
-            samplesCopied += samplesToCopy;
+         inclipDelta = -startDelta; // make positive value
+         samplesToCopy -= inclipDelta;
+         // samplesToCopy is now either len or
+         //    (clipEnd - clipStart) - (start - clipStart)
+         //    == clipEnd - start > 0
+         // samplesToCopy is not more than len
+         //
+         startDelta = 0;
+         // startDelta is zero
       }
-   }
+      else {
+         // startDelta is nonnegative and less than than len
+         // samplesToCopy is positive and not more than len
+      }
+
+      if (!clip->GetSamples(
+            (samplePtr)(((char*)buffer) +
+                        startDelta.as_size_t() *
+                        SAMPLE_SIZE(format)),
+            format, inclipDelta, samplesToCopy.as_size_t(), mayThrow ))
+         result = false;
+      else
+         samplesCopied += samplesToCopy;
+   });
    if( pNumCopied )
       *pNumCopied = samplesCopied;
    return result;
@@ -1939,43 +2063,39 @@ void WaveTrack::Set(samplePtr buffer, sampleFormat format,
                     sampleCount start, size_t len)
 // WEAK-GUARANTEE
 {
-   for (const auto &clip: mClips)
+   GetClipIndex()->VisitSamples(start, start + len, [&](WaveClip *clip)
    {
       auto clipStart = clip->GetStartSample();
-      auto clipEnd = clip->GetEndSample();
 
-      if (clipEnd > start && clipStart < start+len)
+      // Clip sample region and Get/Put sample region overlap
+      auto samplesToCopy =
+         std::min( start+len - clipStart, clip->GetNumSamples() );
+      auto startDelta = clipStart - start;
+      decltype(startDelta) inclipDelta = 0;
+      if (startDelta < 0)
       {
-         // Clip sample region and Get/Put sample region overlap
-         auto samplesToCopy =
-            std::min( start+len - clipStart, clip->GetNumSamples() );
-         auto startDelta = clipStart - start;
-         decltype(startDelta) inclipDelta = 0;
-         if (startDelta < 0)
-         {
-            inclipDelta = -startDelta; // make positive value
-            samplesToCopy -= inclipDelta;
-            // samplesToCopy is now either len or
-            //    (clipEnd - clipStart) - (start - clipStart)
-            //    == clipEnd - start > 0
-            // samplesToCopy is not more than len
-            //
-            startDelta = 0;
-            // startDelta is zero
-         }
-         else {
-            // startDelta is nonnegative and less than than len
-            // samplesToCopy is positive and not more than len
-         }
-
-         clip->SetSamples(
-               (samplePtr)(((char*)buffer) +
-                           startDelta.as_size_t() *
-                           SAMPLE_SIZE(format)),
-                          format, inclipDelta, samplesToCopy.as_size_t() );
-         clip->MarkChanged();
+         inclipDelta = -startDelta; // make positive value
+         samplesToCopy -= inclipDelta;
+         // samplesToCopy is now either len or
+         //    (clipEnd - clipStart) - (start - clipStart)
+         //    == clipEnd - start > 0
+         // samplesToCopy is not more than len
+         //
+         startDelta = 0;
+         // startDelta is zero
       }
-   }
+      else {
+         // startDelta is nonnegative and less than than len
+         // samplesToCopy is positive and not more than len
+      }
+
+      clip->SetSamples(
+            (samplePtr)(((char*)buffer) +
+                        startDelta.as_size_t() *
+                        SAMPLE_SIZE(format)),
+                       format, inclipDelta, samplesToCopy.as_size_t() );
+      clip->MarkChanged();
+   });
 }
 
 void WaveTrack::GetEnvelopeValues(double *buffer, size_t bufferLen,
@@ -1999,49 +2119,47 @@ void WaveTrack::GetEnvelopeValues(double *buffer, size_t bufferLen,
    double startTime = t0;
    auto tstep = 1.0 / mRate;
    double endTime = t0 + tstep * bufferLen;
-   for (const auto &clip: mClips)
+   // For each clip that intersects startTime..endTime...
+   GetClipIndex()->VisitTimes(startTime, endTime, [&](const WaveClip *clip)
    {
-      // IF clip intersects startTime..endTime THEN...
       auto dClipStartTime = clip->GetStartTime();
       auto dClipEndTime = clip->GetEndTime();
-      if ((dClipStartTime < endTime) && (dClipEndTime > startTime))
-      {
-         auto rbuf = buffer;
-         auto rlen = bufferLen;
-         auto rt0 = t0;
 
-         if (rt0 < dClipStartTime)
-         {
-            // This is not more than the number of samples in
-            // (endTime - startTime) which is bufferLen:
-            auto nDiff = (sampleCount)floor((dClipStartTime - rt0) * mRate + 0.5);
-            auto snDiff = nDiff.as_size_t();
-            rbuf += snDiff;
-            wxASSERT(snDiff <= rlen);
-            rlen -= snDiff;
-            rt0 = dClipStartTime;
-         }
+      auto rbuf = buffer;
+      auto rlen = bufferLen;
+      auto rt0 = t0;
 
-         if (rt0 + rlen*tstep > dClipEndTime)
-         {
-            auto nClipLen = clip->GetEndSample() - clip->GetStartSample();
-
-            if (nClipLen <= 0) // Testing for bug 641, this problem is consistently '== 0', but doesn't hurt to check <.
-               return;
-
-            // This check prevents problem cited in http://bugzilla.audacityteam.org/show_bug.cgi?id=528#c11,
-            // Gale's cross_fade_out project, which was already corrupted by bug 528.
-            // This conditional prevents the previous write past the buffer end, in clip->GetEnvelope() call.
-            // Never increase rlen here.
-            // PRL bug 827:  rewrote it again
-            rlen = limitSampleBufferSize( rlen, nClipLen );
-            rlen = std::min(rlen, size_t(floor(0.5 + (dClipEndTime - rt0) / tstep)));
-         }
-         // Samples are obtained for the purpose of rendering a wave track,
-         // so quantize time
-         clip->GetEnvelope()->GetValues(rbuf, rlen, rt0, tstep);
+      if (rt0 < dClipStartTime)
+      {
+         // This is not more than the number of samples in
+         // (endTime - startTime) which is bufferLen:
+         auto nDiff = (sampleCount)floor((dClipStartTime - rt0) * mRate + 0.5);
+         auto snDiff = nDiff.as_size_t();
+         rbuf += snDiff;
+         wxASSERT(snDiff <= rlen);
+         rlen -= snDiff;
+         rt0 = dClipStartTime;
       }
-   }
+
+      if (rt0 + rlen*tstep > dClipEndTime)
+      {
+         auto nClipLen = clip->GetEndSample() - clip->GetStartSample();
+
+         if (nClipLen <= 0) // Testing for bug 641, this problem is consistently '== 0', but doesn't hurt to check <.
+            return;
+
+         // This check prevents problem cited in http://bugzilla.audacityteam.org/show_bug.cgi?id=528#c11,
+         // Gale's cross_fade_out project, which was already corrupted by bug 528.
+         // This conditional prevents the previous write past the buffer end, in clip->GetEnvelope() call.
+         // Never increase rlen here.
+         // PRL bug 827:  rewrote it again
+         rlen = limitSampleBufferSize( rlen, nClipLen );
+         rlen = std::min(rlen, size_t(floor(0.5 + (dClipEndTime - rt0) / tstep)));
+      }
+      // Samples are obtained for the purpose of rendering a wave track,
+      // so quantize time
+      clip->GetEnvelope()->GetValues(rbuf, rlen, rt0, tstep);
+   });
 }
 
 WaveClip* WaveTrack::GetClipAtX(int xcoord)
@@ -2059,39 +2177,58 @@ WaveClip* WaveTrack::GetClipAtX(int xcoord)
 
 WaveClip* WaveTrack::GetClipAtSample(sampleCount sample)
 {
-   for (const auto &clip: mClips)
+   WaveClip *result = NULL;
+   GetClipIndex()->VisitSamples(sample, sample + 1, [&](WaveClip *clip)
    {
-      auto start = clip->GetStartSample();
-      auto len   = clip->GetNumSamples();
-
-      if (sample >= start && sample < start + len)
-         return clip.get();
-   }
+      if (!result)
+         result = clip;
+   });
 
-   return NULL;
+   return result;
 }
 
 // When the time is both the end of a clip and the start of the next clip, the
 // latter clip is returned.
 WaveClip* WaveTrack::GetClipAtTime(double time)
 {
-   
-   const auto clips = SortedClipArray();
-   auto p = std::find_if(clips.rbegin(), clips.rend(), [&] (WaveClip* const& clip) {
-      return time >= clip->GetStartTime() && time <= clip->GetEndTime(); });
+   const auto index = GetClipIndex();
+   const auto &entries = index->entries;
+
+   // Find the last clip, in order of start time, that contains the time,
+   // searching back from the last clip that starts at or before it
+   auto p = std::upper_bound(entries.begin(), entries.end(), time,
+      [](double t, const ClipIndex::Entry &entry){ return t < entry.startTime; });
+   auto found = entries.end();
+   bool stopping = false;
+   double stop = 0;
+   while (p != entries.begin()) {
+      --p;
+      if (stopping && p->startTime < stop)
+         break;
+      if (time <= p->clip->GetEndTime()) {
+         found = p;
+         break;
+      }
+      // Only clips starting with this one may still contain the time
+      if (!stopping && p->maxEndTimeBefore < time)
+         stopping = true, stop = p->startTime;
+   }
+   if (found == entries.end())
+      return nullptr;
 
    // When two clips are immediately next to each other, the GetEndTime() of the first clip
    // and the GetStartTime() of the second clip may not be exactly equal due to rounding errors.
    // If "time" is the end time of the first of two such clips, and the end time is slightly
    // less than the start time of the second clip, then the first rather than the
    // second clip is found by the above code. So correct this.
-   if (p != clips.rend() && p != clips.rbegin() &&
-      time == (*p)->GetEndTime() &&
-      (*p)->SharesBoundaryWithNextClip(*(p-1))) {
-      p--;
+   auto next = found + 1;
+   if (next != entries.end() &&
+      time == found->clip->GetEndTime() &&
+      found->clip->SharesBoundaryWithNextClip(next->clip)) {
+      found = next;
    }
 
-   return p != clips.rend() ? *p : nullptr;
+   return found->clip;
 }
 
 Envelope* WaveTrack::GetEnvelopeAtX(int xcoord)
@@ -2112,9 +2249,17 @@ Sequence* WaveTrack::GetSequenceAtX(int xcoord)
       return NULL;
 }
 
+void WaveTrack::PushClip(WaveClipHolder &&clip)
+// NOFAIL-GUARANTEE
+{
+   clip->SetLayoutGeneration(mLayoutGeneration);
+   mClips.push_back(std::move(clip));
+   NoteLayoutChange();
+}
+
 WaveClip* WaveTrack::CreateClip()
 {
-   mClips.push_back(std::make_unique<WaveClip>(mDirManager, mFormat, mRate, GetWaveColorIndex()));
+   PushClip(std::make_unique<WaveClip>(mDirManager, mFormat, mRate, GetWaveColorIndex()));
    return mClips.back().get();
 }
 
@@ -2184,29 +2329,35 @@ bool WaveTrack::CanOffsetClip(WaveClip* clip, double amount,
    if (allowedAmount)
       *allowedAmount = amount;
 
-   for (const auto &c: mClips)
+   bool overlaps = false;
+   GetClipIndex()->VisitTimes(
+      clip->GetStartTime()+amount, clip->GetEndTime()+amount,
+      [&](const WaveClip *c)
    {
-      if (c.get() != clip && c->GetStartTime() < clip->GetEndTime()+amount &&
-                       c->GetEndTime() > clip->GetStartTime()+amount)
-      {
-         if (!allowedAmount)
-            return false; // clips overlap
+      if (c == clip)
+         return;
 
-         if (amount > 0)
-         {
-            if (c->GetStartTime()-clip->GetEndTime() < *allowedAmount)
-               *allowedAmount = c->GetStartTime()-clip->GetEndTime();
-            if (*allowedAmount < 0)
-               *allowedAmount = 0;
-         } else
-         {
-            if (c->GetEndTime()-clip->GetStartTime() > *allowedAmount)
-               *allowedAmount = c->GetEndTime()-clip->GetStartTime();
-            if (*allowedAmount > 0)
-               *allowedAmount = 0;
-         }
+      overlaps = true;
+      if (!allowedAmount)
+         return;
+
+      if (amount > 0)
+      {
+         if (c->GetStartTime()-clip->GetEndTime() < *allowedAmount)
+            *allowedAmount = c->GetStartTime()-clip->GetEndTime();
+         if (*allowedAmount < 0)
+            *allowedAmount = 0;
+      } else
+      {
+         if (c->GetEndTime()-clip->GetStartTime() > *allowedAmount)
+            *allowedAmount = c->GetEndTime()-clip->GetStartTime();
+         if (*allowedAmount > 0)
+            *allowedAmount = 0;
       }
-   }
+   });
+
+   if (overlaps && !allowedAmount)
+      return false; // clips overlap
 
    if (allowedAmount)
    {
@@ -2283,7 +2434,7 @@ void WaveTrack::SplitAt(double t)
          newClip->Offset(here.as_double()/(double)mRate);
          // This could invalidate the iterators for the loop!  But we return
          // at once so it's okay
-         mClips.push_back(std::move(newClip)); // transfer ownership
+         PushClip(std::move(newClip)); // transfer ownership
          return;
       }
    }
@@ -2433,6 +2584,7 @@ void WaveTrack::MergeClips(int clipidx1, int clipidx2)
    // Delete second clip
    auto it = FindClip(mClips, clip2);
    mClips.erase(it);
+   NoteLayoutChange();
 }
 
 void WaveTrack::Resample(int rate, ProgressDialog *progress)
@@ -2445,28 +2597,20 @@ void WaveTrack::Resample(int rate, ProgressDialog *progress)
    mRate = rate;
 }
 
-namespace {
-   template < typename Cont1, typename Cont2 >
-   Cont1 FillSortedClipArray(const Cont2& mClips)
-   {
-      Cont1 clips;
-      for (const auto &clip : mClips)
-         clips.push_back(clip.get());
-      std::sort(clips.begin(), clips.end(),
-         [](const WaveClip *a, const WaveClip *b)
-      { return a->GetStartTime() < b->GetStartTime(); });
-      return clips;
-   }
-}
-
 WaveClipPointers WaveTrack::SortedClipArray()
 {
-   return FillSortedClipArray<WaveClipPointers>(mClips);
+   WaveClipPointers clips;
+   const auto index = GetClipIndex();
+   clips.reserve(index->entries.size());
+   for (const auto &entry : index->entries)
+      clips.push_back(entry.clip);
+   return clips;
 }
 
 WaveClipConstPointers WaveTrack::SortedClipArray() const
 {
-   return FillSortedClipArray<WaveClipConstPointers>(mClips);
+   auto clips = const_cast<WaveTrack&>(*this).SortedClipArray();
+   return { clips.begin(), clips.end() };
 }
 
 ///Deletes all clips' wavecaches.  Careful, This may not be threadsafe.
@@ -2500,19 +2644,8 @@ WaveTrackCache::~WaveTrackCache()
 void WaveTrackCache::SetTrack(const std::shared_ptr<const WaveTrack> &pTrack)
 {
    if (mPTrack != pTrack) {
-      if (pTrack) {
-         mBufferSize = pTrack->GetMaxBlockSize();
-         if (!mPTrack ||
-             mPTrack->GetMaxBlockSize() != mBufferSize) {
-            Free();
-            mBuffers[0].data = Floats{ mBufferSize };
-            mBuffers[1].data = Floats{ mBufferSize };
-         }
-      }
-      else
-         Free();
+      Free();
       mPTrack = pTrack;
-      mNValidBuffers = 0;
    }
 }
 
@@ -2522,156 +2655,62 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
    if (format == floatSample && len > 0) {
       const auto end = start + len;
 
-      bool fillFirst = (mNValidBuffers < 1);
-      bool fillSecond = (mNValidBuffers < 2);
-
-      // Discard cached results that we no longer need
-      if (mNValidBuffers > 0 &&
-          (end <= mBuffers[0].start ||
-           start >= mBuffers[mNValidBuffers - 1].end())) {
-         // Complete miss
-         fillFirst = true;
-         fillSecond = true;
-      }
-      else if (mNValidBuffers == 2 &&
-               start >= mBuffers[1].start &&
-               end > mBuffers[1].end()) {
-         // Request starts in the second buffer and extends past it.
-         // Discard the first buffer.
-         // (But don't deallocate the buffer space.)
-         mBuffers[0] .swap ( mBuffers[1] );
-         fillSecond = true;
-         mNValidBuffers = 1;
-      }
-      else if (mNValidBuffers > 0 &&
-         start < mBuffers[0].start &&
-         0 <= mPTrack->GetBlockStart(start)) {
-         // Request is not a total miss but starts before the cache,
-         // and there is a clip to fetch from.
-         // Not the access pattern for drawing spectrogram or playback,
-         // but maybe scrubbing causes this.
-         // Move the first buffer into second place, and later
-         // refill the first.
-         // (This case might be useful when marching backwards through
-         // the track, as with scrubbing.)
-         mBuffers[0] .swap ( mBuffers[1] );
-         fillFirst = true;
-         fillSecond = false;
-         // Cache is not in a consistent state yet
-         mNValidBuffers = 0;
-      }
-
-      // Refill buffers as needed
-      if (fillFirst) {
-         const auto start0 = mPTrack->GetBlockStart(start);
-         if (start0 >= 0) {
-            const auto len0 = mPTrack->GetBestBlockSize(start0);
-            wxASSERT(len0 <= mBufferSize);
-            if (!mPTrack->Get(
-                  samplePtr(mBuffers[0].data.get()), floatSample, start0, len0,
-                  fillZero, mayThrow))
-               return 0;
-            mBuffers[0].start = start0;
-            mBuffers[0].len = len0;
-            if (!fillSecond &&
-                mBuffers[0].end() != mBuffers[1].start)
-               fillSecond = true;
-            // Keep the partially updated state consistent:
-            mNValidBuffers = fillSecond ? 1 : 2;
+      // Collect the blocks overlapping the request, keeping those of the
+      // previous request, and finding the others in the shared cache
+      mNewBuffers.clear();
+      auto pos = start;
+      while (pos < end) {
+         auto iter = std::find_if(mBuffers.begin(), mBuffers.end(),
+            [&](const Buffer &buffer)
+            { return buffer.start <= pos && pos < buffer.end(); });
+         if (iter != mBuffers.end()) {
+            mNewBuffers.push_back(*iter);
+            pos = iter->end();
+            continue;
          }
-         else {
+
+         sampleCount blockStart;
+         const auto pBlock = mPTrack->GetBlockAt(pos, blockStart);
+         if (!pBlock) {
             // Request may fall between the clips of a track.
-            // Invalidate all.  WaveTrack::Get() will return zeroes.
-            mNValidBuffers = 0;
-            fillSecond = false;
-         }
-      }
-      wxASSERT(!fillSecond || mNValidBuffers > 0);
-      if (fillSecond) {
-         mNValidBuffers = 1;
-         const auto end0 = mBuffers[0].end();
-         if (end > end0) {
-            const auto start1 = mPTrack->GetBlockStart(end0);
-            if (start1 == end0) {
-               const auto len1 = mPTrack->GetBestBlockSize(start1);
-               wxASSERT(len1 <= mBufferSize);
-               if (!mPTrack->Get(samplePtr(mBuffers[1].data.get()), floatSample, start1, len1, fillZero, mayThrow))
-                  return 0;
-               mBuffers[1].start = start1;
-               mBuffers[1].len = len1;
-               mNValidBuffers = 2;
-            }
+            // Skip to the next clip, leaving zeroes.
+            if (blockStart < 0)
+               break;
+            pos = blockStart;
+            continue;
          }
-      }
-      wxASSERT(mNValidBuffers < 2 || mBuffers[0].end() == mBuffers[1].start);
-
-      samplePtr buffer = 0;
-      auto remaining = len;
-
-      // Possibly get an initial portion that is uncached
 
-      // This may be negative
-      const auto initLen =
-         mNValidBuffers < 1 ? sampleCount( len )
-            : std::min(sampleCount( len ), mBuffers[0].start - start);
-
-      if (initLen > 0) {
-         // This might be fetching zeroes between clips
-         mOverlapBuffer.Resize(len, format);
-         // initLen is not more than len:
-         auto sinitLen = initLen.as_size_t();
-         if (!mPTrack->Get(mOverlapBuffer.ptr(), format, start, sinitLen,
-                           fillZero, mayThrow))
+         auto data = BlockCache::Get().Read(pBlock, mayThrow);
+         if (!data)
             return 0;
-         wxASSERT( sinitLen <= remaining );
-         remaining -= sinitLen;
-         start += initLen;
-         buffer = mOverlapBuffer.ptr() + sinitLen * SAMPLE_SIZE(format);
+         mNewBuffers.push_back({ std::move(data), blockStart, pBlock->GetLength() });
+         pos = mNewBuffers.back().end();
       }
-
-      // Now satisfy the request from the buffers
-      for (int ii = 0; ii < mNValidBuffers && remaining > 0; ++ii) {
-         const auto starti = start - mBuffers[ii].start;
-         // Treatment of initLen above establishes this loop invariant,
-         // and statements below preserve it:
-         wxASSERT(starti >= 0);
-
-         // This may be negative
-         const auto leni =
-            std::min( sampleCount( remaining ), mBuffers[ii].len - starti );
-         if (initLen <= 0 && leni == len) {
-            // All is contiguous already.  We can completely avoid copying
-            // leni is nonnegative, therefore start falls within mBuffers[ii],
-            // so starti is bounded between 0 and buffer length
-            return samplePtr(mBuffers[ii].data.get() + starti.as_size_t() );
-         }
-         else if (leni > 0) {
-            // leni is nonnegative, therefore start falls within mBuffers[ii]
-            // But we can't satisfy all from one buffer, so copy
-            if (buffer == 0) {
-               mOverlapBuffer.Resize(len, format);
-               buffer = mOverlapBuffer.ptr();
-            }
-            // leni is positive and not more than remaining
-            const size_t size = sizeof(float) * leni.as_size_t();
-            // starti is less than mBuffers[ii].len and nonnegative
-            memcpy(buffer, mBuffers[ii].data.get() + starti.as_size_t(), size);
-            wxASSERT( leni <= remaining );
-            remaining -= leni.as_size_t();
-            start += leni;
-            buffer += size;
-         }
-      }
-
-      if (remaining > 0) {
-         // Very big request!
-         // Fall back to direct fetch
-         if (buffer == 0) {
-            mOverlapBuffer.Resize(len, format);
-            buffer = mOverlapBuffer.ptr();
-         }
-         if (!mPTrack->Get(buffer, format, start, remaining, fillZero, mayThrow))
-            return 0;
+      mBuffers.swap(mNewBuffers);
+      mNewBuffers.clear();
+
+      if (mBuffers.size() == 1 &&
+          mBuffers[0].start <= start && end <= mBuffers[0].end())
+         // All is contiguous already.  We can completely avoid copying,
+         // pointing into the shared block.
+         return samplePtr(
+            mBuffers[0].data->get() + (start - mBuffers[0].start).as_size_t());
+
+      // Copy the overlapping parts of the blocks, with zeroes between clips
+      mOverlapBuffer.Resize(len, format);
+      const auto buffer = reinterpret_cast<float*>(mOverlapBuffer.ptr());
+      size_t covered = 0;
+      for (const auto &block : mBuffers)
+         covered += (std::min(end, block.end()) - std::max(start, block.start))
+            .as_size_t();
+      if (covered < len)
+         ClearSamples(mOverlapBuffer.ptr(), format, 0, len);
+      for (const auto &block : mBuffers) {
+         const auto s0 = std::max(start, block.start);
+         const auto s1 = std::min(end, block.end());
+         memcpy(buffer + (s0 - start).as_size_t(),
+                block.data->get() + (s0 - block.start).as_size_t(),
+                sizeof(float) * (s1 - s0).as_size_t());
       }
 
       return mOverlapBuffer.ptr();
@@ -2687,10 +2726,9 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
 
 void WaveTrackCache::Free()
 {
-   mBuffers[0].Free();
-   mBuffers[1].Free();
+   mBuffers.clear();
+   mNewBuffers.clear();
    mOverlapBuffer.Free();
-   mNValidBuffers = 0;
 }
 
 auto WaveTrack::AllClipsIterator::operator ++ () -> AllClipsIterator &
@@ -13,10 +13,12 @@
 
 #include "Track.h"
 
+#include <atomic>
 #include <vector>
 #include <wx/longlong.h>
 
 #include "WaveTrackLocation.h"
+#include "BlockCache.h"
 
 class ProgressDialog;
 
@@ -273,6 +275,11 @@ private:
    // This returns a possibly large or negative value
    sampleCount GetBlockStart(sampleCount t) const;
 
+   // Returns the block file holding sample s, and sets start to the track
+   // position of its first sample.  Between clips, returns null and sets
+   // start to the first sample of the next clip, or negative if none follows.
+   BlockFilePtr GetBlockAt(sampleCount s, sampleCount &start) const;
+
    // These return a nonnegative number of samples meant to size a memory buffer
    size_t GetBestBlockSize(sampleCount t) const;
    size_t GetMaxBlockSize() const;
@@ -581,6 +588,23 @@ private:
    wxCriticalSection mFlushCriticalSection;
    wxCriticalSection mAppendCriticalSection;
    double mLegacyProjectFileOffset;
+
+   // Clips sorted by start time, for lookups by time or sample that cost
+   // in proportion to the number of clips found rather than the number in
+   // the track.  Rebuilt when clips are added, removed, moved or resized,
+   // but not when the rightmost clip only grows, as in recording.
+   struct ClipIndex;
+   std::shared_ptr<const ClipIndex> GetClipIndex() const;
+   mutable wxCriticalSection mClipIndexCriticalSection;
+   mutable std::shared_ptr<const ClipIndex> mClipIndex;
+   const std::shared_ptr< std::atomic<unsigned long> > mLayoutGeneration{
+      std::make_shared< std::atomic<unsigned long> >( 0ul ) };
+
+   // Adds a clip that will count its changes in mLayoutGeneration
+   void PushClip(WaveClipHolder &&clip); // NOFAIL-GUARANTEE
+   void NoteLayoutChange() // NOFAIL-GUARANTEE
+      { ++*mLayoutGeneration; }
+
    int mAutoSaveIdent;
 
    std::unique_ptr<SpectrogramSettings> mpSpectrumSettings;
@@ -590,20 +614,17 @@ private:
 // This is meant to be a short-lived object, during whose lifetime,
 // the contents of the WaveTrack are known not to change.  It can replace
 // repeated calls to WaveTrack::Get() (each of which opens and closes at least
-// one block file).
+// one block file).  Float samples come from the process-wide BlockCache, so
+// that all caches reading the same blocks share one read and conversion.
 class WaveTrackCache {
 public:
    WaveTrackCache()
-      : mBufferSize(0)
-      , mOverlapBuffer()
-      , mNValidBuffers(0)
+      : mOverlapBuffer()
    {
    }
 
    explicit WaveTrackCache(const std::shared_ptr<const WaveTrack> &pTrack)
-      : mBufferSize(0)
-      , mOverlapBuffer()
-      , mNValidBuffers(0)
+      : mOverlapBuffer()
    {
       SetTrack(pTrack);
    }
@@ -622,28 +643,21 @@ public:
 private:
    void Free();
 
+   // One whole block of the track
    struct Buffer {
-      Floats data;
+      BlockCache::Samples data;
       sampleCount start;
-      sampleCount len;
+      size_t len;
 
-      Buffer() : start(0), len(0) {}
-      void Free() { data.reset(); start = 0; len = 0; }
       sampleCount end() const { return start + len; }
-
-      void swap ( Buffer &other )
-      {
-         data .swap ( other.data );
-         std::swap( start, other.start );
-         std::swap( len, other.len );
-      }
    };
 
    std::shared_ptr<const WaveTrack> mPTrack;
-   size_t mBufferSize;
-   Buffer mBuffers[2];
+   // The blocks overlapping the last request, in time order
+   std::vector<Buffer> mBuffers;
+   // Scratch space for collecting the blocks of the next request
+   std::vector<Buffer> mNewBuffers;
    GrowableSampleBuffer mOverlapBuffer;
-   int mNValidBuffers;
 };
 
 #endif // __AUDACITY_WAVETRACK__
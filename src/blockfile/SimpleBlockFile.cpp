@@ -427,6 +427,8 @@ void SimpleBlockFile::SaveXML(XMLWriter &xmlFile)
    xmlFile.WriteAttr(wxT("min"), mMin);
    xmlFile.WriteAttr(wxT("max"), mMax);
    xmlFile.WriteAttr(wxT("rms"), mRMS);
+   if (IsSumKnown())
+      xmlFile.WriteAttr(wxT("sum"), GetSum());
 
    xmlFile.EndTag(wxT("simpleblockfile"));
 }
@@ -441,6 +443,9 @@ BlockFilePtr SimpleBlockFile::BuildFromXML(DirManager &dm, const wxChar **attrs)
    float min = 0.0f, max = 0.0f, rms = 0.0f;
    size_t len = 0;
    double dblValue;
+   // Optional; absent from projects of older versions
+   bool hasSum = false;
+   double sum = 0.0;
    long nValue;
 
    while(*attrs)
@@ -472,11 +477,16 @@ BlockFilePtr SimpleBlockFile::BuildFromXML(DirManager &dm, const wxChar **attrs)
             max = dblValue;
          else if (!wxStricmp(attr, wxT("rms")) && (dblValue >= 0.0))
             rms = dblValue;
+         else if (!wxStricmp(attr, wxT("sum")))
+            hasSum = true, sum = dblValue;
       }
    }
 
-   return make_blockfile<SimpleBlockFile>
+   auto result = make_blockfile<SimpleBlockFile>
       (std::move(fileName), len, min, max, rms);
+   if (hasSum)
+      result->SetSum(sum);
+   return result;
 }
 
 /// Create a copy of this BlockFile, but using a different disk file.
@@ -486,6 +496,8 @@ BlockFilePtr SimpleBlockFile::Copy(wxFileNameWrapper &&newFileName)
 {
    auto newBlockFile = make_blockfile<SimpleBlockFile>
       (std::move(newFileName), mLen, mMin, mMax, mRMS);
+   if (IsSumKnown())
+      newBlockFile->SetSum(GetSum());
 
    return newBlockFile;
 }
@@ -34,7 +34,7 @@ AppCommandEvent::AppCommandEvent(wxEventType commandType, int id)
 // Copy constructor
 AppCommandEvent::AppCommandEvent(const AppCommandEvent &event)
    : wxCommandEvent(event)
-   , mCommand(event.mCommand)
+   , mCommands(event.mCommands)
 {
 }
 
@@ -51,11 +51,18 @@ wxEvent *AppCommandEvent::Clone() const
 /// Store a pointer to a command object
 void AppCommandEvent::SetCommand(const OldStyleCommandPointer &cmd)
 {
-   wxASSERT(!mCommand);
-   mCommand = cmd;
+   wxASSERT(mCommands.empty());
+   mCommands = { cmd };
 }
 
-OldStyleCommandPointer AppCommandEvent::GetCommand()
+/// Store pointers to several command objects
+void AppCommandEvent::SetCommands(OldStyleCommandPointers cmds)
 {
-   return mCommand;
+   wxASSERT(mCommands.empty());
+   mCommands = std::move(cmds);
+}
+
+const OldStyleCommandPointers &AppCommandEvent::GetCommands() const
+{
+   return mCommands;
 }
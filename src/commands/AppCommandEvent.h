@@ -23,13 +23,16 @@
 
 DECLARE_EXPORTED_EVENT_TYPE(AUDACITY_DLL_API, wxEVT_APP_COMMAND_RECEIVED, -1);
 
+#include <vector>
+
 class OldStyleCommand;
 using OldStyleCommandPointer = std::shared_ptr<OldStyleCommand>;
+using OldStyleCommandPointers = std::vector<OldStyleCommandPointer>;
 
 class AppCommandEvent final : public wxCommandEvent
 {
 private:
-   OldStyleCommandPointer mCommand;
+   OldStyleCommandPointers mCommands;
 
 public:
    AppCommandEvent(wxEventType commandType = wxEVT_APP_COMMAND_RECEIVED, int id = 0);
@@ -39,7 +42,9 @@ public:
 
    wxEvent *Clone() const override;
    void SetCommand(const OldStyleCommandPointer &cmd);
-   OldStyleCommandPointer GetCommand();
+   // A batch of commands, to be applied in order in one dispatch
+   void SetCommands(OldStyleCommandPointers cmds);
+   const OldStyleCommandPointers &GetCommands() const;
 
 private:
    DECLARE_DYNAMIC_CLASS(AppCommandEvent)
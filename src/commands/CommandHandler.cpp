@@ -42,23 +42,30 @@ void CommandHandler::SetProject(AudacityProject *)
 
 void CommandHandler::OnReceiveCommand(AppCommandEvent &event)
 {
-   // First retrieve the actual command from the event 'envelope'.
-   OldStyleCommandPointer cmd = event.GetCommand();
+   // First retrieve the actual commands from the event 'envelope'.
+   // A scripting client may send a batch, applied in order.
+   const auto &cmds = event.GetCommands();
+   if (cmds.empty())
+      return;
 
-   // JKC: In case the user changed the project, let us track that.
-   // This saves us the embarrassment (crash) of a NEW project
-   // being opened, the old one closed and still trying to act
-   // on the old one.
-   SetProject( GetActiveProject() );
-   // Then apply it to current application & project.  Note that the
-   // command may change the context - for example, switching to a
-   // different project.
-   CommandContext context{ *GetActiveProject() };
-   auto result = GuardedCall<bool>( [&] {
-      return cmd->Apply( context );
-   });
-   wxUnusedVar(result);
+   AudacityProject *pProject = nullptr;
+   for (const auto &cmd : cmds) {
+      // JKC: In case the user changed the project, let us track that.
+      // This saves us the embarrassment (crash) of a NEW project
+      // being opened, the old one closed and still trying to act
+      // on the old one.
+      SetProject( GetActiveProject() );
+      // Then apply it to current application & project.  Note that the
+      // command may change the context - for example, switching to a
+      // different project.
+      CommandContext context{ *GetActiveProject() };
+      auto result = GuardedCall<bool>( [&] {
+         return cmd->Apply( context );
+      });
+      wxUnusedVar(result);
+      pProject = &context.project;
+   }
 
-   // Redraw the project
-   ProjectWindow::Get( context.project ).RedrawProject();
+   // Redraw the project, once for the whole batch
+   ProjectWindow::Get( *pProject ).RedrawProject();
 }
@@ -17,12 +17,14 @@ This class now lists
 - Clips
 - Labels
 - Boxes
+- AudioHealth
 
 *//*******************************************************************/
 
 #include "../Audacity.h" // for USE_* macros
 #include "GetInfoCommand.h"
 
+#include "../AudioIO.h"
 #include "../Project.h"
 #include "CommandManager.h"
 #include "CommandTargets.h"
@@ -60,6 +62,7 @@ enum {
    kEnvelopes,
    kLabels,
    kBoxes,
+   kAudioHealth,
    nTypes
 };
 
@@ -74,6 +77,7 @@ static const EnumValueSymbol kTypes[nTypes] =
    { XO("Envelopes") },
    { XO("Labels") },
    { XO("Boxes") },
+   { wxT("AudioHealth"), XO("Audio Health") },
 };
 
 enum {
@@ -154,12 +158,52 @@ bool GetInfoCommand::ApplyInner(const CommandContext &context)
       case kEnvelopes    : return SendEnvelopes( context );
       case kLabels       : return SendLabels( context );
       case kBoxes        : return SendBoxes( context );
+      case kAudioHealth  : return SendAudioHealth( context );
       default:
          context.Status( "Command options not recognised" );
    }
    return false;
 }
 
+bool GetInfoCommand::SendAudioHealth(const CommandContext &context)
+{
+   auto gAudioIO = AudioIO::Get();
+   if (!gAudioIO)
+      return false;
+   const auto &health = gAudioIO->mHealth;
+
+   context.StartStruct();
+   context.AddItem( (double)health.mCallbacks.load(), "callbacks" );
+   context.AddItem( (double)health.mLateCallbacks.load(), "late" );
+   context.AddItem( (double)health.mOutputUnderflows.load(), "underflows" );
+   context.AddItem( (double)health.mInputOverflows.load(), "overflows" );
+   health.VisitHistograms( [&]( const wxString &name, const wxString &unit,
+      const HealthHistogram &histogram ) {
+      context.StartField( name );
+      context.StartStruct();
+      context.AddItem( unit, "unit" );
+      context.AddItem( (double)histogram.Total(), "count" );
+      context.AddItem( histogram.Mean(), "mean" );
+      context.AddItem( histogram.Max(), "max" );
+      context.StartField( "bins" );
+      context.StartArray();
+      for ( size_t bin = 0; bin < histogram.NumBins(); ++bin ) {
+         context.StartStruct();
+         // The last bin has no upper edge
+         if ( bin + 1 < histogram.NumBins() )
+            context.AddItem( histogram.UpperEdge( bin ), "upper" );
+         context.AddItem( (double)histogram.Count( bin ), "count" );
+         context.EndStruct();
+      }
+      context.EndArray();
+      context.EndField();
+      context.EndStruct();
+      context.EndField();
+   } );
+   context.EndStruct();
+   return true;
+}
+
 bool GetInfoCommand::SendMenus(const CommandContext &context)
 {
    wxMenuBar * pBar = GetProjectFrame( context.project ).GetMenuBar();
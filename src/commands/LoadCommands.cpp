@@ -28,6 +28,7 @@ modelled on BuiltinEffectsModule
 #include "../commands/GetInfoCommand.h"
 #include "../commands/HelpCommand.h"
 #include "../commands/ImportExportCommands.h"
+#include "../commands/SampleDataCommands.h"
 #include "../commands/OpenSaveCommands.h"
 #include "../commands/SetLabelCommand.h"
 #include "../commands/SetEnvelopeCommand.h"
@@ -62,6 +63,8 @@ modelled on BuiltinEffectsModule
    COMMAND( HELP,                HelpCommand, () )             \
    COMMAND( IMPORT,              ImportCommand, () )           \
    COMMAND( EXPORT,              ExportCommand, () )           \
+   COMMAND( GET_SAMPLES,         GetSamplesCommand, () )       \
+   COMMAND( SET_SAMPLES,         SetSamplesCommand, () )       \
    COMMAND( OPEN_PROJECT,        OpenProjectCommand, () )      \
    COMMAND( SAVE_PROJECT,        SaveProjectCommand, () )      \
 
@@ -0,0 +1,173 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   Copyright 1999-2019 Audacity Team
+   License: wxwidgets
+
+******************************************************************//**
+
+\file SampleDataCommands.cpp
+\brief Contains definitions for GetSamplesCommand and SetSamplesCommand
+classes
+
+*//*******************************************************************/
+
+#include "../Audacity.h"
+#include "SampleDataCommands.h"
+
+#include <wx/ffile.h>
+
+#include "../ProjectHistory.h"
+#include "../ViewInfo.h"
+#include "../WaveTrack.h"
+#include "../Shuttle.h"
+#include "../ShuttleGui.h"
+#include "CommandContext.h"
+
+namespace {
+
+// Get the selected time interval, or complain if there is none
+bool GetSelectedRegion(const CommandContext &context, double &t0, double &t1)
+{
+   auto &selectedRegion = ViewInfo::Get( context.project ).selectedRegion;
+   t0 = selectedRegion.t0();
+   t1 = selectedRegion.t1();
+   if (t0 >= t1)
+   {
+      context.Error(wxT("There is no selection!"));
+      return false;
+   }
+   return true;
+}
+
+}
+
+bool GetSamplesCommand::DefineParams( ShuttleParams & S ){
+   S.Define( mFileName, wxT("Filename"),  "" );
+   return true;
+}
+
+void GetSamplesCommand::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.TieTextBox(_("File Name:"),mFileName);
+   }
+   S.EndMultiColumn();
+}
+
+bool GetSamplesCommand::Apply(const CommandContext & context)
+{
+   double t0, t1;
+   if (!GetSelectedRegion(context, t0, t1))
+      return false;
+
+   wxFFile file(mFileName, wxT("wb"));
+   if (!file.IsOpened())
+   {
+      context.Error(wxString::Format(wxT("Could not open %s for writing!"), mFileName));
+      return false;
+   }
+
+   auto &tracks = TrackList::Get( context.project );
+   for (auto track : tracks.Selected< const WaveTrack >())
+   {
+      Floats buffer{ track->GetMaxBlockSize() };
+
+      auto s0 = track->TimeToLongSamples(t0);
+      auto s1 = track->TimeToLongSamples(t1);
+      for (auto position = s0; position < s1;)
+      {
+         auto block = limitSampleBufferSize(
+            track->GetBestBlockSize(position), s1 - position
+         );
+         track->Get((samplePtr)buffer.get(), floatSample, position, block);
+         if (file.Write(buffer.get(), block * sizeof(float)) != block * sizeof(float))
+         {
+            context.Error(wxString::Format(wxT("Could not write to %s!"), mFileName));
+            return false;
+         }
+         position += block;
+      }
+
+      context.Status(wxString::Format(wxT("%s: %lld samples"),
+         track->GetName(), (s1 - s0).as_long_long()));
+   }
+
+   return file.Close();
+}
+
+bool SetSamplesCommand::DefineParams( ShuttleParams & S ){
+   S.Define( mFileName, wxT("Filename"),  "" );
+   return true;
+}
+
+void SetSamplesCommand::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.TieTextBox(_("File Name:"),mFileName);
+   }
+   S.EndMultiColumn();
+}
+
+bool SetSamplesCommand::Apply(const CommandContext & context)
+{
+   double t0, t1;
+   if (!GetSelectedRegion(context, t0, t1))
+      return false;
+
+   wxFFile file(mFileName, wxT("rb"));
+   if (!file.IsOpened())
+   {
+      context.Error(wxString::Format(wxT("Could not open %s for reading!"), mFileName));
+      return false;
+   }
+
+   auto &tracks = TrackList::Get( context.project );
+
+   // Check the whole file before changing any track
+   sampleCount total = 0;
+   for (auto track : tracks.Selected< const WaveTrack >())
+      total += track->TimeToLongSamples(t1) - track->TimeToLongSamples(t0);
+   if (file.Length() < total.as_long_long() * (wxFileOffset)sizeof(float))
+   {
+      context.Error(wxString::Format(wxT("%s is too short for the selection!"), mFileName));
+      return false;
+   }
+
+   for (auto track : tracks.Selected< WaveTrack >())
+   {
+      Floats buffer{ track->GetMaxBlockSize() };
+
+      auto s0 = track->TimeToLongSamples(t0);
+      auto s1 = track->TimeToLongSamples(t1);
+      for (auto position = s0; position < s1;)
+      {
+         auto block = limitSampleBufferSize(
+            track->GetBestBlockSize(position), s1 - position
+         );
+         if (file.Read(buffer.get(), block * sizeof(float)) != block * sizeof(float))
+         {
+            context.Error(wxString::Format(wxT("Could not read from %s!"), mFileName));
+            // Discard what was already written to the tracks
+            ProjectHistory::Get( context.project ).RollbackState();
+            return false;
+         }
+         track->Set((samplePtr)buffer.get(), floatSample, position, block);
+         position += block;
+      }
+
+      context.Status(wxString::Format(wxT("%s: %lld samples"),
+         track->GetName(), (s1 - s0).as_long_long()));
+   }
+
+   ProjectHistory::Get( context.project )
+      .PushState(_("Set samples"), _("Set Samples"));
+
+   return true;
+}
@@ -0,0 +1,68 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   Copyright 1999-2019 Audacity Team
+   License: wxwidgets
+
+******************************************************************//**
+
+\file SampleDataCommands.h
+\brief Declarations of GetSamplesCommand and SetSamplesCommand classes
+
+\class GetSamplesCommand
+\brief Command for writing the raw samples of the selection to a file
+
+\class SetSamplesCommand
+\brief Command for replacing the samples of the selection from a file
+
+*//*******************************************************************/
+
+#ifndef __SAMPLEDATACOMMANDS__
+#define __SAMPLEDATACOMMANDS__
+
+#include "Command.h"
+#include "CommandType.h"
+
+// The file layout is the same for both commands:  for each selected wave
+// track channel, in track order, the samples of the selected region as
+// native-endian 32 bit floats.  No header is written; the caller knows the
+// selection and the channels it asked for.  Pointing the file at a tmpfs
+// (such as /dev/shm) keeps the transfer in memory.
+
+#define GET_SAMPLES_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Get Samples") }
+
+class GetSamplesCommand : public AudacityCommand
+{
+public:
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return GET_SAMPLES_PLUGIN_SYMBOL;};
+   wxString GetDescription() override {return _("Writes the selected samples to a file.");};
+   bool DefineParams( ShuttleParams & S ) override;
+   void PopulateOrExchange(ShuttleGui & S) override;
+   bool Apply(const CommandContext & context) override;
+
+   // AudacityCommand overrides
+   wxString ManualPage() override {return wxT("Extra_Menu:_Scriptables_II");};
+public:
+   wxString mFileName;
+};
+
+#define SET_SAMPLES_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Set Samples") }
+
+class SetSamplesCommand : public AudacityCommand
+{
+public:
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return SET_SAMPLES_PLUGIN_SYMBOL;};
+   wxString GetDescription() override {return _("Replaces the selected samples from a file.");};
+   bool DefineParams( ShuttleParams & S ) override;
+   void PopulateOrExchange(ShuttleGui & S) override;
+   bool Apply(const CommandContext & context) override;
+
+   // AudacityCommand overrides
+   wxString ManualPage() override {return wxT("Extra_Menu:_Scriptables_II");};
+public:
+   wxString mFileName;
+};
+
+#endif /* End of include guard: __SAMPLEDATACOMMANDS__ */
@@ -27,6 +27,7 @@ code out of ModuleManager.
 #include <wx/app.h>
 #include <wx/window.h>
 #include <wx/string.h>
+#include <wx/tokenzr.h>
 
 // Declare static class members
 CommandHandler *ScriptCommandRelay::sCmdHandler;
@@ -63,36 +64,75 @@ void ScriptCommandRelay::PostCommand(
    }
 }
 
-/// This is the function which actually obeys one command.  Rather than applying
-/// the command directly, an event containing a reference to the command is sent
-/// to the main (GUI) thread. This is because having more than one thread access
-/// the GUI at a time causes problems with wxwidgets.
+/// Send a batch of commands to a project, to be applied in order in one
+/// dispatch of the main thread
+void ScriptCommandRelay::PostCommands(
+   wxWindow *pWindow, std::vector<OldStyleCommandPointer> cmds)
+{
+   wxASSERT( pWindow );
+   if ( pWindow && !cmds.empty() ) {
+      AppCommandEvent ev;
+      ev.SetCommands(std::move(cmds));
+      pWindow->GetEventHandler()->AddPendingEvent(ev);
+   }
+}
+
+/// This is the function which actually obeys commands.  Rather than applying
+/// the commands directly, an event containing references to the commands is
+/// sent to the main (GUI) thread. This is because having more than one thread
+/// access the GUI at a time causes problems with wxwidgets.
+/// pIn may hold several commands, one per line.  They are all sent in one
+/// event, so that a batch costs one round trip to the main thread, and the
+/// responses are returned in order, each ended by an empty line as if the
+/// commands had been sent one at a time.
 int ExecCommand(wxString *pIn, wxString *pOut)
 {
+   struct Entry {
+      bool valid;
+      wxString error;
+   };
+   std::vector<Entry> entries;
+   std::vector<OldStyleCommandPointer> cmds;
+
+   wxStringTokenizer lines(*pIn, wxT("\r\n"), wxTOKEN_STRTOK);
+   while (lines.HasMoreTokens())
    {
-      CommandBuilder builder(*pIn);
+      CommandBuilder builder(lines.GetNextToken());
       if (builder.WasValid())
       {
-         OldStyleCommandPointer cmd = builder.GetCommand();
-         ScriptCommandRelay::PostCommand(wxTheApp->GetTopWindow(), cmd);
-
-         *pOut = wxEmptyString;
+         cmds.push_back(builder.GetCommand());
+         entries.push_back({ true, {} });
       }
       else
-      {
-         *pOut = wxT("Syntax error!\n");
-         *pOut += builder.GetErrorMessage() + wxT("\n");
-      }
+         entries.push_back({ false,
+            wxT("Syntax error!\n") + builder.GetErrorMessage() + wxT("\n") });
    }
 
-   // Wait until all responses from the command have been received.
-   // The last response is signalled by an empty line.
-   wxString msg = ScriptCommandRelay::ReceiveResponse().GetMessage();
-   while (msg != wxT("\n"))
+   ScriptCommandRelay::PostCommands(wxTheApp->GetTopWindow(), std::move(cmds));
+
+   *pOut = wxEmptyString;
+   for (size_t ii = 0, nn = entries.size(); ii < nn; ++ii)
    {
-      //wxLogDebug( "Msg: %s", msg );
-      *pOut += msg + wxT("\n");
-      msg = ScriptCommandRelay::ReceiveResponse().GetMessage();
+      if (ii > 0)
+         // End the previous command's response
+         *pOut += wxT("\n");
+
+      const auto &entry = entries[ii];
+      if (!entry.valid)
+      {
+         *pOut += entry.error;
+         continue;
+      }
+
+      // Wait until all responses from the command have been received.
+      // The last response is signalled by an empty line.
+      wxString msg = ScriptCommandRelay::ReceiveResponse().GetMessage();
+      while (msg != wxT("\n"))
+      {
+         //wxLogDebug( "Msg: %s", msg );
+         *pOut += msg + wxT("\n");
+         msg = ScriptCommandRelay::ReceiveResponse().GetMessage();
+      }
    }
 
    return 0;
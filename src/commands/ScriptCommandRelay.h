@@ -19,6 +19,7 @@
 #include "../Audacity.h"
 
 #include "../MemoryX.h"
+#include <vector>
 
 class wxWindow;
 class CommandHandler;
@@ -49,6 +50,8 @@ class ScriptCommandRelay
       static void Run();
       static void PostCommand(
          wxWindow *pWindow, const OldStyleCommandPointer &cmd);
+      static void PostCommands(
+         wxWindow *pWindow, std::vector<OldStyleCommandPointer> cmds);
       static Response ReceiveResponse();
 };
 
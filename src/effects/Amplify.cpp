@@ -126,6 +126,36 @@ size_t EffectAmplify::ProcessBlock(float **inBlock, float **outBlock, size_t blo
 
    return blockLen;
 }
+
+// The gain is the only state, so there is nothing to keep per processor
+bool EffectAmplify::RealtimeInitialize()
+{
+   return true;
+}
+
+bool EffectAmplify::RealtimeAddProcessor(unsigned WXUNUSED(numChannels), float WXUNUSED(sampleRate))
+{
+   return true;
+}
+
+bool EffectAmplify::RealtimeFinalize()
+{
+   return true;
+}
+
+size_t EffectAmplify::RealtimeProcess(int WXUNUSED(group),
+                                      float **inbuf,
+                                      float **outbuf,
+                                      size_t numSamples)
+{
+   return ProcessBlock(inbuf, outbuf, numSamples);
+}
+
+bool EffectAmplify::SupportsParallelProcessing()
+{
+   return true;
+}
+
 bool EffectAmplify::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mRatio, Ratio );
    if (!IsBatchProcessing())
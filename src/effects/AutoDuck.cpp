@@ -31,6 +31,7 @@
 #include "../Prefs.h"
 #include "../Shuttle.h"
 #include "../ShuttleGui.h"
+#include "../SilenceFinder.h"
 #include "../widgets/valnum.h"
 
 #include "../WaveTrack.h"
@@ -287,6 +288,9 @@ bool EffectAutoDuck::Process()
 
    double threshold = DB_TO_LINEAR(mThresholdDb);
 
+   // Windows of samples all below the threshold can't exceed it in RMS
+   SilenceFinder finder{ *mControlTrack, float(threshold) };
+
    // adjust the threshold so we can compare it to the rmsSum value
    threshold = threshold * threshold * kRMSWindowSize;
 
@@ -307,10 +311,55 @@ bool EffectAutoDuck::Process()
 
       auto pos = start;
 
+      // Samples in [skipFrom, skipTo) are known not to exceed the threshold.
+      // Samples of one window length at each end of a silent stretch are
+      // still read, so that the window holds the same values as if no
+      // samples were skipped.
+      sampleCount skipFrom = -1, skipTo = -1;
+
       while (pos < end)
       {
-         const auto len = limitSampleBufferSize( kBufSize, end - pos );
-         
+         if (pos == skipFrom)
+         {
+            const auto count = skipTo - skipFrom;
+            if (inDuckRegion)
+            {
+               // Same result as counting the pause sample by sample
+               const auto needed = minSamplesPause - curSamplesPause;
+               if (count >= needed)
+               {
+                  const auto i = pos + needed - 1;
+                  double duckRegionEnd =
+                     mControlTrack->LongSamplesToTime(i - minSamplesPause);
+
+                  regions.push_back(AutoDuckRegion(
+                     duckRegionStart - mOuterFadeDownLen,
+                     duckRegionEnd + mOuterFadeUpLen));
+
+                  inDuckRegion = false;
+                  curSamplesPause = minSamplesPause;
+               }
+               else
+                  curSamplesPause += count;
+            }
+            pos = skipTo;
+            continue;
+         }
+
+         if (pos > skipFrom)
+         {
+            const auto run = finder.Classify(pos, end);
+            if (run.kind == SilenceFinder::kSilent &&
+                run.length > 2 * kRMSWindowSize)
+            {
+               skipFrom = pos + kRMSWindowSize;
+               skipTo = pos + run.length - kRMSWindowSize;
+            }
+         }
+
+         const auto len = limitSampleBufferSize(
+            kBufSize, (pos < skipFrom ? skipFrom : end) - pos );
+
          mControlTrack->Get((samplePtr)buf.get(), floatSample, pos, len);
 
          for (auto i = pos; i < pos + len; i++)
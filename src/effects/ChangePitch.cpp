@@ -24,6 +24,7 @@ the pitch without changing the tempo.
 #include <wx/valgen.h>
 #endif
 
+#include <algorithm>
 #include <float.h>
 #include <math.h>
 
@@ -156,7 +157,79 @@ EffectType EffectChangePitch::GetType()
    return EffectTypeProcess;
 }
 
+bool EffectChangePitch::SupportsRealtime()
+{
+#if defined(EXPERIMENTAL_REALTIME_AUDACITY_EFFECTS)
+   return true;
+#else
+   return false;
+#endif
+}
+
 // EffectClientInterface implementation
+
+unsigned EffectChangePitch::GetAudioInCount()
+{
+   return 1;
+}
+
+unsigned EffectChangePitch::GetAudioOutCount()
+{
+   return 1;
+}
+
+// Only the realtime processors delay their output; report changes of that
+// delay, which is the most any of them holds back
+sampleCount EffectChangePitch::GetLatency()
+{
+   if (mSlaves.empty())
+      return 0;
+
+   size_t latency = 0;
+   for (const auto &slave : mSlaves)
+      latency = std::max(latency, slave.latency + GetBlockSize());
+
+   const auto delay = sampleCount{ latency } - mRealtimeLatency;
+   mRealtimeLatency = latency;
+   return delay;
+}
+
+bool EffectChangePitch::RealtimeInitialize()
+{
+   SetBlockSize(512);
+
+   mSlaves.clear();
+   mRealtimeLatency = 0;
+
+   return true;
+}
+
+bool EffectChangePitch::RealtimeAddProcessor(unsigned WXUNUSED(numChannels), float sampleRate)
+{
+   EffectChangePitchState slave;
+
+   InstanceInit(slave, sampleRate);
+
+   mSlaves.push_back(std::move(slave));
+
+   return true;
+}
+
+bool EffectChangePitch::RealtimeFinalize()
+{
+   mSlaves.clear();
+
+   return true;
+}
+
+size_t EffectChangePitch::RealtimeProcess(int group,
+                                               float **inbuf,
+                                               float **outbuf,
+                                               size_t numSamples)
+{
+   return InstanceProcess(mSlaves[group], inbuf, outbuf, numSamples);
+}
+
 bool EffectChangePitch::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( m_dPercentChange, Percentage );
    S.SHUTTLE_PARAM( mUseSBSMS, UseSBSMS );
@@ -201,7 +274,6 @@ bool EffectChangePitch::LoadFactoryDefaults()
 
 bool EffectChangePitch::Init()
 {
-   mSoundTouch.reset();
    return true;
 }
 
@@ -224,15 +296,13 @@ bool EffectChangePitch::Process()
       // ensure that m_dSemitonesChange is set.
       Calc_SemitonesChange_fromPercentChange();
 
-      mSoundTouch = std::make_unique<soundtouch::SoundTouch>();
       IdentityTimeWarper warper;
-      mSoundTouch->setPitchSemiTones((float)(m_dSemitonesChange));
 #ifdef USE_MIDI
       // Pitch shifting note tracks is currently only supported by SoundTouchEffect
       // and non-real-time-preview effects require an audio track selection.
       //
       // Note: m_dSemitonesChange is private to ChangePitch because it only
-      // needs to pass it along to mSoundTouch (above). I added mSemitones
+      // needs to pass it along to MakeSoundTouch(). I added mSemitones
       // to SoundTouchEffect (the super class) to convey this value
       // to process Note tracks. This approach minimizes changes to existing
       // code, but it would be cleaner to change all m_dSemitonesChange to
@@ -409,8 +479,87 @@ bool EffectChangePitch::TransferDataFromWindow()
    return true;
 }
 
+// EffectSoundTouch implementation
+
+std::unique_ptr<soundtouch::SoundTouch> EffectChangePitch::MakeSoundTouch()
+{
+   auto soundTouch = std::make_unique<soundtouch::SoundTouch>();
+   soundTouch->setPitchSemiTones((float)(m_dSemitonesChange));
+   return soundTouch;
+}
+
 // EffectChangePitch implementation
 
+void EffectChangePitch::InstanceInit(EffectChangePitchState & data, float sampleRate)
+{
+   data.semitones = m_dSemitonesChange;
+   data.soundTouch = MakeSoundTouch();
+   data.soundTouch->setSampleRate((unsigned int)(sampleRate + 0.5));
+   data.soundTouch->setChannels(1);
+   data.latency =
+      data.soundTouch->getSetting(SETTING_NOMINAL_INPUT_SEQUENCE) +
+      data.soundTouch->getSetting(SETTING_NOMINAL_OUTPUT_SEQUENCE);
+   data.primed = false;
+   // Room for the samples held back and a batch more
+   data.ready.reinit(2 * (data.latency + GetBlockSize()), true);
+   data.readyStart = 0;
+   data.readyLen = 0;
+}
+
+// The output is silent until latency samples and a block are ready, and
+// again after any block that finds too few.  A change of pitch goes to
+// SoundTouch with the next block.
+size_t EffectChangePitch::InstanceProcess(EffectChangePitchState & data,
+                                               float **inBlock,
+                                               float **outBlock,
+                                               size_t blockLen)
+{
+   float *ibuf = inBlock[0];
+   float *obuf = outBlock[0];
+
+   if (data.semitones != m_dSemitonesChange)
+   {
+      data.semitones = m_dSemitonesChange;
+      data.soundTouch->setPitchSemiTones((float)(data.semitones));
+   }
+
+   data.soundTouch->putSamples(ibuf, blockLen);
+
+   // Take as much as fits in the ring; SoundTouch keeps the rest
+   float *ready = data.ready.get();
+   const size_t capacity = 2 * (data.latency + GetBlockSize());
+   while (data.readyLen < capacity)
+   {
+      const size_t end = (data.readyStart + data.readyLen) % capacity;
+      const size_t room = std::min(capacity - data.readyLen, capacity - end);
+      const size_t received =
+         data.soundTouch->receiveSamples(ready + end, room);
+      if (received == 0)
+         break;
+      data.readyLen += received;
+   }
+
+   if (!data.primed &&
+       data.readyLen >= std::min(data.latency + blockLen, capacity))
+   {
+      data.primed = true;
+   }
+
+   size_t len = 0;
+   if (data.primed)
+   {
+      len = std::min(blockLen, data.readyLen);
+      for (size_t i = 0; i < len; i++)
+         obuf[i] = ready[(data.readyStart + i) % capacity];
+      data.readyStart = (data.readyStart + len) % capacity;
+      data.readyLen -= len;
+      data.primed = (len == blockLen);
+   }
+   std::fill(obuf + len, obuf + blockLen, 0.0f);
+
+   return blockLen;
+}
+
 // Deduce m_FromFrequency from the samples at the beginning of
 // the selection. Then set some other params accordingly.
 void EffectChangePitch::DeduceFrequencies()
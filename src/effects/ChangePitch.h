@@ -25,6 +25,8 @@ the pitch without changing the tempo.
 #include "SBSMSEffect.h"
 #endif
 
+#include <vector>
+
 #include "SoundTouchEffect.h"
 
 class wxSlider;
@@ -36,6 +38,22 @@ class ShuttleGui;
 
 #define CHANGEPITCH_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Change Pitch") }
 
+class EffectChangePitchState
+{
+public:
+   double semitones;
+   // Samples to have ready before output starts, to ride out the
+   // uneven batches in which SoundTouch gives them
+   size_t latency;
+   bool primed;
+   std::unique_ptr<soundtouch::SoundTouch> soundTouch;
+   // Samples received from soundTouch and not yet output, in a ring
+   // allocated once
+   Floats ready;
+   size_t readyStart;
+   size_t readyLen;
+};
+
 class EffectChangePitch final : public EffectSoundTouch
 {
 public:
@@ -51,9 +69,21 @@ public:
    // EffectDefinitionInterface implementation
 
    EffectType GetType() override;
+   bool SupportsRealtime() override;
 
    // EffectClientInterface implementation
 
+   unsigned GetAudioInCount() override;
+   unsigned GetAudioOutCount() override;
+   sampleCount GetLatency() override;
+   bool RealtimeInitialize() override;
+   bool RealtimeAddProcessor(unsigned numChannels, float sampleRate) override;
+   bool RealtimeFinalize() override;
+   size_t RealtimeProcess(int group,
+                               float **inbuf,
+                               float **outbuf,
+                               size_t numSamples) override;
+
    bool DefineParams( ShuttleParams & S ) override;
    bool GetAutomationParameters(CommandParameters & parms) override;
    bool SetAutomationParameters(CommandParameters & parms) override;
@@ -68,6 +98,11 @@ public:
    bool TransferDataToWindow() override;
    bool TransferDataFromWindow() override;
 
+protected:
+   // EffectSoundTouch implementation
+
+   std::unique_ptr<soundtouch::SoundTouch> MakeSoundTouch() override;
+
 private:
    // EffectChangePitch implementation
 
@@ -113,6 +148,14 @@ private:
    void Update_Slider_PercentChange(); // Update control per current m_dPercentChange.
 
 private:
+   // EffectChangePitch implementation
+
+   void InstanceInit(EffectChangePitchState & data, float sampleRate);
+   size_t InstanceProcess(EffectChangePitchState & data,
+                               float **inBlock,
+                               float **outBlock,
+                               size_t blockLen);
+
    bool mUseSBSMS;
    // effect parameters
    int    m_nFromPitch;          // per PitchIndex()
@@ -130,6 +173,10 @@ private:
 
    bool m_bLoopDetect; // Used to avoid loops in initialization and in event handling.
 
+   std::vector<EffectChangePitchState> mSlaves;
+   // Delay of the realtime processors reported by GetLatency() so far
+   sampleCount mRealtimeLatency;
+
    // controls
    wxChoice *     m_pChoice_FromPitch;
    wxSpinCtrl *   m_pSpin_FromOctave;
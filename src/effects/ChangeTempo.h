@@ -63,6 +63,11 @@ public:
    bool TransferDataToWindow() override;
    bool TransferDataFromWindow() override;
 
+protected:
+   // EffectSoundTouch implementation
+
+   std::unique_ptr<soundtouch::SoundTouch> MakeSoundTouch() override;
+
 private:
    // EffectChangeTempo implementation
 
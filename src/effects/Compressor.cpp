@@ -11,8 +11,13 @@
 *******************************************************************//**
 
 \class EffectCompressor
-\brief An Effect derived from EffectTwoPassSimpleMono
+\brief An Effect that compresses in one streaming pass, delaying its
+output by a lookahead so that the envelope can rise before loud sounds.
+A second pass applies make-up gain.  The same processing runs in
+realtime.
 
+ - It was made to stream its input, with a lookahead, so that it may
+   run in realtime.
  - Martyn Shaw made it inherit from EffectTwoPassSimpleMono 10/2005.
  - Steve Jolly made it inherit from EffectSimpleMono.
  - GUI added and implementation improved by Dominic Mazzoni, 5/11/2003.
@@ -27,6 +32,7 @@
 #include "../Audacity.h"
 #include "Compressor.h"
 
+#include <algorithm>
 #include <math.h>
 
 #include <wx/brush.h>
@@ -53,7 +59,8 @@ enum
    ID_NoiseFloor,
    ID_Ratio,
    ID_Attack,
-   ID_Decay
+   ID_Decay,
+   ID_Lookahead
 };
 
 // Define keys, defaults, minimums, and maximums for the effect parameters
@@ -66,6 +73,17 @@ Param( AttackTime,   double,  wxT("AttackTime"),    0.2,     0.1,     5.0,     1
 Param( ReleaseTime,  double,  wxT("ReleaseTime"),   1.0,     1.0,     30.0,    10  );
 Param( Normalize,    bool,    wxT("Normalize"),     true,    false,   true,    1   );
 Param( UsePeak,      bool,    wxT("UsePeak"),       false,   false,   true,    1   );
+Param( LookaheadTime,double,  wxT("LookaheadTime"), 5.0,     0.0,     5.0,     100 );
+
+// Size of the ring for the running RMS
+static const size_t CircleSize = 100;
+
+// The envelope rises from the threshold to full scale within the attack
+// time, so looking further ahead than that would change nothing
+static size_t LookaheadLength(double rate, double lookaheadTime, double attackTime)
+{
+   return (size_t) ceil(rate * std::min(lookaheadTime, attackTime + 1.0 / rate));
+}
 
 //----------------------------------------------------------------------------
 // EffectCompressor
@@ -84,11 +102,7 @@ EffectCompressor::EffectCompressor()
    mRatio = DEF_Ratio;                    // positive number > 1.0
    mNormalize = DEF_Normalize;
    mUsePeak = DEF_UsePeak;
-
-   mThreshold = 0.25;
-   mNoiseFloor = 0.01;
-   mCompression = 0.5;
-   mFollowLen = 0;
+   mLookaheadTime = DEF_LookaheadTime;    // seconds
 
    SetLinearEffectFlag(false);
 }
@@ -121,7 +135,115 @@ EffectType EffectCompressor::GetType()
    return EffectTypeProcess;
 }
 
+bool EffectCompressor::SupportsRealtime()
+{
+#if defined(EXPERIMENTAL_REALTIME_AUDACITY_EFFECTS)
+   return true;
+#else
+   return false;
+#endif
+}
+
 // EffectClientInterface implementation
+
+unsigned EffectCompressor::GetAudioInCount()
+{
+   return 1;
+}
+
+unsigned EffectCompressor::GetAudioOutCount()
+{
+   return 1;
+}
+
+sampleCount EffectCompressor::GetLatency()
+{
+   // Realtime processors report changes of the longest of their lookaheads
+   if (!mSlaves.empty())
+   {
+      size_t latency = 0;
+      for (const auto &slave : mSlaves)
+         latency = std::max(latency, slave.lookahead);
+
+      const auto delay = sampleCount{ latency } - mRealtimeLatency;
+      mRealtimeLatency = latency;
+      return delay;
+   }
+
+   // Report the lookahead once, after the first block of the track
+   auto delay = mMaster.latency;
+   mMaster.latency = 0;
+   return delay;
+}
+
+bool EffectCompressor::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelNames WXUNUSED(chanMap))
+{
+   if (GetPass() == 1)
+      InstanceInit(mMaster, mSampleRate,
+         LookaheadLength(mSampleRate, mLookaheadTime, mAttackTime));
+   return true;
+}
+
+bool EffectCompressor::ProcessFinalize()
+{
+   if (GetPass() == 1)
+      mMax = std::max(mMax, mMaster.max);
+   return true;
+}
+
+size_t EffectCompressor::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
+{
+   if (GetPass() == 1)
+      return InstanceProcess(mMaster, inBlock, outBlock, blockLen);
+
+   // Make-up gain
+   const float gain = 1.0 / mMax;
+   for (size_t i = 0; i < blockLen; i++)
+      outBlock[0][i] = inBlock[0][i] * gain;
+   return blockLen;
+}
+
+bool EffectCompressor::RealtimeInitialize()
+{
+   SetBlockSize(512);
+
+   mSlaves.clear();
+   mRealtimeLatency = 0;
+
+   return true;
+}
+
+bool EffectCompressor::RealtimeAddProcessor(unsigned WXUNUSED(numChannels), float sampleRate)
+{
+   EffectCompressorState slave;
+
+   // Allocate for the longest lookahead, so that changing it does not
+   // allocate in the audio thread
+   InstanceInit(slave, sampleRate,
+      LookaheadLength(sampleRate, MAX_LookaheadTime, MAX_AttackTime));
+
+   mSlaves.push_back(std::move(slave));
+
+   return true;
+}
+
+bool EffectCompressor::RealtimeFinalize()
+{
+   mSlaves.clear();
+
+   return true;
+}
+
+// Make-up gain needs the whole of the output, so realtime processing only
+// compresses
+size_t EffectCompressor::RealtimeProcess(int group,
+                                              float **inbuf,
+                                              float **outbuf,
+                                              size_t numSamples)
+{
+   return InstanceProcess(mSlaves[group], inbuf, outbuf, numSamples);
+}
+
 bool EffectCompressor::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mThresholdDB, Threshold );
    S.SHUTTLE_PARAM( mNoiseFloorDB, NoiseFloor );
@@ -130,6 +252,7 @@ bool EffectCompressor::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mDecayTime, ReleaseTime);
    S.SHUTTLE_PARAM( mNormalize, Normalize);
    S.SHUTTLE_PARAM( mUsePeak, UsePeak);
+   S.SHUTTLE_PARAM( mLookaheadTime, LookaheadTime);
    return true;
 }
 
@@ -142,6 +265,7 @@ bool EffectCompressor::GetAutomationParameters(CommandParameters & parms)
    parms.Write(KEY_ReleaseTime, mDecayTime);
    parms.Write(KEY_Normalize, mNormalize);
    parms.Write(KEY_UsePeak, mUsePeak);
+   parms.Write(KEY_LookaheadTime, mLookaheadTime);
 
    return true;
 }
@@ -155,6 +279,7 @@ bool EffectCompressor::SetAutomationParameters(CommandParameters & parms)
    ReadAndVerifyDouble(ReleaseTime);
    ReadAndVerifyBool(Normalize);
    ReadAndVerifyBool(UsePeak);
+   ReadAndVerifyDouble(LookaheadTime);
 
    mThresholdDB = Threshold;
    mNoiseFloorDB = NoiseFloor;
@@ -163,6 +288,7 @@ bool EffectCompressor::SetAutomationParameters(CommandParameters & parms)
    mDecayTime = ReleaseTime;
    mNormalize = Normalize;
    mUsePeak = UsePeak;
+   mLookaheadTime = LookaheadTime;
 
    return true;
 }
@@ -282,6 +408,19 @@ void EffectCompressor::PopulateOrExchange(ShuttleGui & S)
          mDecaySlider->SetName(_("Release Time"));
          mDecayText = S.AddVariableText(wxT("XXXX secs"), true,
                                         wxALIGN_LEFT | wxALIGN_CENTER_VERTICAL);
+
+         /* i18n-hint: How far ahead the compressor looks for loud sounds,
+          * delaying its output by as much when playing.  */
+         mLookaheadLabel = S.AddVariableText(_("Lookahead:"), true,
+                                             wxALIGN_RIGHT | wxALIGN_CENTER_VERTICAL);
+         S.SetStyle(wxSL_HORIZONTAL);
+         mLookaheadSlider = S.Id(ID_Lookahead).AddSlider( {},
+                                                         DEF_LookaheadTime * SCL_LookaheadTime,
+                                                         MAX_LookaheadTime * SCL_LookaheadTime,
+                                                         MIN_LookaheadTime * SCL_LookaheadTime);
+         mLookaheadSlider->SetName(_("Lookahead"));
+         mLookaheadText = S.AddVariableText(wxT("XXXX secs"), true,
+                                            wxALIGN_LEFT | wxALIGN_CENTER_VERTICAL);
       }
       S.EndMultiColumn();
    }
@@ -305,6 +444,7 @@ bool EffectCompressor::TransferDataToWindow()
    mRatioSlider->SetValue(lrint(mRatio * SCL_Ratio));
    mAttackSlider->SetValue(lrint(mAttackTime * SCL_AttackTime));
    mDecaySlider->SetValue(lrint(mDecayTime * SCL_ReleaseTime));
+   mLookaheadSlider->SetValue(lrint(mLookaheadTime * SCL_LookaheadTime));
    mGainCheckBox->SetValue(mNormalize);
    mPeakCheckBox->SetValue(mUsePeak);
 
@@ -325,150 +465,175 @@ bool EffectCompressor::TransferDataFromWindow()
    mRatio = (double) mRatioSlider->GetValue() / SCL_Ratio;
    mAttackTime = (double) mAttackSlider->GetValue() / 100.0; //SCL_AttackTime;
    mDecayTime = (double) mDecaySlider->GetValue() / SCL_ReleaseTime;
+   mLookaheadTime = (double) mLookaheadSlider->GetValue() / SCL_LookaheadTime;
    mNormalize = mGainCheckBox->GetValue();
    mUsePeak = mPeakCheckBox->GetValue();
 
    return true;
 }
 
-// EffectTwoPassSimpleMono implementation
-
-bool EffectCompressor::NewTrackPass1()
-{
-   mThreshold = DB_TO_LINEAR(mThresholdDB);
-   mNoiseFloor = DB_TO_LINEAR(mNoiseFloorDB);
-   mNoiseCounter = 100;
-
-   mAttackInverseFactor = exp(log(mThreshold) / (mCurRate * mAttackTime + 0.5));
-   mAttackFactor = 1.0 / mAttackInverseFactor;
-   mDecayFactor = exp(log(mThreshold) / (mCurRate * mDecayTime + 0.5));
-
-   if(mRatio > 1)
-      mCompression = 1.0-1.0/mRatio;
-   else
-      mCompression = 0.0;
-
-   mLastLevel = mThreshold;
-
-   mCircleSize = 100;
-   mCircle.reinit( mCircleSize, true );
-   mCirclePos = 0;
-   mRMSSum = 0.0;
-
-   return true;
-}
+// Effect implementation
 
 bool EffectCompressor::InitPass1()
 {
    mMax=0.0;
-   if (!mNormalize)
-      DisableSecondPass();
-
-   // Find the maximum block length required for any track
-   size_t maxlen = inputTracks()->Selected< const WaveTrack >().max(
-      &WaveTrack::GetMaxBlockSize
-   );
-   mFollow1.reset();
-   mFollow2.reset();
-   // Allocate buffers for the envelope
-   if(maxlen > 0) {
-      mFollow1.reinit(maxlen);
-      mFollow2.reinit(maxlen);
-   }
-   mFollowLen = maxlen;
-
    return true;
 }
 
 bool EffectCompressor::InitPass2()
 {
-   // Actually, this should not even be called, because we call
-   // DisableSecondPass() before, if mNormalize is false.
-   return mNormalize;
+   return mNormalize && mMax != 0;
+}
+
+// EffectCompressor implementation
+
+void EffectCompressor::InstanceInit(EffectCompressorState & data, float sampleRate,
+                                    size_t maxLookahead)
+{
+   data.samplerate = sampleRate;
+
+   data.circleSize = CircleSize;
+   data.circle.reinit(data.circleSize, true);
+   data.circlePos = 0;
+   data.rmsSum = 0.0;
+
+   data.started = false;
+   data.noiseCounter = 100;
+   data.lastLevel = 0.0;
+
+   data.ringSize = maxLookahead + 1;
+   data.ringInput.reinit(data.ringSize, true);
+   data.ringPos = 0;
+   data.lookahead = 0;
+   data.latency = 0;
+
+   // Each sample adds one candidate and at most lookahead + 1 of them are
+   // still in the lookahead, before the oldest leaves
+   data.peakSize = data.ringSize + 1;
+   data.peakTime.reinit(data.peakSize);
+   data.peakKey.reinit(data.peakSize);
+   data.peakFirst = 0;
+   data.peakLen = 0;
+   data.count = 0;
+   data.logAttackInverse = 0.0;
+   data.floorLevel = 0.0;
+   data.floorTime = -1;
+
+   data.outSize = GetBlockSize();
+   data.outInput.reinit(data.outSize);
+   data.outLevel.reinit(data.outSize);
+
+   data.max = 0.0;
+
+   UpdateSettings(data);
 }
 
-// Process the input with 2 buffers available at a time
-// buffer1 will be written upon return
-// buffer2 will be passed as buffer1 on the next call
-bool EffectCompressor::TwoBufferProcessPass1
-   (float *buffer1, size_t len1, float *buffer2, size_t len2)
+// Recompute the factors, which may change while playing in realtime
+void EffectCompressor::UpdateSettings(EffectCompressorState & data)
 {
-   // If buffers are bigger than allocated, then abort
-   // (this should never happen, but if it does, we don't want to crash)
-   if((len1 > mFollowLen) || (len2 > mFollowLen))
-      return false;
+   const double rate = data.samplerate;
 
-   // This makes sure that the initial value is well-chosen
-   // buffer1 == NULL on the first and only the first call
-   if (buffer1 == NULL) {
-      // Initialize the mLastLevel to the peak level in the first buffer
-      // This avoids problems with large spike events near the beginning of the track
-      mLastLevel = mThreshold;
-      for(size_t i=0; i<len2; i++) {
-         if(mLastLevel < fabs(buffer2[i]))
-            mLastLevel = fabs(buffer2[i]);
-      }
-   }
+   data.threshold = DB_TO_LINEAR(mThresholdDB);
+   data.noiseFloor = DB_TO_LINEAR(mNoiseFloorDB);
+   data.usePeak = mUsePeak;
 
-   // buffer2 is NULL on the last and only the last call
-   if(buffer2 != NULL) {
-      Follow(buffer2, mFollow2.get(), len2, mFollow1.get(), len1);
-   }
+   data.attackInverseFactor = exp(log(data.threshold) / (rate * mAttackTime + 0.5));
+   data.attackFactor = 1.0 / data.attackInverseFactor;
+   data.decayFactor = exp(log(data.threshold) / (rate * mDecayTime + 0.5));
 
-   if(buffer1 != NULL) {
-      for (size_t i = 0; i < len1; i++) {
-         buffer1[i] = DoCompression(buffer1[i], mFollow1[i]);
+   if(mRatio > 1)
+      data.compression = 1.0-1.0/mRatio;
+   else
+      data.compression = 0.0;
+
+   const double logAttackInverse = log(data.attackInverseFactor);
+   const auto lookahead = std::min(data.ringSize - 1,
+      LookaheadLength(rate, mLookaheadTime, mAttackTime));
+   if (lookahead != data.lookahead) {
+      // Start the lookahead over, silent, at the last level
+      data.latency += sampleCount(lookahead) - sampleCount(data.lookahead);
+      data.lookahead = lookahead;
+      std::fill(data.ringInput.get(), data.ringInput.get() + lookahead + 1, 0.0f);
+      data.ringPos = 0;
+      data.peakLen = 0;
+      data.floorLevel = std::max(data.threshold, data.lastLevel);
+      data.floorTime = data.count - 1;
+   }
+   else if (logAttackInverse != data.logAttackInverse) {
+      // Restate the candidates for the new attack, and drop those that it
+      // makes redundant
+      const auto size = data.peakSize;
+      const auto change = logAttackInverse - data.logAttackInverse;
+      size_t len = 0;
+      for (size_t i = 0; i < data.peakLen; i++) {
+         const auto from = (data.peakFirst + i) % size;
+         const auto key = data.peakKey[from] + data.peakTime[from] * change;
+         while (len > 0 && data.peakKey[(data.peakFirst + len - 1) % size] <= key)
+            --len;
+         const auto to = (data.peakFirst + len++) % size;
+         data.peakTime[to] = data.peakTime[from];
+         data.peakKey[to] = key;
       }
+      data.peakLen = len;
    }
-
-
-#if 0
-   // Copy the envelope over the track data (for debug purposes)
-   memcpy(buffer1, mFollow1, len1*sizeof(float));
-#endif
-
-   // Rotate the buffer pointers
-   mFollow1.swap(mFollow2);
-
-   return true;
+   data.logAttackInverse = logAttackInverse;
 }
 
-bool EffectCompressor::ProcessPass2(float *buffer, size_t len)
+size_t EffectCompressor::InstanceProcess(EffectCompressorState & data,
+                                              float **inBlock,
+                                              float **outBlock,
+                                              size_t blockLen)
 {
-   if (mMax != 0)
-   {
-      for (size_t i = 0; i < len; i++)
-         buffer[i] /= mMax;
-   }
+   UpdateSettings(data);
 
-   return true;
-}
+   if (!data.started) {
+      // Initialize the level to the peak level in the first block
+      // This avoids problems with large spike events near the beginning of the track
+      data.started = true;
+      data.lastLevel = data.threshold;
+      for(size_t i=0; i<blockLen; i++)
+         data.lastLevel = std::max<double>(data.lastLevel, fabs(inBlock[0][i]));
+      data.floorLevel = data.lastLevel;
+      data.floorTime = data.count - 1;
+      data.lastOutLevel = data.lastLevel;
+   }
 
-void EffectCompressor::FreshenCircle()
-{
-   // Recompute the RMS sum periodically to prevent accumulation of rounding errors
-   // during long waveforms
-   mRMSSum = 0;
-   for(size_t i=0; i<mCircleSize; i++)
-      mRMSSum += mCircle[i];
-}
+   if (!data.outInput || data.outSize < blockLen) {
+      data.outInput.reinit(blockLen);
+      data.outLevel.reinit(blockLen);
+      data.outSize = blockLen;
+   }
 
-float EffectCompressor::AvgCircle(float value)
-{
-   float level;
+   Follow(data, inBlock[0], blockLen);
+
+   const float *input = data.outInput.get();
+   const double *level = data.outLevel.get();
+   float *output = outBlock[0];
+   // Peak values map 1.0 to 1.0 - 'upward' compression
+   // With RMS-based compression don't change values below the threshold - 'downward' compression
+   const double ceiling = data.usePeak ? 1.0 : data.threshold;
+   const double compression = data.compression;
+   // The envelope often holds still, at the threshold or a peak, so
+   // compute the gain only where it changes
+   double gainLevel = -1.0, gain = 1.0;
+   for(size_t i=0; i<blockLen; i++) {
+      if(level[i] != gainLevel) {
+         gainLevel = level[i];
+         gain = pow(ceiling / gainLevel, compression);
+      }
+      output[i] = input[i] * gain;
+   }
 
-   // Calculate current level from root-mean-squared of
-   // circular buffer ("RMS")
-   mRMSSum -= mCircle[mCirclePos];
-   mCircle[mCirclePos] = value*value;
-   mRMSSum += mCircle[mCirclePos];
-   level = sqrt(mRMSSum/mCircleSize);
-   mCirclePos = (mCirclePos+1)%mCircleSize;
+   // Retain the maximum value for use in the normalization pass
+   float max = 0;
+   for(size_t i=0; i<blockLen; i++)
+      max = std::max(max, fabsf(output[i]));
+   data.max = std::max<double>(data.max, max);
 
-   return level;
+   return blockLen;
 }
 
-void EffectCompressor::Follow(float *buffer, float *env, size_t len, float *previous, size_t previous_len)
+void EffectCompressor::Follow(EffectCompressorState & data, const float *buffer, size_t len)
 {
    /*
 
@@ -504,99 +669,124 @@ void EffectCompressor::Follow(float *buffer, float *env, size_t len, float *prev
     The value has a lower limit of floor to make sure value has a
     reasonable positive value from which to begin an attack.
    */
+
+   // Here the limited buffer is the lookahead.  Each sample leaves it
+   // when the next enters, with its envelope final.
    double level,last;
 
-   if(!mUsePeak) {
-      // Update RMS sum directly from the circle buffer
-      // to avoid accumulation of rounding errors
-      FreshenCircle();
+   if(!data.usePeak) {
+      // Recompute the RMS sum periodically to prevent accumulation of
+      // rounding errors during long waveforms
+      data.rmsSum = 0;
+      for(size_t i=0; i<data.circleSize; i++)
+         data.rmsSum += data.circle[i];
    }
-   // First apply a peak detect with the requested decay rate
-   last = mLastLevel;
+
+   // Keep the state in locals in the loop, so that it stays in registers
+   const double threshold = data.threshold;
+   const double noiseFloor = data.noiseFloor;
+   const double decayFactor = data.decayFactor;
+   const double attackFactor = data.attackFactor;
+   const bool usePeak = data.usePeak;
+   const size_t lookahead = data.lookahead;
+   float *const ringInput = data.ringInput.get();
+   const double logAttackInverse = data.logAttackInverse;
+   long long *const peakTime = data.peakTime.get();
+   double *const peakKey = data.peakKey.get();
+   const size_t peakSize = data.peakSize;
+   size_t peakFirst = data.peakFirst;
+   size_t peakLen = data.peakLen;
+   long long count = data.count;
+   float *const outInput = data.outInput.get();
+   double *const outLevel = data.outLevel.get();
+   double *const circle = data.circle.get();
+   const size_t circleSize = data.circleSize;
+   size_t circlePos = data.circlePos;
+   double rmsSum = data.rmsSum;
+   int noiseCounter = data.noiseCounter;
+   double lastOut = data.lastOutLevel;
+   auto pos = data.ringPos;
+
+   last = data.lastLevel;
    for(size_t i=0; i<len; i++) {
-      if(mUsePeak)
+      // First apply a peak detect with the requested decay rate
+      if(usePeak)
          level = fabs(buffer[i]);
-      else // use RMS
-         level = AvgCircle(buffer[i]);
+      else {
+         // Calculate current level from root-mean-squared of
+         // circular buffer ("RMS")
+         rmsSum -= circle[circlePos];
+         circle[circlePos] = buffer[i]*buffer[i];
+         rmsSum += circle[circlePos];
+         level = (float)sqrt(rmsSum/circleSize);
+         if(++circlePos == circleSize)
+            circlePos = 0;
+      }
       // Don't increase gain when signal is continuously below the noise floor
-      if(level < mNoiseFloor) {
-         mNoiseCounter++;
+      if(level < noiseFloor) {
+         noiseCounter++;
       } else {
-         mNoiseCounter = 0;
+         noiseCounter = 0;
       }
-      if(mNoiseCounter < 100) {
-         last *= mDecayFactor;
-         if(last < mThreshold)
-            last = mThreshold;
+      if(noiseCounter < 100) {
+         last *= decayFactor;
+         if(last < threshold)
+            last = threshold;
          if(level > last)
             last = level;
       }
-      env[i] = last;
-   }
-   mLastLevel = last;
-
-   // Next do the same process in reverse direction to get the requested attack rate
-   last = mLastLevel;
-   for(size_t i = len; i--;) {
-      last *= mAttackInverseFactor;
-      if(last < mThreshold)
-         last = mThreshold;
-      if(env[i] < last)
-         env[i] = last;
-      else
-         last = env[i];
-   }
-
-   if((previous != NULL) && (previous_len > 0)) {
-      // If the previous envelope was passed, propagate the rise back until we intersect
-      for(size_t i = previous_len; i--;) {
-         last *= mAttackInverseFactor;
-         if(last < mThreshold)
-            last = mThreshold;
-         if(previous[i] < last)
-            previous[i] = last;
-         else // Intersected the previous envelope buffer, so we are finished
-            return;
-      }
-      // If we can't back up far enough, project the starting level forward
-      // until we intersect the desired envelope
-      last = previous[0];
-      for(size_t i=1; i<previous_len; i++) {
-         last *= mAttackFactor;
-         if(previous[i] > last)
-            previous[i] = last;
-         else // Intersected the desired envelope, so we are finished
-            return;
+      ringInput[pos] = buffer[i];
+
+      // Then the new level, with the requested attack rate applied back
+      // through the lookahead, outdoes the candidates no greater than it
+      const double key = log(last) + count * logAttackInverse;
+      while(peakLen > 0) {
+         auto back = peakFirst + peakLen - 1;
+         if(back >= peakSize)
+            back -= peakSize;
+         if(peakKey[back] > key)
+            break;
+         --peakLen;
       }
-      // If we still didn't intersect, then continue ramp up into current buffer
-      for(size_t i=0; i<len; i++) {
-         last *= mAttackFactor;
-         if(buffer[i] > last)
-            buffer[i] = last;
-         else // Finally got an intersect
-            return;
+      auto back = peakFirst + peakLen++;
+      if(back >= peakSize)
+         back -= peakSize;
+      peakTime[back] = count;
+      peakKey[back] = key;
+
+      // The oldest sample leaves, with the envelope of the greatest
+      // candidate that entered since.  If the rise could not reach back far
+      // enough, ramp it up from the level of the sample before.
+      const long long leaving = count - (long long) lookahead;
+      while(peakTime[peakFirst] < leaving) {
+         if(++peakFirst == peakSize)
+            peakFirst = 0;
+         --peakLen;
       }
-      // If we still didn't intersect, then reset mLastLevel
-      mLastLevel = last;
-   }
-}
-
-float EffectCompressor::DoCompression(float value, double env)
-{
-   float out;
-   if(mUsePeak) {
-      // Peak values map 1.0 to 1.0 - 'upward' compression
-      out = value * pow(1.0/env, mCompression);
-   } else {
-      // With RMS-based compression don't change values below mThreshold - 'downward' compression
-      out = value * pow(mThreshold/env, mCompression);
+      double out = exp(peakKey[peakFirst] - leaving * logAttackInverse);
+      if(out < threshold)
+         out = threshold;
+      if(leaving <= data.floorTime && out < data.floorLevel)
+         out = data.floorLevel;
+      ++count;
+
+      pos = (pos == lookahead ? 0 : pos + 1);
+      if(out > lastOut * attackFactor)
+         out = lastOut * attackFactor;
+      lastOut = out;
+      outInput[i] = ringInput[pos];
+      outLevel[i] = out;
    }
 
-   // Retain the maximum value for use in the normalization pass
-   if(mMax < fabs(out))
-      mMax = fabs(out);
-
-   return out;
+   data.circlePos = circlePos;
+   data.rmsSum = rmsSum;
+   data.noiseCounter = noiseCounter;
+   data.lastOutLevel = lastOut;
+   data.ringPos = pos;
+   data.lastLevel = last;
+   data.peakFirst = peakFirst;
+   data.peakLen = peakLen;
+   data.count = count;
 }
 
 void EffectCompressor::OnSlider(wxCommandEvent & WXUNUSED(evt))
@@ -638,6 +828,10 @@ void EffectCompressor::UpdateUI()
    mDecayText->SetLabel(wxString::Format(_("%.1f secs"), mDecayTime));
    mDecayText->SetName(mDecayText->GetLabel()); // fix for bug 577 (NVDA/Narrator screen readers do not read static text in dialogs)
 
+   mLookaheadLabel->SetName(wxString::Format(_("Lookahead %.2f secs"), mLookaheadTime));
+   mLookaheadText->SetLabel(wxString::Format(_("%.2f secs"), mLookaheadTime));
+   mLookaheadText->SetName(mLookaheadText->GetLabel()); // fix for bug 577 (NVDA/Narrator screen readers do not read static text in dialogs)
+
    mPanel->Refresh(false);
 
    return;
@@ -11,7 +11,9 @@
 #ifndef __AUDACITY_EFFECT_COMPRESSOR__
 #define __AUDACITY_EFFECT_COMPRESSOR__
 
-#include "TwoPassSimpleMono.h"
+#include <vector>
+
+#include "Effect.h"
 
 class wxCheckBox;
 class wxSlider;
@@ -21,7 +23,69 @@ class ShuttleGui;
 
 #define COMPRESSOR_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Compressor") }
 
-class EffectCompressor final : public EffectTwoPassSimpleMono
+class EffectCompressorState
+{
+public:
+   float       samplerate;
+
+   // Factors computed from the parameters, for the rate
+   double      threshold;
+   double      noiseFloor;
+   double      compression;
+   double      attackFactor;
+   double      attackInverseFactor;
+   double      decayFactor;
+   bool        usePeak;
+
+   // Running RMS of the input
+   size_t      circleSize;
+   size_t      circlePos;
+   double      rmsSum;
+   Doubles     circle;
+
+   // Envelope follower
+   bool        started;
+   int         noiseCounter;
+   double      lastLevel;
+   double      lastOutLevel;
+
+   // The lookahead: the input samples not yet output, in a ring of
+   // lookahead + 1 samples, allocated for the longest lookahead
+   size_t      lookahead;
+   size_t      ringSize;
+   size_t      ringPos;
+   Floats      ringInput;
+   // Change of delay not yet reported by GetLatency(), when not realtime
+   sampleCount latency;
+
+   // The envelope of a sample leaving the lookahead is the greatest of the
+   // levels that entered after it, each lowered by the attack for the time
+   // between.  The candidates are kept, oldest first and in decreasing
+   // order, with their times of entry and their logarithms seen from time
+   // 0, so that each sample costs constant time on average.
+   long long   count;
+   double      logAttackInverse;
+   size_t      peakSize;
+   size_t      peakFirst;
+   size_t      peakLen;
+   ArrayOf<long long> peakTime;
+   Doubles     peakKey;
+   // Least envelope of the samples up to floorTime, which were in the
+   // lookahead before the level was known
+   double      floorLevel;
+   long long   floorTime;
+
+   // The samples leaving the lookahead in the current block, and their
+   // envelope
+   Floats      outInput;
+   Doubles     outLevel;
+   size_t      outSize;
+
+   // Largest output magnitude, for make-up gain
+   double      max;
+};
+
+class EffectCompressor final : public Effect
 {
 public:
 
@@ -37,9 +101,23 @@ public:
    // EffectDefinitionInterface implementation
 
    EffectType GetType() override;
+   bool SupportsRealtime() override;
 
    // EffectClientInterface implementation
 
+   unsigned GetAudioInCount() override;
+   unsigned GetAudioOutCount() override;
+   sampleCount GetLatency() override;
+   bool ProcessInitialize(sampleCount totalLen, ChannelNames chanMap = NULL) override;
+   bool ProcessFinalize() override;
+   size_t ProcessBlock(float **inBlock, float **outBlock, size_t blockLen) override;
+   bool RealtimeInitialize() override;
+   bool RealtimeAddProcessor(unsigned numChannels, float sampleRate) override;
+   bool RealtimeFinalize() override;
+   size_t RealtimeProcess(int group,
+                               float **inbuf,
+                               float **outbuf,
+                               size_t numSamples) override;
    bool DefineParams( ShuttleParams & S ) override;
    bool GetAutomationParameters(CommandParameters & parms) override;
    bool SetAutomationParameters(CommandParameters & parms) override;
@@ -52,31 +130,31 @@ public:
    bool TransferDataFromWindow() override;
 
 protected:
-   // EffectTwoPassSimpleMono implementation
+   // Effect implementation
 
    bool InitPass1() override;
    bool InitPass2() override;
-   bool NewTrackPass1() override;
-   bool ProcessPass2(float *buffer, size_t len) override;
-   bool TwoBufferProcessPass1
-      (float *buffer1, size_t len1, float *buffer2, size_t len2) override;
 
 private:
    // EffectCompressor implementation
 
-   void FreshenCircle();
-   float AvgCircle(float x);
-   void Follow(float *buffer, float *env, size_t len, float *previous, size_t previous_len);
-   float DoCompression(float x, double env);
+   void InstanceInit(EffectCompressorState & data, float sampleRate,
+                     size_t maxLookahead);
+   void UpdateSettings(EffectCompressorState & data);
+   size_t InstanceProcess(EffectCompressorState & data,
+                               float **inBlock,
+                               float **outBlock,
+                               size_t blockLen);
+   void Follow(EffectCompressorState & data, const float *buffer, size_t len);
 
    void OnSlider(wxCommandEvent & evt);
    void UpdateUI();
 
 private:
-   double    mRMSSum;
-   size_t    mCircleSize;
-   size_t    mCirclePos;
-   Doubles   mCircle;
+   EffectCompressorState mMaster;
+   std::vector<EffectCompressorState> mSlaves;
+   // Delay of the realtime processors reported by GetLatency() so far
+   sampleCount mRealtimeLatency;
 
    double    mAttackTime;
    double    mThresholdDB;
@@ -86,17 +164,7 @@ private:
    bool      mUsePeak;
 
    double    mDecayTime;   // The "Release" time.
-   double    mAttackFactor;
-   double    mAttackInverseFactor;
-   double    mDecayFactor;
-   double    mThreshold;
-   double    mCompression;
-   double    mNoiseFloor;
-   int       mNoiseCounter;
-   double    mGain;
-   double    mLastLevel;
-   Floats mFollow1, mFollow2;
-   size_t    mFollowLen;
+   double    mLookaheadTime;
 
    double    mMax;			//MJS
 
@@ -122,6 +190,10 @@ private:
    wxSlider *mDecaySlider;
    wxStaticText *mDecayText;
 
+   wxStaticText *mLookaheadLabel;
+   wxSlider *mLookaheadSlider;
+   wxStaticText *mLookaheadText;
+
    wxCheckBox *mGainCheckBox;
    wxCheckBox *mPeakCheckBox;
 
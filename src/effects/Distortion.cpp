@@ -184,7 +184,6 @@ EffectDistortion::EffectDistortion()
    mParams.mParam1 = DEF_Param1;
    mParams.mParam2 = DEF_Param2;
    mParams.mRepeats = DEF_Repeats;
-   mMakeupGain = 1.0;
    mbSavedFilterState = DEF_DCBlock;
 
    SetLinearEffectFlag(false);
@@ -285,6 +284,12 @@ size_t EffectDistortion::RealtimeProcess(int group,
 
    return InstanceProcess(mSlaves[group], inbuf, outbuf, numSamples);
 }
+
+bool EffectDistortion::SupportsParallelProcessing()
+{
+   return true;
+}
+
 bool EffectDistortion::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_ENUM_PARAM( mParams.mTableChoiceIndx, TableTypeIndx,
       kTableTypeStrings, nTableTypes );
@@ -532,7 +537,8 @@ void EffectDistortion::InstanceInit(EffectDistortionState & data, float sampleRa
    while (!data.queuesamples.empty())
       data.queuesamples.pop();
 
-   MakeTable();
+   data.makeupGain = 1.0;
+   MakeTable(data);
 
    return;
 }
@@ -560,49 +566,49 @@ size_t EffectDistortion::InstanceProcess(EffectDistortionState& data, float** in
 
    for (decltype(blockLen) i = 0; i < blockLen; i++) {
       if (update && ((data.skipcount++) % skipsamples == 0)) {
-         MakeTable();
+         MakeTable(data);
       }
 
       switch (mParams.mTableChoiceIndx)
       {
       case kHardClip:
          // Param2 = make-up gain.
-         obuf[i] = WaveShaper(ibuf[i]) * ((1 - p2) + (mMakeupGain * p2));
+         obuf[i] = WaveShaper(data, ibuf[i]) * ((1 - p2) + (data.makeupGain * p2));
          break;
       case kSoftClip:
          // Param2 = make-up gain.
-         obuf[i] = WaveShaper(ibuf[i]) * ((1 - p2) + (mMakeupGain * p2));
+         obuf[i] = WaveShaper(data, ibuf[i]) * ((1 - p2) + (data.makeupGain * p2));
          break;
       case kHalfSinCurve:
-         obuf[i] = WaveShaper(ibuf[i]) * p2;
+         obuf[i] = WaveShaper(data, ibuf[i]) * p2;
          break;
       case kExpCurve:
-         obuf[i] = WaveShaper(ibuf[i]) * p2;
+         obuf[i] = WaveShaper(data, ibuf[i]) * p2;
          break;
       case kLogCurve:
-         obuf[i] = WaveShaper(ibuf[i]) * p2;
+         obuf[i] = WaveShaper(data, ibuf[i]) * p2;
          break;
       case kCubic:
-         obuf[i] = WaveShaper(ibuf[i]) * p2;
+         obuf[i] = WaveShaper(data, ibuf[i]) * p2;
          break;
       case kEvenHarmonics:
-         obuf[i] = WaveShaper(ibuf[i]);
+         obuf[i] = WaveShaper(data, ibuf[i]);
          break;
       case kSinCurve:
-         obuf[i] = WaveShaper(ibuf[i]) * p2;
+         obuf[i] = WaveShaper(data, ibuf[i]) * p2;
          break;
       case kLeveller:
-         obuf[i] = WaveShaper(ibuf[i]);
+         obuf[i] = WaveShaper(data, ibuf[i]);
          break;
       case kRectifier:
-         obuf[i] = WaveShaper(ibuf[i]);
+         obuf[i] = WaveShaper(data, ibuf[i]);
          break;
       case kHardLimiter:
          // Mix equivalent to LADSPA effect's "Wet / Residual" mix
-         obuf[i] = (WaveShaper(ibuf[i]) * (p1 - p2)) + (ibuf[i] * p2);
+         obuf[i] = (WaveShaper(data, ibuf[i]) * (p1 - p2)) + (ibuf[i] * p2);
          break;
       default:
-         obuf[i] = WaveShaper(ibuf[i]);
+         obuf[i] = WaveShaper(data, ibuf[i]);
       }
       if (mParams.mDCBlock) {
          obuf[i] = DCFilter(data, obuf[i]);
@@ -955,42 +961,42 @@ void EffectDistortion::UpdateControlText(wxTextCtrl* textCtrl, wxString& string,
    }
 }
 
-void EffectDistortion::MakeTable()
+void EffectDistortion::MakeTable(EffectDistortionState & data)
 {
    switch (mParams.mTableChoiceIndx)
    {
       case kHardClip:
-         HardClip();
+         HardClip(data);
          break;
       case kSoftClip:
-         SoftClip();
+         SoftClip(data);
          break;
       case kHalfSinCurve:
-         HalfSinTable();
+         HalfSinTable(data);
          break;
       case kExpCurve:
-         ExponentialTable();
+         ExponentialTable(data);
          break;
       case kLogCurve:
-         LogarithmicTable();
+         LogarithmicTable(data);
          break;
       case kCubic:
-         CubicTable();
+         CubicTable(data);
          break;
       case kEvenHarmonics:
-         EvenHarmonicTable();
+         EvenHarmonicTable(data);
          break;
       case kSinCurve:
-         SineTable();
+         SineTable(data);
          break;
       case kLeveller:
-         Leveller();
+         Leveller(data);
          break;
       case kRectifier:
-         Rectifier();
+         Rectifier(data);
          break;
       case kHardLimiter:
-         HardLimiter();
+         HardLimiter(data);
          break;
    }
 }
@@ -1000,39 +1006,39 @@ void EffectDistortion::MakeTable()
 // Preset tables for gain lookup
 //
 
-void EffectDistortion::HardClip()
+void EffectDistortion::HardClip(EffectDistortionState & data)
 {
    double lowThresh = 1 - mThreshold;
    double highThresh = 1 + mThreshold;
 
    for (int n = 0; n < TABLESIZE; n++) {
       if (n < (STEPS * lowThresh))
-         mTable[n] = - mThreshold;
+         data.table[n] = - mThreshold;
       else if (n > (STEPS * highThresh))
-         mTable[n] = mThreshold;
+         data.table[n] = mThreshold;
       else
-         mTable[n] = n/(double)STEPS - 1;
+         data.table[n] = n/(double)STEPS - 1;
 
-      mMakeupGain = 1.0 / mThreshold;
+      data.makeupGain = 1.0 / mThreshold;
    }
 }
 
-void EffectDistortion::SoftClip()
+void EffectDistortion::SoftClip(EffectDistortionState & data)
 {
    double threshold = 1 + mThreshold;
    double amount = std::pow(2.0, 7.0 * mParams.mParam1 / 100.0); // range 1 to 128
    double peak = LogCurve(mThreshold, 1.0, amount);
-   mMakeupGain = 1.0 / peak;
-   mTable[STEPS] = 0.0;   // origin
+   data.makeupGain = 1.0 / peak;
+   data.table[STEPS] = 0.0;   // origin
 
    // positive half of table
    for (int n = STEPS; n < TABLESIZE; n++) {
       if (n < (STEPS * threshold)) // origin to threshold
-         mTable[n] = n/(float)STEPS - 1;
+         data.table[n] = n/(float)STEPS - 1;
       else
-         mTable[n] = LogCurve(mThreshold, n/(double)STEPS - 1, amount);
+         data.table[n] = LogCurve(mThreshold, n/(double)STEPS - 1, amount);
    }
-   CopyHalfTable();
+   CopyHalfTable(data);
 }
 
 float EffectDistortion::LogCurve(double threshold, float value, double ratio)
@@ -1040,7 +1046,7 @@ float EffectDistortion::LogCurve(double threshold, float value, double ratio)
    return threshold + ((std::exp(ratio * (threshold - value)) - 1) / -ratio);
 }
 
-void EffectDistortion::ExponentialTable()
+void EffectDistortion::ExponentialTable(EffectDistortionState & data)
 {
    double amount = std::min(0.999, DB_TO_LINEAR(-1 * mParams.mParam1));   // avoid divide by zero
 
@@ -1048,12 +1054,12 @@ void EffectDistortion::ExponentialTable()
       double linVal = n/(float)STEPS;
       double scale = -1.0 / (1.0 - amount);   // unity gain at 0dB
       double curve = std::exp((linVal - 1) * std::log(amount));
-      mTable[n] = scale * (curve -1);
+      data.table[n] = scale * (curve -1);
    }
-   CopyHalfTable();
+   CopyHalfTable(data);
 }
 
-void EffectDistortion::LogarithmicTable()
+void EffectDistortion::LogarithmicTable(EffectDistortionState & data)
 {
    double amount = mParams.mParam1;
    double stepsize = 1.0 / STEPS;
@@ -1061,20 +1067,20 @@ void EffectDistortion::LogarithmicTable()
 
    if (amount == 0){
       for (int n = STEPS; n < TABLESIZE; n++) {
-      mTable[n] = linVal;
+      data.table[n] = linVal;
       linVal += stepsize;
       }
    }
    else {
       for (int n = STEPS; n < TABLESIZE; n++) {
-         mTable[n] = std::log(1 + (amount * linVal)) / std::log(1 + amount);
+         data.table[n] = std::log(1 + (amount * linVal)) / std::log(1 + amount);
          linVal += stepsize;
       }
    }
-   CopyHalfTable();
+   CopyHalfTable(data);
 }
 
-void EffectDistortion::HalfSinTable()
+void EffectDistortion::HalfSinTable(EffectDistortionState & data)
 {
    int iter = std::floor(mParams.mParam1 / 20.0);
    double fractionalpart = (mParams.mParam1 / 20.0) - iter;
@@ -1082,17 +1088,17 @@ void EffectDistortion::HalfSinTable()
    double linVal = 0;
 
    for (int n = STEPS; n < TABLESIZE; n++) {
-      mTable[n] = linVal;
+      data.table[n] = linVal;
       for (int i = 0; i < iter; i++) {
-         mTable[n] = std::sin(mTable[n] * M_PI_2);
+         data.table[n] = std::sin(data.table[n] * M_PI_2);
       }
-      mTable[n] += ((std::sin(mTable[n] * M_PI_2) - mTable[n]) * fractionalpart);
+      data.table[n] += ((std::sin(data.table[n] * M_PI_2) - data.table[n]) * fractionalpart);
       linVal += stepsize;
    }
-   CopyHalfTable();
+   CopyHalfTable(data);
 }
 
-void EffectDistortion::CubicTable()
+void EffectDistortion::CubicTable(EffectDistortionState & data)
 {
    double amount = mParams.mParam1 * std::sqrt(3.0) / 100.0;
    double gain = 1.0;
@@ -1104,14 +1110,14 @@ void EffectDistortion::CubicTable()
    
    if (amount == 0) {
       for (int i = 0; i < TABLESIZE; i++) {
-         mTable[i] = (i / (double)STEPS) - 1.0;
+         data.table[i] = (i / (double)STEPS) - 1.0;
       }
    }
    else {
       for (int i = 0; i < TABLESIZE; i++) {
-         mTable[i] = gain * Cubic(x);
+         data.table[i] = gain * Cubic(x);
          for (int j = 0; j < mParams.mRepeats; j++) {
-            mTable[i] = gain * Cubic(mTable[i] * amount);
+            data.table[i] = gain * Cubic(data.table[i] * amount);
          }
          x += stepsize;
       }
@@ -1127,7 +1133,7 @@ double EffectDistortion::Cubic(double x)
 }
 
 
-void EffectDistortion::EvenHarmonicTable()
+void EffectDistortion::EvenHarmonicTable(EffectDistortionState & data)
 {
    double amount = mParams.mParam1 / -100.0;
    // double C = std::sin(std::max(0.001, mParams.mParam2) / 100.0) * 10.0;
@@ -1137,13 +1143,13 @@ void EffectDistortion::EvenHarmonicTable()
    double xval = -1.0;
 
    for (int i = 0; i < TABLESIZE; i++) {
-      mTable[i] = ((1 + amount) * xval) -
+      data.table[i] = ((1 + amount) * xval) -
                   (xval * (amount / std::tanh(C)) * std::tanh(C * xval));
       xval += step;
    }
 }
 
-void EffectDistortion::SineTable()
+void EffectDistortion::SineTable(EffectDistortionState & data)
 {
    int iter = std::floor(mParams.mParam1 / 20.0);
    double fractionalpart = (mParams.mParam1 / 20.0) - iter;
@@ -1151,17 +1157,17 @@ void EffectDistortion::SineTable()
    double linVal = 0.0;
 
    for (int n = STEPS; n < TABLESIZE; n++) {
-      mTable[n] = linVal;
+      data.table[n] = linVal;
       for (int i = 0; i < iter; i++) {
-         mTable[n] = (1.0 + std::sin((mTable[n] * M_PI) - M_PI_2)) / 2.0;
+         data.table[n] = (1.0 + std::sin((data.table[n] * M_PI) - M_PI_2)) / 2.0;
       }
-      mTable[n] += (((1.0 + std::sin((mTable[n] * M_PI) - M_PI_2)) / 2.0) - mTable[n]) * fractionalpart;
+      data.table[n] += (((1.0 + std::sin((data.table[n] * M_PI) - M_PI_2)) / 2.0) - data.table[n]) * fractionalpart;
       linVal += stepsize;
    }
-   CopyHalfTable();
+   CopyHalfTable(data);
 }
 
-void EffectDistortion::Leveller()
+void EffectDistortion::Leveller(EffectDistortionState & data)
 {
    double noiseFloor = DB_TO_LINEAR(mParams.mNoiseFloor);
    int numPasses = mParams.mRepeats;
@@ -1195,30 +1201,30 @@ void EffectDistortion::Leveller()
    // repeated passes over the audio data.
    // Here we model that more efficiently by repeated passes over a linear table.
    for (int n = STEPS; n < TABLESIZE; n++) {
-      mTable[n] = ((double) (n - STEPS) / (double) STEPS);
+      data.table[n] = ((double) (n - STEPS) / (double) STEPS);
       for (int j = 0; j < numPasses; j++) {
          // Find the highest index for gain adjustment
          int index = numPoints - 1;
-         for (int i = index; i >= 0 && mTable[n] < gainLimits[i]; i--) {
+         for (int i = index; i >= 0 && data.table[n] < gainLimits[i]; i--) {
             index = i;
          }
          // the whole number of 'repeats'
-         mTable[n] = (mTable[n] * gainFactors[index]) + addOnValues[index];
+         data.table[n] = (data.table[n] * gainFactors[index]) + addOnValues[index];
       }
       // Extrapolate for fine adjustment.
       // tiny fractions are not worth the processing time
       if (fractionalPass > 0.001) {
          int index = numPoints - 1;
-         for (int i = index; i >= 0 && mTable[n] < gainLimits[i]; i--) {
+         for (int i = index; i >= 0 && data.table[n] < gainLimits[i]; i--) {
             index = i;
          }
-         mTable[n] += fractionalPass * ((mTable[n] * (gainFactors[index] - 1)) + addOnValues[index]);
+         data.table[n] += fractionalPass * ((data.table[n] * (gainFactors[index] - 1)) + addOnValues[index]);
       }
    }
-   CopyHalfTable();
+   CopyHalfTable(data);
 }
 
-void EffectDistortion::Rectifier()
+void EffectDistortion::Rectifier(EffectDistortionState & data)
 {
    double amount = (mParams.mParam1 / 50.0) - 1;
    double stepsize = 1.0 / STEPS;
@@ -1226,41 +1232,41 @@ void EffectDistortion::Rectifier()
 
    // positive half of waveform is passed unaltered.
    for  (int n = 0; n <= STEPS; n++) {
-      mTable[index] = n * stepsize;
+      data.table[index] = n * stepsize;
       index += 1;
    }
 
    // negative half of table
    index = STEPS - 1;
    for (int n = 1; n <= STEPS; n++) {
-      mTable[index] = n * stepsize * amount;
+      data.table[index] = n * stepsize * amount;
       index--;
    }
 }
 
-void EffectDistortion::HardLimiter()
+void EffectDistortion::HardLimiter(EffectDistortionState & data)
 {
    // The LADSPA "hardLimiter 1413" is basically hard clipping,
    // but with a 'kind of' wet/dry mix:
    // out = ((wet-residual)*clipped) + (residual*in)
-   HardClip();
+   HardClip(data);
 }
 
 
 // Helper functions for lookup tables
 
-void EffectDistortion::CopyHalfTable()
+void EffectDistortion::CopyHalfTable(EffectDistortionState & data)
 {
    // Copy negative half of table from positive half
    int count = TABLESIZE - 1;
    for (int n = 0; n < STEPS; n++) {
-      mTable[n] = -mTable[count];
+      data.table[n] = -data.table[count];
       count--;
    }
 }
 
 
-float EffectDistortion::WaveShaper(float sample)
+float EffectDistortion::WaveShaper(const EffectDistortionState & data, float sample)
 {
    float out;
    int index;
@@ -1284,7 +1290,7 @@ float EffectDistortion::WaveShaper(float sample)
    xOffset = wxMin<double>(wxMax<double>(xOffset, 0.0), 1.0);   // Clip at 0dB
 
    // linear interpolation: y = y0 + (y1-y0)*(x-x0)
-   out = mTable[index] + (mTable[index + 1] - mTable[index]) * xOffset;
+   out = data.table[index] + (data.table[index + 1] - data.table[index]) * xOffset;
 
    return out;
 }
@@ -41,6 +41,13 @@ public:
    // DC block filter variables
    std::queue<float> queuesamples;
    double queuetotal;
+
+   // Each processor builds its own lookup table, so that processors
+   // running at once never read a table being rebuilt
+   double table[TABLESIZE];
+   // Used by some distortion types to pass the amount of gain required
+   // to bring overall effect gain to unity
+   double makeupGain;
 };
 
 class EffectDistortion final : public Effect
@@ -84,6 +91,7 @@ public:
                                float **inbuf,
                                float **outbuf,
                                size_t numSamples) override;
+   bool SupportsParallelProcessing() override;
    bool DefineParams( ShuttleParams & S ) override;
    bool GetAutomationParameters(CommandParameters & parms) override;
    bool SetAutomationParameters(CommandParameters & parms) override;
@@ -134,27 +142,27 @@ private:
    void UpdateControl(control id, bool enable, wxString name);
    void UpdateControlText(wxTextCtrl *textCtrl, wxString &string, bool enabled);
 
-   void MakeTable();
-   float WaveShaper(float sample);
+   void MakeTable(EffectDistortionState & data);
+   float WaveShaper(const EffectDistortionState & data, float sample);
    float DCFilter(EffectDistortionState & data, float sample);
 
    // Preset tables for gain lookup
 
-   void HardClip();           // hard clipping
-   void SoftClip();           // soft clipping
-   void ExponentialTable();   // exponential mapping
-   void LogarithmicTable();   // logarithmic mapping
-   void HalfSinTable();
-   void CubicTable();
-   void EvenHarmonicTable();
-   void SineTable();
-   void Leveller();           // 'Leveller' wavetable is modeled on the legacy effect of the same name.
-   void Rectifier();          // 0% = Dry, 50% = half-wave rectified, 100% = full-wave rectified (abs value).
-   void HardLimiter();        // Same effect as the LADSPA "hardLimiter 1413"
+   void HardClip(EffectDistortionState & data);           // hard clipping
+   void SoftClip(EffectDistortionState & data);           // soft clipping
+   void ExponentialTable(EffectDistortionState & data);   // exponential mapping
+   void LogarithmicTable(EffectDistortionState & data);   // logarithmic mapping
+   void HalfSinTable(EffectDistortionState & data);
+   void CubicTable(EffectDistortionState & data);
+   void EvenHarmonicTable(EffectDistortionState & data);
+   void SineTable(EffectDistortionState & data);
+   void Leveller(EffectDistortionState & data);           // 'Leveller' wavetable is modeled on the legacy effect of the same name.
+   void Rectifier(EffectDistortionState & data);          // 0% = Dry, 50% = half-wave rectified, 100% = full-wave rectified (abs value).
+   void HardLimiter(EffectDistortionState & data);        // Same effect as the LADSPA "hardLimiter 1413"
 
    // Wavetable helper functions
 
-   void CopyHalfTable();   // for symmetric tables
+   void CopyHalfTable(EffectDistortionState & data);   // for symmetric tables
 
    // Used by Soft Clipping but could be used for other tables.
    // Log curve formula: y = T + (((e^(RT - Rx)) - 1) / -R)
@@ -170,14 +178,9 @@ private:
    EffectDistortionState mMaster;
    std::vector<EffectDistortionState> mSlaves;
 
-   double mTable[TABLESIZE];
    double mThreshold;
    bool mbSavedFilterState;
 
-   // mMakeupGain is used by some distortion types to pass the
-   // amount of gain required to bring overall effect gain to unity
-   double mMakeupGain;
-
    int mTypChoiceIndex;
 
    wxChoice *mTypeChoiceCtrl;
@@ -22,6 +22,7 @@
 #include "../Audacity.h"
 #include "Echo.h"
 
+#include <algorithm>
 #include <float.h>
 
 #include <wx/intl.h>
@@ -37,6 +38,9 @@
 Param( Delay,  float,   wxT("Delay"),   1.0f, 0.001f,  FLT_MAX, 1.0f );
 Param( Decay,  float,   wxT("Decay"),   0.5f, 0.0f,    FLT_MAX, 1.0f );
 
+// Seconds of history each realtime processor allocates, at least
+static const double realtimeMaxDelay = 10.0;
+
 EffectEcho::EffectEcho()
 {
    delay = DEF_Delay;
@@ -85,6 +89,15 @@ unsigned EffectEcho::GetAudioOutCount()
    return 1;
 }
 
+bool EffectEcho::SupportsRealtime()
+{
+#if defined(EXPERIMENTAL_REALTIME_AUDACITY_EFFECTS)
+   return true;
+#else
+   return false;
+#endif
+}
+
 bool EffectEcho::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelNames WXUNUSED(chanMap))
 {
    if (delay == 0.0)
@@ -92,47 +105,69 @@ bool EffectEcho::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelNames
       return false;
    }
 
-   histPos = 0;
-   auto requestedHistLen = (sampleCount) (mSampleRate * delay);
-
-   // Guard against extreme delay values input by the user
-   try {
-      // Guard against huge delay values from the user.
-      // Don't violate the assertion in as_size_t
-      if (requestedHistLen !=
-            (histLen = static_cast<size_t>(requestedHistLen.as_long_long())))
-         throw std::bad_alloc{};
-      history.reinit(histLen, true);
-   }
-   catch ( const std::bad_alloc& ) {
+   if (!InstanceInit(mMaster, mSampleRate, delay))
+   {
       Effect::MessageBox(_("Requested value exceeds memory capacity."));
       return false;
    }
 
-   return history != NULL;
+   return true;
 }
 
 bool EffectEcho::ProcessFinalize()
 {
-   history.reset();
+   mMaster.history.reset();
    return true;
 }
 
 size_t EffectEcho::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
-   float *ibuf = inBlock[0];
-   float *obuf = outBlock[0];
+   return InstanceProcess(mMaster, inBlock, outBlock, blockLen);
+}
 
-   for (decltype(blockLen) i = 0; i < blockLen; i++, histPos++)
+bool EffectEcho::RealtimeInitialize()
+{
+   SetBlockSize(512);
+
+   mSlaves.clear();
+
+   return true;
+}
+
+bool EffectEcho::RealtimeAddProcessor(unsigned WXUNUSED(numChannels), float sampleRate)
+{
+   EffectEchoState slave;
+
+   // Allocate now for the longest delay the processor will take, so that
+   // changing the delay does not allocate in the audio thread.  Longer
+   // delays set while it runs are clamped to this.
+   InstanceInit(slave, sampleRate, std::max<double>(delay, realtimeMaxDelay));
+
+   mSlaves.push_back(std::move(slave));
+
+   return true;
+}
+
+bool EffectEcho::RealtimeFinalize()
+{
+   mSlaves.clear();
+
+   return true;
+}
+
+size_t EffectEcho::RealtimeProcess(int group,
+                                        float **inbuf,
+                                        float **outbuf,
+                                        size_t numSamples)
+{
+   auto &slave = mSlaves[group];
+
+   if (slave.delay != delay)
    {
-      if (histPos == histLen)
-      {
-         histPos = 0;
-      }
-      history[histPos] = obuf[i] = ibuf[i] + history[histPos] * decay;
+      InstanceSetDelay(slave);
    }
 
-   return blockLen;
+   return InstanceProcess(slave, inbuf, outbuf, numSamples);
 }
 
 bool EffectEcho::DefineParams( ShuttleParams & S ){
@@ -176,6 +211,13 @@ void EffectEcho::PopulateOrExchange(ShuttleGui & S)
       S.AddTextBox(_("Decay factor:"), wxT(""), 10)->SetValidator(vldDecay);
    }
    S.EndMultiColumn();
+
+   if (SupportsRealtime())
+   {
+      S.AddFixedText(wxString::Format(
+         _("While playing, the delay is limited to %g seconds,\nor to the delay playback started with, if longer."),
+         realtimeMaxDelay), true);
+   }
 }
 
 bool EffectEcho::TransferDataToWindow()
@@ -198,3 +240,88 @@ bool EffectEcho::TransferDataFromWindow()
    return true;
 }
 
+// EffectEcho implementation
+
+bool EffectEcho::InstanceInit(EffectEchoState & data, float sampleRate, double maxDelay)
+{
+   data.samplerate = sampleRate;
+   data.histPos = 0;
+   data.histLen = 0;
+   data.histMax = 0;
+   data.history.reset();
+
+   auto requestedHistLen = (sampleCount) (sampleRate * maxDelay);
+
+   // Guard against extreme delay values input by the user
+   try {
+      // Guard against huge delay values from the user.
+      // Don't violate the assertion in as_size_t
+      size_t histMax;
+      if (requestedHistLen !=
+            (histMax = static_cast<size_t>(requestedHistLen.as_long_long())))
+         throw std::bad_alloc{};
+      data.history.reinit(histMax, true);
+      data.histMax = histMax;
+   }
+   catch ( const std::bad_alloc& ) {
+      return false;
+   }
+
+   InstanceSetDelay(data);
+
+   return true;
+}
+
+// Use as much of the history as the delay needs, clamped to what was
+// allocated.  Does not allocate.
+void EffectEcho::InstanceSetDelay(EffectEchoState & data)
+{
+   data.delay = delay;
+
+   auto requestedHistLen = (sampleCount) (data.samplerate * delay);
+   const auto oldHistLen = data.histLen;
+   data.histLen = requestedHistLen < data.histMax
+      ? requestedHistLen.as_size_t()
+      : data.histMax;
+
+   // Samples beyond the old length are left over from a longer delay used
+   // before; don't echo them again
+   if (data.histLen > oldHistLen)
+      std::fill(data.history.get() + oldHistLen,
+                data.history.get() + data.histLen, 0.0f);
+
+   if (data.histPos >= data.histLen)
+      data.histPos = 0;
+}
+
+size_t EffectEcho::InstanceProcess(EffectEchoState & data,
+                                        float **inBlock,
+                                        float **outBlock,
+                                        size_t blockLen)
+{
+   float *ibuf = inBlock[0];
+   float *obuf = outBlock[0];
+
+   if (data.histLen == 0)
+   {
+      memmove(obuf, ibuf, blockLen * sizeof(float));
+      return blockLen;
+   }
+
+   auto &history = data.history;
+   auto histPos = data.histPos;
+   const auto histLen = data.histLen;
+
+   for (decltype(blockLen) i = 0; i < blockLen; i++, histPos++)
+   {
+      if (histPos == histLen)
+      {
+         histPos = 0;
+      }
+      history[histPos] = obuf[i] = ibuf[i] + history[histPos] * decay;
+   }
+
+   data.histPos = histPos;
+
+   return blockLen;
+}
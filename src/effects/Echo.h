@@ -12,12 +12,25 @@
 #ifndef __AUDACITY_EFFECT_ECHO__
 #define __AUDACITY_EFFECT_ECHO__
 
+#include <vector>
+
 #include "Effect.h"
 
 class ShuttleGui;
 
 #define ECHO_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Echo") }
 
+class EffectEchoState
+{
+public:
+   float    samplerate;
+   double   delay;
+   Floats   history;
+   size_t   histPos;
+   size_t   histLen;
+   size_t   histMax;
+};
+
 class EffectEcho final : public Effect
 {
 public:
@@ -33,6 +46,7 @@ public:
    // EffectDefinitionInterface implementation
 
    EffectType GetType() override;
+   bool SupportsRealtime() override;
 
    // EffectClientInterface implementation
 
@@ -41,6 +55,13 @@ public:
    bool ProcessInitialize(sampleCount totalLen, ChannelNames chanMap = NULL) override;
    bool ProcessFinalize() override;
    size_t ProcessBlock(float **inBlock, float **outBlock, size_t blockLen) override;
+   bool RealtimeInitialize() override;
+   bool RealtimeAddProcessor(unsigned numChannels, float sampleRate) override;
+   bool RealtimeFinalize() override;
+   size_t RealtimeProcess(int group,
+                               float **inbuf,
+                               float **outbuf,
+                               size_t numSamples) override;
    bool DefineParams( ShuttleParams & S ) override;
    bool GetAutomationParameters(CommandParameters & parms) override;
    bool SetAutomationParameters(CommandParameters & parms) override;
@@ -53,12 +74,19 @@ public:
 private:
    // EffectEcho implementation
 
+   bool InstanceInit(EffectEchoState & data, float sampleRate, double maxDelay);
+   void InstanceSetDelay(EffectEchoState & data);
+   size_t InstanceProcess(EffectEchoState & data,
+                               float **inBlock,
+                               float **outBlock,
+                               size_t blockLen);
+
 private:
    double delay;
    double decay;
-   Floats history;
-   size_t histPos;
-   size_t histLen;
+
+   EffectEchoState mMaster;
+   std::vector<EffectEchoState> mSlaves;
 };
 
 #endif // __AUDACITY_EFFECT_ECHO__
@@ -56,11 +56,13 @@ greater use in future.
 #include "../Mix.h"
 #include "../PluginManager.h"
 #include "../Prefs.h"
+#include "../Profiler.h"
 #include "../Project.h"
 #include "../ProjectAudioManager.h"
 #include "../ProjectSettings.h"
 #include "../ShuttleGui.h"
 #include "../Shuttle.h"
+#include "../ThreadPool.h"
 #include "../ViewInfo.h"
 #include "../WaveTrack.h"
 #include "../commands/Command.h"
@@ -522,6 +524,16 @@ bool Effect::RealtimeProcessEnd()
    return true;
 }
 
+bool Effect::SupportsParallelProcessing()
+{
+   if (mClient)
+   {
+      return mClient->SupportsParallelProcessing();
+   }
+
+   return false;
+}
+
 bool Effect::ShowInterface(wxWindow *parent, bool forceModal)
 {
    if (!IsInteractive())
@@ -1275,6 +1287,7 @@ bool Effect::DoEffect(wxWindow *parent,
       };
       auto vr = valueRestorer( mProgress, &progress );
 
+      PROFILE_SCOPE("Effect::Process");
       returnVal = Process();
    }
 
@@ -1328,6 +1341,14 @@ bool Effect::Process()
    CopyInputTracks(true);
    bool bGoodResult = true;
 
+   auto cleanup = finally( [&] {
+      mInBuffer.reset();
+      mOutBuffer.reset();
+      mInBufPos.reset();
+      mOutBufPos.reset();
+      mBufferSize = 0;
+   } );
+
    // It's possible that the number of channels the effect expects changed based on
    // the parameters (the Audacity Reverb effect does when the stereo width is 0).
    mNumAudioIn = GetAudioInCount();
@@ -1349,22 +1370,66 @@ bool Effect::Process()
    return bGoodResult;
 }
 
+namespace {
+
+// How many of the remaining samples from start to take into a buffer of the
+// given size, ending on a block boundary of the track when more samples
+// follow, so that reads and writes of the track cover whole blocks
+size_t AlignedBufferCount(const WaveTrack &track,
+   sampleCount start, size_t bufferSize, sampleCount remaining)
+{
+   if (remaining <= bufferSize)
+      return remaining.as_size_t();
+
+   const auto blockStart = track.GetBlockStart(start + bufferSize);
+   if (blockStart > start)
+      return (blockStart - start).as_size_t();
+
+   return bufferSize;
+}
+
+}
+
+struct Effect::ParallelGroup
+{
+   WaveTrack *left;
+   WaveTrack *right;
+   sampleCount leftStart;
+   sampleCount rightStart;
+   sampleCount len;
+   unsigned numChannels;
+
+   // Samples written so far, and samples in the buffers
+   sampleCount pos{ 0 };
+   size_t bufferCnt{ 0 };
+   FloatBuffers inBuffer;
+   FloatBuffers outBuffer;
+};
+
 bool Effect::ProcessPass()
 {
+   PROFILE_SCOPE("Effect::ProcessPass");
    bool bGoodResult = true;
    bool isGenerator = GetType() == EffectTypeGenerate;
 
-   FloatBuffers inBuffer, outBuffer;
-   ArrayOf<float *> inBufPos, outBufPos;
+   auto &inBuffer = mInBuffer, &outBuffer = mOutBuffer;
+   auto &inBufPos = mInBufPos, &outBufPos = mOutBufPos;
 
    ChannelName map[3];
 
-   mBufferSize = 0;
    mBlockSize = 0;
 
    int count = 0;
    bool clear = false;
 
+   // Effects whose processors share no state may process all the tracks
+   // at once, unless the processors are in use for playback
+   const bool parallel = GetType() == EffectTypeProcess &&
+      SupportsParallelProcessing() &&
+      !RealtimeEffectManager::Get().RealtimeIsActive() &&
+      ThreadPool::Get().GetThreadCount() > 1;
+   std::vector<ParallelGroup> groups;
+
    const bool multichannel = mNumAudioIn > 1;
    auto range = multichannel
       ? mOutputTracks->Leaders()
@@ -1423,6 +1488,20 @@ bool Effect::ProcessPass()
             }
          }
 
+         if (parallel)
+         {
+            // Process all groups together after collecting them
+            groups.emplace_back();
+            auto &group = groups.back();
+            group.left = left;
+            group.right = right;
+            group.leftStart = leftStart;
+            group.rightStart = rightStart;
+            group.len = len;
+            group.numChannels = mNumChannels;
+            return;
+         }
+
          // Let the client know the sample rate
          SetSampleRate(left->GetRate());
 
@@ -1436,7 +1515,7 @@ bool Effect::ProcessPass()
          mBufferSize = ((max + (mBlockSize - 1)) / mBlockSize) * mBlockSize;
 
          // If the buffer size has changed, then (re)allocate the buffers
-         if (prevBufferSize != mBufferSize)
+         if (!inBuffer || prevBufferSize != mBufferSize)
          {
             // Always create the number of input buffers the client expects even if we don't have
             // the same number of channels.
@@ -1497,6 +1576,11 @@ bool Effect::ProcessPass()
       }
    );
 
+   if (bGoodResult && parallel)
+   {
+      bGoodResult = ProcessParallel(groups);
+   }
+
    if (bGoodResult && GetType() == EffectTypeGenerate)
    {
       mT1 = mT0 + mDuration;
@@ -1505,6 +1589,145 @@ bool Effect::ProcessPass()
    return bGoodResult;
 }
 
+bool Effect::ProcessParallel(std::vector<ParallelGroup> &groups)
+{
+   if (groups.empty())
+      return true;
+
+   // This may reset the block size, so ask for the block size after it
+   if (!RealtimeInitialize())
+      return false;
+   auto cleanup = finally( [&] { RealtimeFinalize(); } );
+
+   size_t max = 0;
+   sampleCount total = 0;
+   for (auto &group : groups)
+   {
+      SetSampleRate(group.left->GetRate());
+      if (!RealtimeAddProcessor(mNumAudioIn, group.left->GetRate()))
+         return false;
+      max = std::max(max, group.left->GetMaxBlockSize());
+      total += group.len;
+   }
+
+   // Unlike ProcessTrack(), there is one buffer per group, so don't double
+   // the track's block size
+   mBlockSize = SetBlockSize(max);
+   mBufferSize = ((max + (mBlockSize - 1)) / mBlockSize) * mBlockSize;
+
+   // Input buffers beyond the group's channels stay zero
+   for (auto &group : groups)
+   {
+      group.inBuffer.reinit(mNumAudioIn, mBufferSize, true);
+      group.outBuffer.reinit(mNumAudioOut, mBufferSize);
+   }
+
+   // Read and process one buffer of a group, on a worker thread
+   const auto process = [this](int index, ParallelGroup &group)
+   {
+      const auto len = AlignedBufferCount(*group.left,
+         group.leftStart + group.pos, mBufferSize, group.len - group.pos);
+      group.left->Get((samplePtr) group.inBuffer[0].get(), floatSample,
+         group.leftStart + group.pos, len);
+      if (group.right)
+      {
+         group.right->Get((samplePtr) group.inBuffer[1].get(), floatSample,
+            group.rightStart + group.pos, len);
+      }
+
+      ArrayOf<float *> inBufPos{ mNumAudioIn }, outBufPos{ mNumAudioOut };
+      for (decltype(mBlockSize) offset = 0; offset < len; offset += mBlockSize)
+      {
+         for (size_t i = 0; i < mNumAudioIn; i++)
+         {
+            inBufPos[i] = group.inBuffer[i].get() + offset;
+         }
+         for (size_t i = 0; i < mNumAudioOut; i++)
+         {
+            outBufPos[i] = group.outBuffer[i].get() + offset;
+         }
+         RealtimeProcess(index, inBufPos.get(), outBufPos.get(),
+            std::min(mBlockSize, len - offset));
+      }
+      group.bufferCnt = len;
+   };
+
+   // The worker threads fill the buffers of all unfinished groups, and then
+   // this thread writes them in track order, so that the result and the
+   // progress do not depend on the timing of the threads
+   sampleCount done = 0;
+   while (done < total)
+   {
+      RealtimeProcessStart();
+      try
+      {
+         ThreadPool::Batch batch{ ThreadPool::Get() };
+         for (size_t ii = 0; ii < groups.size(); ++ii)
+         {
+            auto &group = groups[ii];
+            group.bufferCnt = 0;
+            if (group.pos < group.len)
+            {
+               batch.Add( [&process, ii, &group]{ process(ii, group); } );
+            }
+         }
+
+         bool cancelled = false;
+         while (!batch.WaitFor(100))
+         {
+            if (!cancelled && TotalProgress(done.as_double() / total.as_double()))
+            {
+               cancelled = true;
+            }
+         }
+         batch.Wait();
+         if (cancelled)
+         {
+            return false;
+         }
+      }
+      catch( const AudacityException & WXUNUSED(e) )
+      {
+         // Pass this along to our application-level handler
+         throw;
+      }
+      catch(...)
+      {
+         // As in ProcessTrack(), maybe in third-party code
+         return false;
+      }
+      RealtimeProcessEnd();
+
+      for (auto &group : groups)
+      {
+         if (group.bufferCnt == 0)
+         {
+            continue;
+         }
+
+         const auto chans = std::min<unsigned>(mNumAudioOut, group.numChannels);
+         group.left->Set((samplePtr) group.outBuffer[0].get(), floatSample,
+            group.leftStart + group.pos, group.bufferCnt);
+         if (group.right)
+         {
+            group.right->Set(
+               (samplePtr) group.outBuffer[chans >= 2 ? 1 : 0].get(),
+               floatSample, group.rightStart + group.pos, group.bufferCnt);
+         }
+
+         group.pos += group.bufferCnt;
+         done += group.bufferCnt;
+      }
+
+      if (TotalProgress(done.as_double() / total.as_double()))
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
 bool Effect::ProcessTrack(int count,
                           ChannelNames map,
                           WaveTrack *left,
@@ -1600,8 +1823,8 @@ bool Effect::ProcessTrack(int count,
          if (inputBufferCnt == 0)
          {
             // Calculate the number of samples to get
-            inputBufferCnt =
-               limitSampleBufferSize( mBufferSize, inputRemaining );
+            inputBufferCnt = AlignedBufferCount(
+               *left, inLeftPos, mBufferSize, inputRemaining);
 
             // Fill the input buffers
             left->Get((samplePtr) inBuffer[0].get(), floatSample, inLeftPos, inputBufferCnt);
@@ -1646,6 +1869,12 @@ bool Effect::ProcessTrack(int count,
                curBlockSize += cnt;
             }
          }
+         // The buffer ends on a block boundary of the track, which need not
+         // be one of the effect's
+         else if (curBlockSize > inputBufferCnt)
+         {
+            curBlockSize = inputBufferCnt;
+         }
       }
       // We've exhausted the input samples and are now working on the delay
       else if (delayRemaining != 0)
@@ -1760,41 +1989,55 @@ bool Effect::ProcessTrack(int count,
       // Output buffers have filled
       else
       {
+         // Processors write whole blocks of the track, keeping the rest of
+         // a block for the next write
+         const auto outputBufferTarget = isProcessor
+            ? AlignedBufferCount(*left, outLeftPos, outputBufferCnt,
+               len - (outLeftPos - leftStart))
+            : outputBufferCnt;
+
          if (isProcessor)
          {
             // Write them out
-            left->Set((samplePtr) outBuffer[0].get(), floatSample, outLeftPos, outputBufferCnt);
+            left->Set((samplePtr) outBuffer[0].get(), floatSample, outLeftPos, outputBufferTarget);
             if (right)
             {
                if (chans >= 2)
                {
-                  right->Set((samplePtr) outBuffer[1].get(), floatSample, outRightPos, outputBufferCnt);
+                  right->Set((samplePtr) outBuffer[1].get(), floatSample, outRightPos, outputBufferTarget);
                }
                else
                {
-                  right->Set((samplePtr) outBuffer[0].get(), floatSample, outRightPos, outputBufferCnt);
+                  right->Set((samplePtr) outBuffer[0].get(), floatSample, outRightPos, outputBufferTarget);
                }
             }
          }
          else if (isGenerator)
          {
-            genLeft->Append((samplePtr) outBuffer[0].get(), floatSample, outputBufferCnt);
+            genLeft->Append((samplePtr) outBuffer[0].get(), floatSample, outputBufferTarget);
             if (genRight)
             {
-               genRight->Append((samplePtr) outBuffer[1].get(), floatSample, outputBufferCnt);
+               genRight->Append((samplePtr) outBuffer[1].get(), floatSample, outputBufferTarget);
             }
          }
 
-         // Reset the output buffer positions
+         // Move any samples past the written ones to the front, and reset
+         // the output buffer positions after them
+         const auto leftover = outputBufferCnt - outputBufferTarget;
          for (size_t i = 0; i < chans; i++)
          {
-            outBufPos[i] = outBuffer[i].get();
+            if (leftover > 0)
+            {
+               memmove(outBuffer[i].get(), outBuffer[i].get() + outputBufferTarget,
+                  sizeof(float) * leftover);
+            }
+            outBufPos[i] = outBuffer[i].get() + leftover;
          }
 
          // Bump to the next track position
-         outLeftPos += outputBufferCnt;
-         outRightPos += outputBufferCnt;
-         outputBufferCnt = 0;
+         outLeftPos += outputBufferTarget;
+         outRightPos += outputBufferTarget;
+         outputBufferCnt = leftover;
       }
 
       if (mNumChannels > 1)
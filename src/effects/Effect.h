@@ -140,6 +140,7 @@ class AUDACITY_DLL_API Effect /* not final */ : public wxEvtHandler,
                                        float **outbuf,
                                        size_t numSamples) override;
    bool RealtimeProcessEnd() override;
+   bool SupportsParallelProcessing() override;
 
    bool ShowInterface(wxWindow *parent, bool forceModal = false) override;
 
@@ -500,6 +501,10 @@ protected:
                      ArrayOf< float * > &inBufPos,
                      ArrayOf< float *> &outBufPos);
 
+   // Driver for client effects that support parallel processing
+   struct ParallelGroup;
+   bool ProcessParallel(std::vector<ParallelGroup> &groups);
+
  //
  // private data
  //
@@ -536,6 +541,10 @@ private:
    size_t mBlockSize;
    unsigned mNumChannels;
 
+   // Kept for all tracks of both passes, and released when Process() ends
+   FloatBuffers mInBuffer, mOutBuffer;
+   ArrayOf<float *> mInBufPos, mOutBufPos;
+
    const static wxString kUserPresetIdent;
    const static wxString kFactoryPresetIdent;
    const static wxString kCurrentSettingsIdent;
@@ -297,8 +297,26 @@ wxString EffectManager::GetCommandName(const PluginID & ID)
    return GetCommandSymbol(ID).Translation();
 }
 
+// The family and vendor are cached in the plugin registry, so there is no
+// need to load the plug-in (and dlopen its library) just to sort and group
+// the effect menus
+static const PluginDescriptor *GetEffectDescriptor(const PluginID & ID)
+{
+   auto plug = PluginManager::Get().GetPlugin(ID);
+   if (plug && plug->GetPluginType() == PluginTypeEffect)
+      return plug;
+   return nullptr;
+}
+
 wxString EffectManager::GetEffectFamilyName(const PluginID & ID)
 {
+   if (auto plug = GetEffectDescriptor(ID)) {
+      const auto family = plug->GetEffectFamily();
+      if (family.empty())
+         return {};
+      return ComponentInterfaceSymbol{ family }.Translation();
+   }
+
    auto effect = GetEffect(ID);
    if (effect)
       return effect->GetFamily().Translation();
@@ -307,6 +325,13 @@ wxString EffectManager::GetEffectFamilyName(const PluginID & ID)
 
 wxString EffectManager::GetVendorName(const PluginID & ID)
 {
+   if (auto plug = GetEffectDescriptor(ID)) {
+      const auto vendor = plug->GetVendor();
+      if (vendor.empty())
+         return {};
+      return ComponentInterfaceSymbol{ vendor }.Translation();
+   }
+
    auto effect = GetEffect(ID);
    if (effect)
       return effect->GetVendor().Translation();
@@ -57,7 +57,9 @@
 
 #include "../Experimental.h"
 
+#include <algorithm>
 #include <math.h>
+#include <thread>
 #include <vector>
 
 #include <wx/setup.h> // for wxUSE_* macros
@@ -228,7 +230,12 @@ EffectEqualization::EffectEqualization(int Options)
    : mFFTBuffer{ windowSize }
    , mFilterFuncR{ windowSize }
    , mFilterFuncI{ windowSize }
+   , mRealtimeFilterR{ Floats{ windowSize }, Floats{ windowSize } }
+   , mRealtimeFilterI{ Floats{ windowSize }, Floats{ windowSize } }
 {
+   mRealtimeFilter = 0;
+   mRealtimeFilterReaders[0] = mRealtimeFilterReaders[1] = 0;
+
    mOptions = Options;
    mGraphic = NULL;
    mDraw = NULL;
@@ -332,7 +339,76 @@ EffectType EffectEqualization::GetType()
    return EffectTypeProcess;
 }
 
+bool EffectEqualization::SupportsRealtime()
+{
+#if defined(EXPERIMENTAL_REALTIME_AUDACITY_EFFECTS)
+   return true;
+#else
+   return false;
+#endif
+}
+
 // EffectClientInterface implementation
+
+unsigned EffectEqualization::GetAudioInCount()
+{
+   return 1;
+}
+
+unsigned EffectEqualization::GetAudioOutCount()
+{
+   return 1;
+}
+
+// Only the realtime processors delay their output; report changes of that
+// delay, which follows the filter length
+sampleCount EffectEqualization::GetLatency()
+{
+   if (mSlaves.empty())
+      return 0;
+
+   const sampleCount latency = realtimeHop + (std::max<size_t>(mM, 1) - 1) / 2;
+   const auto delay = latency - mRealtimeLatency;
+   mRealtimeLatency = latency;
+   return delay;
+}
+
+bool EffectEqualization::RealtimeInitialize()
+{
+   SetBlockSize(512);
+
+   mSlaves.clear();
+   mRealtimeLatency = 0;
+   PublishRealtimeFilter();
+
+   return true;
+}
+
+bool EffectEqualization::RealtimeAddProcessor(unsigned WXUNUSED(numChannels), float WXUNUSED(sampleRate))
+{
+   EffectEqualizationState slave;
+
+   InstanceInit(slave);
+
+   mSlaves.push_back(std::move(slave));
+
+   return true;
+}
+
+bool EffectEqualization::RealtimeFinalize()
+{
+   mSlaves.clear();
+
+   return true;
+}
+
+size_t EffectEqualization::RealtimeProcess(int group,
+                                                float **inbuf,
+                                                float **outbuf,
+                                                size_t numSamples)
+{
+   return InstanceProcess(mSlaves[group], inbuf, outbuf, numSamples);
+}
 bool EffectEqualization::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mM, FilterLength );
    //S.SHUTTLE_PARAM( mCurveName, CurveName);
@@ -618,8 +694,7 @@ bool EffectEqualization::Init()
    int selcount = 0;
    double rate = 0.0;
 
-   auto trackRange =
-      TrackList::Get( *GetActiveProject() ).Selected< const WaveTrack >();
+   auto trackRange = inputTracks()->Selected< const WaveTrack >();
    if (trackRange) {
       rate = (*(trackRange.first++)) -> GetRate();
       ++selcount;
@@ -1237,8 +1312,7 @@ bool EffectEqualization::ProcessOne(int count, WaveTrack * t,
                                     sampleCount start, sampleCount len)
 {
    // create a NEW WaveTrack to hold all of the output, including 'tails' each end
-   AudacityProject *p = GetActiveProject();
-   auto output = TrackFactory::Get( *p ).NewWaveTrack(floatSample, t->GetRate());
+   auto output = mFactory->NewWaveTrack(floatSample, t->GetRate());
 
    wxASSERT(mM - 1 < windowSize);
    size_t L = windowSize - (mM - 1);   //Process L samples at a go
@@ -1278,7 +1352,8 @@ bool EffectEqualization::ProcessOne(int count, WaveTrack * t,
          for(auto j = wcopy; j < windowSize; j++)
             thisWindow[j] = 0;   //this includes the padding
 
-         Filter(windowSize, thisWindow);
+         Filter(windowSize, thisWindow, mFFTBuffer.get(),
+                mFilterFuncR.get(), mFilterFuncI.get());
 
          // Overlap - Add
          for(size_t j = 0; (j < mM - 1) && (j < wcopy); j++)
@@ -1492,10 +1567,48 @@ bool EffectEqualization::CalcFilter()
    //Back to the frequency domain so we can use it
    RealFFT(mWindowSize, outr.get(), mFilterFuncR.get(), mFilterFuncI.get());
 
+   PublishRealtimeFilter();
+
    return TRUE;
 }
 
-void EffectEqualization::Filter(size_t len, float *buffer)
+// Realtime processing reads one of two copies of the filter.  Fill the
+// other, once no hop is still being filtered with it, and then switch.
+void EffectEqualization::PublishRealtimeFilter()
+{
+   const int spare = 1 - mRealtimeFilter.load();
+   while (mRealtimeFilterReaders[spare].load() > 0)
+      std::this_thread::yield();
+
+   std::copy(mFilterFuncR.get(), mFilterFuncR.get() + windowSize,
+             mRealtimeFilterR[spare].get());
+   std::copy(mFilterFuncI.get(), mFilterFuncI.get() + windowSize,
+             mRealtimeFilterI[spare].get());
+   mRealtimeFilter.store(spare);
+}
+
+// Returns which copy of the filter to read, counted as in use until
+// ReleaseRealtimeFilter()
+int EffectEqualization::AcquireRealtimeFilter()
+{
+   while (true) {
+      const int filter = mRealtimeFilter.load();
+      ++mRealtimeFilterReaders[filter];
+      // Make sure PublishRealtimeFilter() did not pick this copy to fill
+      // before the count went up
+      if (mRealtimeFilter.load() == filter)
+         return filter;
+      --mRealtimeFilterReaders[filter];
+   }
+}
+
+void EffectEqualization::ReleaseRealtimeFilter(int filter)
+{
+   --mRealtimeFilterReaders[filter];
+}
+
+void EffectEqualization::Filter(size_t len, float *buffer, float *fftBuffer,
+   const float *filterFuncR, const float *filterFuncI)
 {
    float re,im;
    // Apply FFT
@@ -1504,20 +1617,75 @@ void EffectEqualization::Filter(size_t len, float *buffer)
 
    // Apply filter
    // DC component is purely real
-   mFFTBuffer[0] = buffer[0] * mFilterFuncR[0];
+   fftBuffer[0] = buffer[0] * filterFuncR[0];
    for(size_t i = 1; i < (len / 2); i++)
    {
       re=buffer[hFFT->BitReversed[i]  ];
       im=buffer[hFFT->BitReversed[i]+1];
-      mFFTBuffer[2*i  ] = re*mFilterFuncR[i] - im*mFilterFuncI[i];
-      mFFTBuffer[2*i+1] = re*mFilterFuncI[i] + im*mFilterFuncR[i];
+      fftBuffer[2*i  ] = re*filterFuncR[i] - im*filterFuncI[i];
+      fftBuffer[2*i+1] = re*filterFuncI[i] + im*filterFuncR[i];
    }
    // Fs/2 component is purely real
-   mFFTBuffer[1] = buffer[1] * mFilterFuncR[len/2];
+   fftBuffer[1] = buffer[1] * filterFuncR[len/2];
 
    // Inverse FFT and normalization
-   InverseRealFFTf(mFFTBuffer.get(), hFFT.get());
-   ReorderToTime(hFFT.get(), mFFTBuffer.get(), buffer);
+   InverseRealFFTf(fftBuffer, hFFT.get());
+   ReorderToTime(hFFT.get(), fftBuffer, buffer);
+}
+
+void EffectEqualization::InstanceInit(EffectEqualizationState & data)
+{
+   data.pos = 0;
+   data.input.reinit(realtimeHop, true);
+   data.output.reinit(realtimeHop, true);
+   data.overlap.reinit(windowSize, true);
+   data.window.reinit(windowSize);
+   data.fftBuffer.reinit(windowSize);
+}
+
+// The output is late by realtimeHop samples, and by the (mM - 1) / 2 of
+// the linear phase filter.  Each hop is filtered with the curve as it is
+// then, so that changes are heard within the hop.
+size_t EffectEqualization::InstanceProcess(EffectEqualizationState & data,
+                                                float **inBlock,
+                                                float **outBlock,
+                                                size_t blockLen)
+{
+   float *ibuf = inBlock[0];
+   float *obuf = outBlock[0];
+
+   float *input = data.input.get();
+   float *output = data.output.get();
+   float *overlap = data.overlap.get();
+   float *window = data.window.get();
+
+   for (size_t i = 0; i < blockLen; i++)
+   {
+      const float in = ibuf[i];
+      obuf[i] = output[data.pos];
+      input[data.pos] = in;
+
+      if (++data.pos < realtimeHop)
+         continue;
+      data.pos = 0;
+
+      // Filter the hop, padded to a window, and add it to the tails of
+      // those before; the padding holds the tail of this one
+      std::copy(input, input + realtimeHop, window);
+      std::fill(window + realtimeHop, window + windowSize, 0.0f);
+      const int filter = AcquireRealtimeFilter();
+      Filter(windowSize, window, data.fftBuffer.get(),
+             mRealtimeFilterR[filter].get(), mRealtimeFilterI[filter].get());
+      ReleaseRealtimeFilter(filter);
+      for (size_t j = 0; j < windowSize; j++)
+         overlap[j] += window[j];
+
+      std::copy(overlap, overlap + realtimeHop, output);
+      std::copy(overlap + realtimeHop, overlap + windowSize, overlap);
+      std::fill(overlap + windowSize - realtimeHop, overlap + windowSize, 0.0f);
+   }
+
+   return blockLen;
 }
 
 //
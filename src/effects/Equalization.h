@@ -19,6 +19,8 @@
 
 #include <wx/setup.h> // for wxUSE_* macros
 
+#include <atomic>
+
 #include "Effect.h"
 #include "../RealFFTf.h"
 
@@ -98,6 +100,22 @@ using EQCurveArray = std::vector<EQCurve>;
 class EffectEqualization48x;
 #endif
 
+//
+// What one realtime processor keeps between blocks:  the hop of input
+// being gathered, the filtered output of the previous hop, and the
+// overlapping tails of the filtered windows
+//
+class EffectEqualizationState
+{
+public:
+   size_t pos;
+   Floats input;
+   Floats output;
+   Floats overlap;
+   Floats window;
+   Floats fftBuffer;
+};
+
 class EffectEqualization final : public Effect,
                            public XMLTagHandler
 {
@@ -114,9 +132,21 @@ public:
    // EffectDefinitionInterface implementation
 
    EffectType GetType() override;
+   bool SupportsRealtime() override;
 
    // EffectClientInterface implementation
 
+   unsigned GetAudioInCount() override;
+   unsigned GetAudioOutCount() override;
+   sampleCount GetLatency() override;
+   bool RealtimeInitialize() override;
+   bool RealtimeAddProcessor(unsigned numChannels, float sampleRate) override;
+   bool RealtimeFinalize() override;
+   size_t RealtimeProcess(int group,
+                               float **inbuf,
+                               float **outbuf,
+                               size_t numSamples) override;
+
    bool DefineParams( ShuttleParams & S ) override;
    bool GetAutomationParameters(CommandParameters & parms) override;
    bool SetAutomationParameters(CommandParameters & parms) override;
@@ -148,6 +178,11 @@ private:
    // Number of samples in an FFT window
    static const size_t windowSize = 16384u; //MJS - work out the optimum for this at run time?  Have a dialog box for it?
 
+   // Number of samples filtered at a time in realtime processing.  Each
+   // hop still takes a whole window, but a change of the curve is heard
+   // that much sooner, and the delay is that much shorter.
+   static const size_t realtimeHop = 1024u;
+
    // Low frequency of the FFT.  20Hz is the
    // low range of human hearing
    enum {loFreqI=20};
@@ -155,7 +190,17 @@ private:
    bool ProcessOne(int count, WaveTrack * t,
                    sampleCount start, sampleCount len);
    bool CalcFilter();
-   void Filter(size_t len, float *buffer);
+   void Filter(size_t len, float *buffer, float *fftBuffer,
+               const float *filterFuncR, const float *filterFuncI);
+   void PublishRealtimeFilter();
+   int AcquireRealtimeFilter();
+   void ReleaseRealtimeFilter(int filter);
+
+   void InstanceInit(EffectEqualizationState & data);
+   size_t InstanceProcess(EffectEqualizationState & data,
+                               float **inBlock,
+                               float **outBlock,
+                               size_t blockLen);
    
    void Flatten();
    void ForceRecalc();
@@ -213,7 +258,15 @@ private:
    int mOptions;
    HFFT hFFT;
    Floats mFFTBuffer, mFilterFuncR, mFilterFuncI;
+   // Copies of the filter for realtime processing, so that CalcFilter()
+   // never writes the one being read by the audio thread
+   Floats mRealtimeFilterR[2], mRealtimeFilterI[2];
+   std::atomic<int> mRealtimeFilter;
+   std::atomic<int> mRealtimeFilterReaders[2];
    size_t mM;
+   std::vector<EffectEqualizationState> mSlaves;
+   // Delay of the realtime processors reported by GetLatency() so far
+   sampleCount mRealtimeLatency;
    wxString mCurveName;
    bool mLin;
    float mdBMax;
@@ -31,6 +31,7 @@
 #include "../widgets/valnum.h"
 #include "../widgets/AudacityMessageBox.h"
 
+#include "../BlockFile.h"
 #include "../LabelTrack.h"
 #include "../WaveTrack.h"
 
@@ -40,6 +41,34 @@
 Param( Start,  int,  wxT("Duty Cycle Start"), 3,    1,    INT_MAX, 1   );
 Param( Stop,   int,  wxT("Duty Cycle End"),   3,    1,    INT_MAX, 1   );
 
+namespace {
+// Returns how many samples from s, up to end, the summaries of blocks prove
+// to be below full scale, without reading them
+sampleCount UnclippedLength(
+   const WaveTrack &track, sampleCount s, sampleCount end)
+{
+   auto pos = s;
+   while (pos < end) {
+      sampleCount blockStart;
+      const auto pBlock = track.GetBlockAt(pos, blockStart);
+      if (!pBlock) {
+         // Zeroes between clips
+         if (blockStart < 0 || blockStart >= end)
+            return end - s;
+         pos = blockStart;
+         continue;
+      }
+      if (!pBlock->IsSummaryAvailable())
+         break;
+      const auto results = pBlock->GetMinMaxRMS();
+      if (results.max >= MAX_AUDIO || results.min <= -MAX_AUDIO)
+         break;
+      pos = blockStart + pBlock->GetLength();
+   }
+   return std::min(pos, end) - s;
+}
+}
+
 EffectFindClipping::EffectFindClipping()
 {
    mStart = DEF_Start;
@@ -190,6 +219,17 @@ bool EffectFindClipping::ProcessOne(LabelTrack * lt,
             break;
          }
 
+         // Unless a long enough run may be ending, skip whole blocks that
+         // cannot contain clipping
+         if (startrun < mStart) {
+            const auto skip = UnclippedLength(*wt, start + s, start + len);
+            if (skip > 0) {
+               startrun = 0;
+               s += skip;
+               continue;
+            }
+         }
+
          block = limitSampleBufferSize( blockSize, len - s );
 
          wt->Get((samplePtr)buffer.get(), floatSample, start + s, block);
@@ -28,6 +28,7 @@
 #include <wx/stattext.h>
 #include <wx/valgen.h>
 
+#include "../BlockFile.h"
 #include "../Prefs.h"
 #include "../ProjectFileManager.h"
 #include "../Shuttle.h"
@@ -523,6 +524,9 @@ bool EffectNormalize::AnalyseTrack(const WaveTrack * track, const wxString &msg,
 bool EffectNormalize::AnalyseTrackData(const WaveTrack * track, const wxString &msg,
                                 double &progress, AnalyseOperation op, float &offset)
 {
+   if(op == ANALYSE_DC)
+      return AnalyseTrackDataDC(track, msg, progress, offset);
+
    bool rc = true;
 
    //Transform the marker timepoints to samples
@@ -592,6 +596,64 @@ bool EffectNormalize::AnalyseTrackData(const WaveTrack * track, const wxString &
    return rc;
 }
 
+//AnalyseTrackDataDC() finds the DC offset like AnalyseTrackData(), but
+//takes the sums of whole blocks from their summaries, reading samples
+//only for the blocks partly selected
+bool EffectNormalize::AnalyseTrackDataDC(const WaveTrack * track,
+   const wxString &msg, double &progress, float &offset)
+{
+   bool rc = true;
+
+   auto start = track->TimeToLongSamples(mCurT0);
+   auto end = track->TimeToLongSamples(mCurT1);
+   auto len = (end - start).as_double();
+
+   Floats buffer{ track->GetMaxBlockSize() };
+
+   mSum   = 0.0;
+   mCount = 0;
+
+   auto s = start;
+   while (s < end) {
+      sampleCount blockStart;
+      const auto pBlock = track->GetBlockAt(s, blockStart);
+      if (!pBlock) {
+         //Zeroes between clips are not counted
+         if (blockStart < 0 || blockStart >= end)
+            break;
+         s = blockStart;
+         continue;
+      }
+
+      const auto blockEnd = blockStart + pBlock->GetLength();
+      if (s == blockStart && blockEnd <= end) {
+         mSum += pBlock->GetSum();
+         mCount += pBlock->GetLength();
+         s = blockEnd;
+      }
+      else {
+         const auto block = limitSampleBufferSize(
+            pBlock->GetLength(), std::min(blockEnd, end) - s);
+         track->Get((samplePtr) buffer.get(), floatSample, s, block);
+         AnalyseDataDC(buffer.get(), block);
+         s += block;
+      }
+
+      if (TotalProgress(progress +
+                        ((s - start).as_double() / len)/double(2*GetNumWaveTracks()), msg)) {
+         rc = false;
+         break;
+      }
+   }
+   if( mCount > 0 )
+      offset = -mSum / mCount.as_double();
+   else
+      offset = 0.0;
+
+   progress += 1.0/double(2*GetNumWaveTracks());
+   return rc;
+}
+
 //ProcessOne() takes a track, transforms it to bunch of buffer-blocks,
 //and executes ProcessData, on it...
 // uses mMult and offset to normalize a track.
@@ -70,6 +70,8 @@ private:
                      double &progress, float &offset, float &extent);
    bool AnalyseTrackData(const WaveTrack * track, const wxString &msg, double &progress,
                      AnalyseOperation op, float &offset);
+   bool AnalyseTrackDataDC(const WaveTrack * track, const wxString &msg,
+                     double &progress, float &offset);
    void AnalyseDataDC(float *buffer, size_t len);
 #ifdef EXPERIMENTAL_R128_NORM
    void AnalyseDataLoudness(float *buffer, size_t len);
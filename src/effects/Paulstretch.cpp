@@ -18,6 +18,9 @@
 #include "Paulstretch.h"
 
 #include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
 
 #include <math.h>
 #include <float.h>
@@ -31,6 +34,7 @@
 #include "../widgets/valnum.h"
 #include "../widgets/AudacityMessageBox.h"
 #include "../Prefs.h"
+#include "../ThreadPool.h"
 
 #include "../WaveTrack.h"
 
@@ -45,12 +49,17 @@ Param( Time,   float,   wxT("Time Resolution"),  0.25f,   0.00099f,  FLT_MAX, 1
 class PaulStretch
 {
 public:
-   PaulStretch(float rap_, size_t in_bufsize_, float samplerate_);
+   PaulStretch(float rap_, size_t in_bufsize_, float samplerate_,
+      unsigned seed);
    //in_bufsize is also a half of a FFT buffer (in samples)
    virtual ~PaulStretch();
 
    void process(float *smps, size_t nsmps);
 
+   // Restart the random phases, so that a buffer may be computed again
+   // exactly as before
+   void seed(unsigned value) { random_engine.seed(value); }
+
    size_t get_nsamples();//how many samples are required to be added in the pool next time
    size_t get_nsamples_for_fill();//how many samples are required to be added for a complete buffer refill (at start of the song or after seek)
 
@@ -77,6 +86,9 @@ private:
    double remained_samples;//how many fraction of samples has remained (0..1)
 
    const Floats fft_smps, fft_c, fft_s, fft_freq, fft_tmp;
+
+   // Each object has its own, so that objects may run on several threads
+   std::minstd_rand random_engine;
 };
 
 //
@@ -331,62 +343,128 @@ bool EffectPaulstretch::ProcessOne(WaveTrack *track,double t0,double t1,int coun
       // This encloses all the allocations of buffers, including those in
       // the constructor of the PaulStretch object
 
-      PaulStretch stretch(amount, stretch_buf_size, track->GetRate());
-
-      auto nget = stretch.get_nsamples_for_fill();
-
-      auto bufsize = stretch.poolsize;
-      Floats buffer0{ bufsize };
-      float *bufferptr0 = buffer0.get();
-      bool first_time = true;
+      PaulStretch stretch(amount, stretch_buf_size, track->GetRate(), rand());
 
+      const auto bufsize = stretch.poolsize;
+      const auto out_bufsize = stretch.out_bufsize;
       const auto fade_len = std::min<size_t>(100, bufsize / 2 - 1);
-      bool cancelled = false;
 
-      {
+      // Input position where the pool ends for each output buffer.  The
+      // first buffer fills the whole pool.
+      std::vector<sampleCount> poolEnds{ start + stretch.get_nsamples_for_fill() };
+      while (poolEnds.back() < end)
+         poolEnds.push_back(poolEnds.back() + stretch.get_nsamples());
+      const auto nFrames = poolEnds.size();
+
+      // Runs of output buffers are computed on worker threads, each with
+      // its own PaulStretch.  Each run but the first starts by refilling
+      // the pool and computing the buffer before, then discards it.  The
+      // random phases of every buffer are seeded from its index, so that
+      // buffer is the same one the previous run ended with, and the first
+      // buffer kept overlaps it just as with a single PaulStretch.
+      const unsigned baseSeed = rand();
+      const auto frameSeed = [baseSeed](size_t index) {
+         return baseSeed ^ unsigned(index * 2654435761u);
+      };
+      const size_t framesPerRun =
+         std::max<size_t>(8, (1 << 20) / out_bufsize);
+      struct Run {
+         size_t first, last;
+         Floats output;
+      };
+      auto &pool = ThreadPool::Get();
+      std::vector<Run> runs(pool.GetThreadCount());
+      std::atomic<size_t> framesDone{ 0 };
+      std::atomic<bool> cancelling{ false };
+
+      const auto compute = [&](Run &run) {
+         PaulStretch runStretch(amount, stretch_buf_size, track->GetRate(), baseSeed);
+         Floats buffer0{ bufsize };
          Floats fade_track_smps{ fade_len };
-         decltype(len) s=0;
-
-         while (s < len) {
-            track->Get((samplePtr)bufferptr0, floatSample, start + s, nget);
-            stretch.process(buffer0.get(), nget);
-
-            if (first_time) {
-               stretch.process(buffer0.get(), 0);
-            };
-
-            s += nget;
+         // Fill the pool as for the buffer before the first, or, at the
+         // start of the selection, as for the first buffer.  Buffer frame
+         // takes seed frame + 1, and the start of the selection seed 0.
+         const auto poolFrame = (run.first == 0) ? 0 : run.first - 1;
+         track->Get((samplePtr)buffer0.get(), floatSample,
+            poolEnds[poolFrame] - bufsize, bufsize);
+         runStretch.seed(frameSeed(run.first));
+         runStretch.process(buffer0.get(), bufsize);
+
+         auto out = run.output.get();
+         for (auto frame = run.first; frame < run.last; ++frame) {
+            if (cancelling)
+               return;
+            runStretch.seed(frameSeed(frame + 1));
+            if (frame == 0)
+               runStretch.process(buffer0.get(), 0);
+            else {
+               const auto nget =
+                  (poolEnds[frame] - poolEnds[frame - 1]).as_size_t();
+               track->Get((samplePtr)buffer0.get(), floatSample,
+                  poolEnds[frame - 1], nget);
+               runStretch.process(buffer0.get(), nget);
+            }
 
-            if (first_time){//blend the the start of the selection
+            if (frame == 0) {//blend the the start of the selection
                track->Get((samplePtr)fade_track_smps.get(), floatSample, start, fade_len);
-               first_time = false;
                for (size_t i = 0; i < fade_len; i++){
                   float fi = (float)i / (float)fade_len;
-                  stretch.out_buf[i] =
-                     stretch.out_buf[i] * fi + (1.0 - fi) * fade_track_smps[i];
+                  runStretch.out_buf[i] =
+                     runStretch.out_buf[i] * fi + (1.0 - fi) * fade_track_smps[i];
                }
             }
-            if (s >= len){//blend the end of the selection
+            if (frame == nFrames - 1) {//blend the end of the selection
                track->Get((samplePtr)fade_track_smps.get(), floatSample, end - fade_len, fade_len);
                for (size_t i = 0; i < fade_len; i++){
                   float fi = (float)i / (float)fade_len;
                   auto i2 = bufsize / 2 - 1 - i;
-                  stretch.out_buf[i2] =
-                     stretch.out_buf[i2] * fi + (1.0 - fi) *
+                  runStretch.out_buf[i2] =
+                     runStretch.out_buf[i2] * fi + (1.0 - fi) *
                      fade_track_smps[fade_len - 1 - i];
                }
             }
 
-            outputTrack->Append((samplePtr)stretch.out_buf.get(), floatSample, stretch.out_bufsize);
+            std::copy(runStretch.out_buf.get(),
+               runStretch.out_buf.get() + out_bufsize, out);
+            out += out_bufsize;
+            ++framesDone;
+         }
+      };
+
+      bool cancelled = false;
+      size_t frame = 0;
+      while (!cancelled && frame < nFrames) {
+         size_t nRuns = 0;
+         {
+            ThreadPool::Batch batch{ pool };
+            for (; nRuns < runs.size() && frame < nFrames; ++nRuns) {
+               auto &run = runs[nRuns];
+               run.first = frame;
+               run.last = frame = std::min(nFrames, frame + framesPerRun);
+               if (!run.output)
+                  run.output.reinit(framesPerRun * out_bufsize);
+               batch.Add( [&compute, &run]{ compute(run); } );
+            }
 
-            nget = stretch.get_nsamples();
-            if (TrackProgress(count,
-               s.as_double() / len.as_double()
-            )) {
-               cancelled = true;
-               break;
+            while (!batch.WaitFor(100)) {
+               if (!cancelled && TrackProgress(count,
+                     double(framesDone) / double(nFrames)))
+                  cancelled = true, cancelling = true;
             }
+            batch.Wait();
          }
+
+         if (!cancelled)
+            // Append in order of time
+            for (size_t ii = 0; ii < nRuns; ++ii) {
+               const auto &run = runs[ii];
+               outputTrack->Append((samplePtr)run.output.get(), floatSample,
+                  (run.last - run.first) * out_bufsize);
+            }
+
+         if (!cancelled && TrackProgress(count,
+               double(framesDone) / double(nFrames)))
+            cancelled = true;
       }
 
       if (!cancelled){
@@ -408,7 +486,8 @@ bool EffectPaulstretch::ProcessOne(WaveTrack *track,double t0,double t1,int coun
 /*************************************************************/
 
 
-PaulStretch::PaulStretch(float rap_, size_t in_bufsize_, float samplerate_ )
+PaulStretch::PaulStretch(float rap_, size_t in_bufsize_, float samplerate_,
+   unsigned seed)
    : samplerate { samplerate_ }
    , rap { std::max(1.0f, rap_) }
    , in_bufsize { in_bufsize_ }
@@ -423,6 +502,7 @@ PaulStretch::PaulStretch(float rap_, size_t in_bufsize_, float samplerate_ )
    , fft_s { poolsize, true }
    , fft_freq { poolsize, true }
    , fft_tmp { poolsize }
+   , random_engine { seed }
 {
 }
 
@@ -463,7 +543,7 @@ void PaulStretch::process(float *smps, size_t nsmps)
    //put randomize phases to frequencies and do a IFFT
    float inv_2p15_2pi = 1.0 / 16384.0 * (float)M_PI;
    for (size_t i = 1; i < poolsize / 2; i++) {
-      unsigned int random = (rand()) & 0x7fff;
+      unsigned int random = (random_engine()) & 0x7fff;
       float phase = random * inv_2p15_2pi;
       float s = fft_freq[i] * sin(phase);
       float c = fft_freq[i] * cos(phase);
@@ -16,9 +16,20 @@
 #include "audacity/EffectInterface.h"
 #include "MemoryX.h"
 
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <wx/time.h>
 
+#if defined(__WXMSW__)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 class RealtimeEffectState
 {
 public:
@@ -32,6 +43,9 @@ public:
    size_t RealtimeProcess(int group,
       unsigned chans, float **inbuf, float **outbuf, size_t numSamples);
    bool IsRealtimeActive();
+   // Adds what the effect newly reports to the delay it gives its groups,
+   // and returns the total
+   sampleCount UpdateLatency();
 
 private:
    EffectClientInterface &mEffect;
@@ -40,8 +54,157 @@ private:
    int mCurrentProcessor;
 
    std::atomic<int> mRealtimeSuspendCount{ 1 };    // Effects are initially suspended
+
+   sampleCount mLatency{ 0 };
+
+   // Serializes the groups for effects whose processors share state
+   const bool mParallel;
+   std::mutex mProcessMutex;
+};
+
+// Threads that help the audio thread through the groups of each cycle.
+// They wait for Run() to give them work, then take groups until none are
+// left, so that a cycle costs about as much as its slowest group.
+class RealtimeWorkers
+{
+public:
+   using Process = void (*)(void *context, size_t ii);
+
+   explicit RealtimeWorkers(size_t nThreads);
+   RealtimeWorkers(const RealtimeWorkers&) = delete;
+   RealtimeWorkers &operator= (const RealtimeWorkers&) = delete;
+   ~RealtimeWorkers();
+
+   size_t GetThreadCount() const { return mThreads.size(); }
+
+   // Calls process(context, ii) for each ii below count, on the workers
+   // and on the calling thread, and returns when all calls are done
+   void Run(size_t count, Process process, void *context);
+
+private:
+   void Work();
+   void Help();
+
+   std::mutex mMutex;
+   std::condition_variable mStart;
+   std::condition_variable mDone;
+   std::vector<std::thread> mThreads;
+   bool mStopping{ false };
+   unsigned long mGeneration{ 0 };
+   // Workers between waking for a generation and finishing their part
+   size_t mBusy{ 0 };
+
+   // The current generation, which Run() changes only when no worker is
+   // busy
+   size_t mCount{ 0 };
+   Process mProcess{ nullptr };
+   void *mContext{ nullptr };
+   std::atomic<size_t> mNext{ 0 };
+   std::atomic<size_t> mRemaining{ 0 };
 };
 
+// Ask for the priority of audio, which may be refused without the
+// privilege; the workers then run at normal priority
+static void RaiseToRealtimePriority(std::thread &thread)
+{
+#if defined(__WXMSW__)
+   SetThreadPriority(thread.native_handle(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+   sched_param param{};
+   param.sched_priority =
+      (sched_get_priority_min(SCHED_FIFO) + sched_get_priority_max(SCHED_FIFO)) / 2;
+   pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param);
+#endif
+}
+
+RealtimeWorkers::RealtimeWorkers(size_t nThreads)
+{
+   mThreads.reserve(nThreads);
+   for (size_t ii = 0; ii < nThreads; ++ii)
+   {
+      mThreads.emplace_back([this]{ Work(); });
+      RaiseToRealtimePriority(mThreads.back());
+   }
+}
+
+RealtimeWorkers::~RealtimeWorkers()
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mStopping = true;
+   }
+   mStart.notify_all();
+   for (auto &thread : mThreads)
+      thread.join();
+}
+
+void RealtimeWorkers::Run(size_t count, Process process, void *context)
+{
+   if (count <= 1)
+   {
+      for (size_t ii = 0; ii < count; ++ii)
+         process(context, ii);
+      return;
+   }
+
+   {
+      // A worker late for the last generation must leave before this one
+      // is set up
+      std::unique_lock<std::mutex> lock{ mMutex };
+      mDone.wait(lock, [this]{ return mBusy == 0; });
+      mCount = count;
+      mProcess = process;
+      mContext = context;
+      mNext = 0;
+      mRemaining = count;
+      ++mGeneration;
+   }
+   mStart.notify_all();
+
+   Help();
+
+   std::unique_lock<std::mutex> lock{ mMutex };
+   mDone.wait(lock, [this]{ return mRemaining == 0; });
+}
+
+void RealtimeWorkers::Work()
+{
+   unsigned long seen = 0;
+   std::unique_lock<std::mutex> lock{ mMutex };
+   while (true)
+   {
+      mStart.wait(lock, [&]{ return mStopping || mGeneration != seen; });
+      if (mStopping)
+         return;
+      seen = mGeneration;
+      ++mBusy;
+
+      lock.unlock();
+      Help();
+      lock.lock();
+
+      if (--mBusy == 0)
+         mDone.notify_all();
+   }
+}
+
+void RealtimeWorkers::Help()
+{
+   size_t ii;
+   while ((ii = mNext++) < mCount)
+   {
+      mProcess(mContext, ii);
+      if (--mRemaining == 0)
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         mDone.notify_all();
+      }
+   }
+}
+
+// The most workers to start; more rarely pay for their wake-ups
+static const size_t MaxRealtimeWorkers = 3;
+
 RealtimeEffectManager & RealtimeEffectManager::Get()
 {
    static RealtimeEffectManager rem;
@@ -194,6 +357,15 @@ void RealtimeEffectManager::RealtimeAddProcessor(int group, unsigned chans, floa
 
    mRealtimeChans.push_back(chans);
    mRealtimeRates.push_back(rate);
+
+   // With a second group there is work to share
+   if (group == 1 && !mWorkers)
+   {
+      const size_t nThreads = std::min(MaxRealtimeWorkers,
+         std::max<size_t>(1, std::thread::hardware_concurrency()) - 1);
+      if (nThreads > 0)
+         mWorkers = std::make_unique<RealtimeWorkers>(nThreads);
+   }
 }
 
 void RealtimeEffectManager::RealtimeFinalize()
@@ -212,6 +384,9 @@ void RealtimeEffectManager::RealtimeFinalize()
    mRealtimeChans.clear();
    mRealtimeRates.clear();
 
+   // The stream is stopped, so the workers are idle
+   mWorkers.reset();
+
    // No longer active
    mRealtimeActive = false;
 }
@@ -283,7 +458,7 @@ void RealtimeEffectManager::RealtimeProcessStart()
 //
 // This will be called in a different thread than the main GUI thread.
 //
-size_t RealtimeEffectManager::RealtimeProcess(int group, unsigned chans, float **buffers, size_t numSamples)
+size_t RealtimeEffectManager::RealtimeProcess(const Group *groups, size_t nGroups)
 {
    // Protect ourselves from the main thread
    mRealtimeLock.Enter();
@@ -293,13 +468,57 @@ size_t RealtimeEffectManager::RealtimeProcess(int group, unsigned chans, float *
    if (mRealtimeSuspended || mStates.empty())
    {
       mRealtimeLock.Leave();
-      return numSamples;
+      return 0;
    }
 
    // Remember when we started so we can calculate the amount of latency we
    // are introducing
    wxMilliClock_t start = wxGetUTCTimeMillis();
 
+   struct Context
+   {
+      RealtimeEffectManager *manager;
+      const Group *groups;
+   } context{ this, groups };
+   const auto process = [](void *pContext, size_t ii) {
+      auto &context = *static_cast<Context*>(pContext);
+      context.manager->RealtimeProcessGroup(context.groups[ii]);
+   };
+
+   if (mWorkers)
+      mWorkers->Run(nGroups, process, &context);
+   else
+   {
+      for (size_t ii = 0; ii < nGroups; ++ii)
+         process(&context, ii);
+   }
+
+   // Remember the latency
+   mRealtimeLatency = (int) (wxGetUTCTimeMillis() - start).GetValue();
+
+   // Total the delays of the effects that were applied, now that the
+   // workers are done with them
+   sampleCount delay = 0;
+   for (auto &state : mStates)
+   {
+      const auto latency = state->UpdateLatency();
+      if (state->IsRealtimeActive())
+         delay += latency;
+   }
+
+   mRealtimeLock.Leave();
+
+   return delay.as_size_t();
+}
+
+// Called from RealtimeProcess(), perhaps on a worker thread, with the lock
+// held by the audio thread
+void RealtimeEffectManager::RealtimeProcessGroup(const Group &group)
+{
+   const auto chans = group.chans;
+   const auto buffers = group.buffers;
+   const auto numSamples = group.numSamples;
+
    // Allocate the in/out buffer arrays
    float **ibuf = (float **) alloca(chans * sizeof(float *));
    float **obuf = (float **) alloca(chans * sizeof(float *));
@@ -319,7 +538,7 @@ size_t RealtimeEffectManager::RealtimeProcess(int group, unsigned chans, float *
    {
       if (state->IsRealtimeActive())
       {
-         state->RealtimeProcess(group, chans, ibuf, obuf, numSamples);
+         state->RealtimeProcess(group.group, chans, ibuf, obuf, numSamples);
          called++;
       }
 
@@ -344,15 +563,9 @@ size_t RealtimeEffectManager::RealtimeProcess(int group, unsigned chans, float *
       }
    }
 
-   // Remember the latency
-   mRealtimeLatency = (int) (wxGetUTCTimeMillis() - start).GetValue();
-
-   mRealtimeLock.Leave();
-
    //
    // This is wrong...needs to handle tails
    //
-   return numSamples;
 }
 
 //
@@ -382,8 +595,14 @@ int RealtimeEffectManager::GetRealtimeLatency()
    return mRealtimeLatency;
 }
 
+size_t RealtimeEffectManager::GetRealtimeConcurrency()
+{
+   return mWorkers ? mWorkers->GetThreadCount() + 1 : 1;
+}
+
 RealtimeEffectState::RealtimeEffectState( EffectClientInterface &effect )
    : mEffect{ effect }
+   , mParallel{ effect.SupportsParallelProcessing() }
 {
 }
 
@@ -419,6 +638,7 @@ bool RealtimeEffectState::RealtimeAddProcessor(int group, unsigned chans, float
    {
       mCurrentProcessor = 0;
       mGroupProcessor.clear();
+      mLatency = 0;
    }
 
    // Remember the processor starting index
@@ -506,6 +726,11 @@ size_t RealtimeEffectState::RealtimeProcess(int group,
 
    int processor = mGroupProcessor[group];
 
+   // Other groups may be in this effect at the same time, on other threads
+   std::unique_lock<std::mutex> lock{ mProcessMutex, std::defer_lock };
+   if (!mParallel)
+      lock.lock();
+
    // Call the client until we run out of input or output channels
    while (ichans > 0 && ochans > 0)
    {
@@ -599,3 +824,11 @@ bool RealtimeEffectState::IsRealtimeActive()
 {
    return mRealtimeSuspendCount == 0;
 }
+
+// Effects report latency once, as it arises, so it is asked for after
+// each cycle and kept
+sampleCount RealtimeEffectState::UpdateLatency()
+{
+   mLatency += mEffect.GetLatency();
+   return mLatency;
+}
@@ -17,12 +17,22 @@
 
 class EffectClientInterface;
 class RealtimeEffectState;
+class RealtimeWorkers;
 
 class AUDACITY_DLL_API RealtimeEffectManager final
 {
 public:
    using EffectArray = std::vector <EffectClientInterface*> ;
 
+   /// The buffers of one group of channels, as given to RealtimeProcess()
+   struct Group
+   {
+      int group;
+      unsigned chans;
+      float **buffers;
+      size_t numSamples;
+   };
+
    /** Get the singleton instance of the RealtimeEffectManager. **/
    static RealtimeEffectManager & Get();
 
@@ -38,14 +48,22 @@ public:
    void RealtimeSuspend();
    void RealtimeResume();
    void RealtimeProcessStart();
-   size_t RealtimeProcess(int group, unsigned chans, float **buffers, size_t numSamples);
+   /// Applies the chain to each group, in place.  The groups are
+   /// independent, so they are spread over the worker threads as well as
+   /// the calling one; returns when all are done, with the number of
+   /// samples by which the chain delays them.
+   size_t RealtimeProcess(const Group *groups, size_t nGroups);
    void RealtimeProcessEnd();
    int GetRealtimeLatency();
+   /// How many groups RealtimeProcess() can work on at once
+   size_t GetRealtimeConcurrency();
 
 private:
    RealtimeEffectManager();
    ~RealtimeEffectManager();
 
+   void RealtimeProcessGroup(const Group &group);
+
    wxCriticalSection mRealtimeLock;
    std::vector< std::unique_ptr<RealtimeEffectState> > mStates;
    int mRealtimeLatency;
@@ -53,6 +71,7 @@ private:
    bool mRealtimeActive;
    std::vector<unsigned> mRealtimeChans;
    std::vector<double> mRealtimeRates;
+   std::unique_ptr<RealtimeWorkers> mWorkers;
 };
 
 #endif
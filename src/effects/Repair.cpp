@@ -32,6 +32,11 @@ the audio, rather than actually finding the clicks.
 #include "../WaveTrack.h"
 #include "../widgets/AudacityMessageBox.h"
 
+// Longest selection to repair, in samples, so that the time taken does not
+// grow with the sample rate.  The interpolation takes time in proportion to
+// the length, and does poorly with longer gaps anyway.
+static const size_t MaxRepairSamples = 24000;
+
 EffectRepair::EffectRepair()
 {
 }
@@ -87,20 +92,21 @@ bool EffectRepair::Process()
          const auto repair0 = track->TimeToLongSamples(repair_t0);
          const auto repair1 = track->TimeToLongSamples(repair_t1);
          const auto repairLen = repair1 - repair0;
-         if (repairLen > 128) {
-            ::Effect::MessageBox(_("The Repair effect is intended to be used on very short sections of damaged audio (up to 128 samples).\n\nZoom in and select a tiny fraction of a second to repair."));
+         const double rate = track->GetRate();
+         if (repairLen > MaxRepairSamples) {
+            ::Effect::MessageBox(wxString::Format(_("The Repair effect is intended to be used on short sections of damaged audio (up to %d samples).\n\nZoom in and select a fraction of a second to repair."),
+               (int)MaxRepairSamples));
             bGoodResult = false;
             break;
          }
 
-         const double rate = track->GetRate();
          const double spacing = std::max(repair_deltat * 2, 128. / rate);
          const double t0 = std::max(repair_t0 - spacing, trackStart);
          const double t1 = std::min(repair_t1 + spacing, trackEnd);
 
          const auto s0 = track->TimeToLongSamples(t0);
          const auto s1 = track->TimeToLongSamples(t1);
-         // The difference is at most 2 * 128:
+         // The difference is at most twice the repair length, or 128:
          const auto repairStart = (repair0 - s0).as_size_t();
          const auto len = s1 - s0;
 
@@ -112,10 +118,10 @@ bool EffectRepair::Process()
          }
 
          if (!ProcessOne(count, track, s0,
-                         // len is at most 5 * 128.
+                         // len is at most five times the repair length.
                          len.as_size_t(),
                          repairStart,
-                         // repairLen is at most 128.
+                         // repairLen is at most MaxRepairSamples.
                          repairLen.as_size_t() )) {
             bGoodResult = false;
             break;
@@ -136,7 +142,10 @@ bool EffectRepair::ProcessOne(int count, WaveTrack * track,
 {
    Floats buffer{ len };
    track->Get((samplePtr) buffer.get(), floatSample, start, len);
-   InterpolateAudio(buffer.get(), len, repairStart, repairLen);
+   // TrackProgress returns true on Cancel.
+   if (!InterpolateAudio(buffer.get(), len, repairStart, repairLen,
+         [&](double frac){ return !TrackProgress(count, frac); }))
+      return false;
    track->Set((samplePtr)&buffer[repairStart], floatSample,
               start + repairStart, repairLen);
    return !TrackProgress(count, 1.0); // TrackProgress returns true on Cancel.
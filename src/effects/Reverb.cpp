@@ -85,6 +85,122 @@ struct Reverb_priv_t
    float *wet[2];
 };
 
+static size_t BLOCK = 16384;
+
+// The reverbs of one processor, for each of its channels, and the
+// parameters they were made with
+struct EffectReverbState
+{
+   EffectReverbState(double sampleRate, unsigned numChans,
+                     const EffectReverb::Params & params);
+   // Makes reverbs that Set() can change without allocating
+   EffectReverbState(double sampleRate, unsigned numChans,
+                     const EffectReverb::Params & params,
+                     double maxPreDelay);
+   EffectReverbState(const EffectReverbState &) = delete;
+   EffectReverbState &operator= (const EffectReverbState &) = delete;
+   ~EffectReverbState();
+
+   void Set(const EffectReverb::Params & params);
+
+   double mSampleRate;
+   unsigned mNumChans;
+   EffectReverb::Params mParams;
+   Reverb_priv_t mP[2];
+};
+
+EffectReverbState::EffectReverbState(double sampleRate, unsigned numChans,
+                                     const EffectReverb::Params & params)
+   : mSampleRate{ sampleRate }
+   , mNumChans{ numChans }
+   , mParams( params )
+{
+   memset(mP, 0, sizeof(mP));
+
+   bool isStereo = mNumChans == 2;
+   for (unsigned int i = 0; i < mNumChans; i++)
+   {
+      reverb_create(&mP[i].reverb,
+                    mSampleRate,
+                    mParams.mWetGain,
+                    mParams.mRoomSize,
+                    mParams.mReverberance,
+                    mParams.mHfDamping,
+                    mParams.mPreDelay,
+                    mParams.mStereoWidth * (isStereo ? 1 : 0),
+                    mParams.mToneLow,
+                    mParams.mToneHigh,
+                    BLOCK,
+                    mP[i].wet);
+   }
+}
+
+EffectReverbState::EffectReverbState(double sampleRate, unsigned numChans,
+                                     const EffectReverb::Params & params,
+                                     double maxPreDelay)
+   : mSampleRate{ sampleRate }
+   , mNumChans{ numChans }
+{
+   memset(mP, 0, sizeof(mP));
+
+   // A stereo processor keeps the filters for stereo width, even while the
+   // width is zero
+   for (unsigned int i = 0; i < mNumChans; i++)
+   {
+      reverb_allocate(&mP[i].reverb,
+                      mSampleRate,
+                      maxPreDelay,
+                      mNumChans,
+                      BLOCK,
+                      mP[i].wet);
+   }
+
+   Set(params);
+}
+
+void EffectReverbState::Set(const EffectReverb::Params & params)
+{
+   mParams = params;
+
+   bool isStereo = mNumChans == 2;
+   for (unsigned int i = 0; i < mNumChans; i++)
+   {
+      reverb_set(&mP[i].reverb,
+                 mSampleRate,
+                 mParams.mWetGain,
+                 mParams.mRoomSize,
+                 mParams.mReverberance,
+                 mParams.mHfDamping,
+                 mParams.mPreDelay,
+                 mParams.mStereoWidth * (isStereo ? 1 : 0),
+                 mParams.mToneLow,
+                 mParams.mToneHigh);
+   }
+}
+
+EffectReverbState::~EffectReverbState()
+{
+   for (unsigned int i = 0; i < mNumChans; i++)
+   {
+      reverb_delete(&mP[i].reverb);
+   }
+}
+
+// Whether reverbs made with one set of parameters would differ from those
+// made with the other; the dry gain is applied afterwards
+static bool SameReverb(const EffectReverb::Params & a,
+                       const EffectReverb::Params & b)
+{
+   return a.mRoomSize == b.mRoomSize &&
+          a.mPreDelay == b.mPreDelay &&
+          a.mReverberance == b.mReverberance &&
+          a.mHfDamping == b.mHfDamping &&
+          a.mToneLow == b.mToneLow &&
+          a.mToneHigh == b.mToneHigh &&
+          a.mWetGain == b.mWetGain &&
+          a.mStereoWidth == b.mStereoWidth;
+}
+
 //
 // EffectReverb
 //
@@ -107,6 +223,8 @@ BEGIN_EVENT_TABLE(EffectReverb, wxEvtHandler)
 
 #undef SpinSliderEvent 
 
+   EVT_CHECKBOX(ID_WetOnly, EffectReverb::OnWetOnly)
+
 END_EVENT_TABLE()
 
 EffectReverb::EffectReverb()
@@ -155,6 +273,15 @@ EffectType EffectReverb::GetType()
    return EffectTypeProcess;
 }
 
+bool EffectReverb::SupportsRealtime()
+{
+#if defined(EXPERIMENTAL_REALTIME_AUDACITY_EFFECTS)
+   return true;
+#else
+   return false;
+#endif
+}
+
 // EffectClientInterface implementation
 
 unsigned EffectReverb::GetAudioInCount()
@@ -167,111 +294,73 @@ unsigned EffectReverb::GetAudioOutCount()
    return mParams.mStereoWidth ? 2 : 1;
 }
 
-static size_t BLOCK = 16384;
-
 bool EffectReverb::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelNames chanMap)
 {
-   bool isStereo = false;
-   mNumChans = 1;
+   unsigned numChans = 1;
    if (chanMap && chanMap[0] != ChannelNameEOL && chanMap[1] == ChannelNameFrontRight)
    {
-      isStereo = true;
-      mNumChans = 2;
+      numChans = 2;
    }
 
-   mP = (Reverb_priv_t *) calloc(sizeof(*mP), mNumChans);
-
-   for (unsigned int i = 0; i < mNumChans; i++)
-   {
-      reverb_create(&mP[i].reverb,
-                    mSampleRate,
-                    mParams.mWetGain,
-                    mParams.mRoomSize,
-                    mParams.mReverberance,
-                    mParams.mHfDamping,
-                    mParams.mPreDelay,
-                    mParams.mStereoWidth * (isStereo ? 1 : 0),
-                    mParams.mToneLow,
-                    mParams.mToneHigh,
-                    BLOCK,
-                    mP[i].wet);
-   }
+   mMaster = std::make_unique<EffectReverbState>(mSampleRate, numChans, mParams);
 
    return true;
 }
 
 bool EffectReverb::ProcessFinalize()
 {
-   for (unsigned int i = 0; i < mNumChans; i++)
-   {
-      reverb_delete(&mP[i].reverb);
-   }
-
-   free(mP);
+   mMaster.reset();
 
    return true;
 }
 
 size_t EffectReverb::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
-   float *ichans[2] = {NULL, NULL};
-   float *ochans[2] = {NULL, NULL};
+   return InstanceProcess(*mMaster, inBlock, outBlock, blockLen);
+}
 
-   for (unsigned int c = 0; c < mNumChans; c++)
-   {
-      ichans[c] = inBlock[c];
-      ochans[c] = outBlock[c];
-   }
-   
-   float const dryMult = mParams.mWetOnly ? 0 : dB_to_linear(mParams.mDryGain);
+bool EffectReverb::RealtimeInitialize()
+{
+   SetBlockSize(512);
 
-   auto remaining = blockLen;
+   mSlaves.clear();
 
-   while (remaining)
-   {
-      auto len = std::min(remaining, decltype(remaining)(BLOCK));
-      for (unsigned int c = 0; c < mNumChans; c++)
-      {
-         // Write the input samples to the reverb fifo.  Returned value is the address of the
-         // fifo buffer which contains a copy of the input samples.
-         mP[c].dry = (float *) fifo_write(&mP[c].reverb.input_fifo, len, ichans[c]);
-         reverb_process(&mP[c].reverb, len);
-      }
+   return true;
+}
 
-      if (mNumChans == 2)
-      {
-         for (decltype(len) i = 0; i < len; i++)
-         {
-            for (int w = 0; w < 2; w++)
-            {
-               ochans[w][i] = dryMult *
-                              mP[w].dry[i] +
-                              0.5 *
-                              (mP[0].wet[w][i] + mP[1].wet[w][i]);
-            }
-         }
-      }
-      else
-      {
-         for (decltype(len) i = 0; i < len; i++)
-         {
-            ochans[0][i] = dryMult * 
-                           mP[0].dry[i] +
-                           mP[0].wet[0][i];
-         }
-      }
+bool EffectReverb::RealtimeAddProcessor(unsigned numChannels, float sampleRate)
+{
+   unsigned numChans = std::min(numChannels, GetAudioInCount());
 
-      remaining -= len;
+   mSlaves.push_back(
+      std::make_unique<EffectReverbState>(
+         sampleRate, numChans, mParams, MAX_PreDelay));
 
-      for (unsigned int c = 0; c < mNumChans; c++)
-      {
-         ichans[c] += len;
-         ochans[c] += len;
-      }
+   return true;
+}
+
+bool EffectReverb::RealtimeFinalize()
+{
+   mSlaves.clear();
+
+   return true;
+}
+
+size_t EffectReverb::RealtimeProcess(int group,
+                                          float **inbuf,
+                                          float **outbuf,
+                                          size_t numSamples)
+{
+   auto &slave = mSlaves[group];
+
+   if (!SameReverb(slave->mParams, mParams))
+   {
+      slave->Set(mParams);
    }
 
-   return blockLen;
+   return InstanceProcess(*slave, inbuf, outbuf, numSamples);
 }
+
 bool EffectReverb::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mParams.mRoomSize,       RoomSize );
    S.SHUTTLE_PARAM( mParams.mPreDelay,       PreDelay );
@@ -518,6 +607,7 @@ bool EffectReverb::TransferDataFromWindow()
       if (mProcessingEvent) return; \
       mProcessingEvent = true; \
       m ## n ## T->SetValue(wxString::Format(wxT("%d"), evt.GetInt())); \
+      mParams.m ## n = evt.GetInt(); \
       mProcessingEvent = false; \
    } \
    void EffectReverb::On ## n ## Text(wxCommandEvent & evt) \
@@ -525,6 +615,7 @@ bool EffectReverb::TransferDataFromWindow()
       if (mProcessingEvent) return; \
       mProcessingEvent = true; \
       m ## n ## S->SetValue(TrapLong(evt.GetInt(), MIN_ ## n, MAX_ ## n)); \
+      mParams.m ## n = m ## n ## S->GetValue(); \
       mProcessingEvent = false; \
    }
 
@@ -551,3 +642,75 @@ void EffectReverb::SetTitle(const wxString & name)
 
    mUIDialog->SetTitle(title);
 }
+
+void EffectReverb::OnWetOnly(wxCommandEvent & evt)
+{
+   mParams.mWetOnly = evt.GetInt() != 0;
+}
+
+size_t EffectReverb::InstanceProcess(EffectReverbState & data,
+                                          float **inBlock,
+                                          float **outBlock,
+                                          size_t blockLen)
+{
+   const auto numChans = data.mNumChans;
+   auto mP = data.mP;
+
+   float *ichans[2] = {NULL, NULL};
+   float *ochans[2] = {NULL, NULL};
+
+   for (unsigned int c = 0; c < numChans; c++)
+   {
+      ichans[c] = inBlock[c];
+      ochans[c] = outBlock[c];
+   }
+   
+   float const dryMult = mParams.mWetOnly ? 0 : dB_to_linear(mParams.mDryGain);
+
+   auto remaining = blockLen;
+
+   while (remaining)
+   {
+      auto len = std::min(remaining, decltype(remaining)(BLOCK));
+      for (unsigned int c = 0; c < numChans; c++)
+      {
+         // Write the input samples to the reverb fifo.  Returned value is the address of the
+         // fifo buffer which contains a copy of the input samples.
+         mP[c].dry = (float *) fifo_write(&mP[c].reverb.input_fifo, len, ichans[c]);
+         reverb_process(&mP[c].reverb, len);
+      }
+
+      if (numChans == 2)
+      {
+         for (decltype(len) i = 0; i < len; i++)
+         {
+            for (int w = 0; w < 2; w++)
+            {
+               ochans[w][i] = dryMult *
+                              mP[w].dry[i] +
+                              0.5 *
+                              (mP[0].wet[w][i] + mP[1].wet[w][i]);
+            }
+         }
+      }
+      else
+      {
+         for (decltype(len) i = 0; i < len; i++)
+         {
+            ochans[0][i] = dryMult * 
+                           mP[0].dry[i] +
+                           mP[0].wet[0][i];
+         }
+      }
+
+      remaining -= len;
+
+      for (unsigned int c = 0; c < numChans; c++)
+      {
+         ichans[c] += len;
+         ochans[c] += len;
+      }
+   }
+
+   return blockLen;
+}
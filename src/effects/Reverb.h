@@ -12,6 +12,8 @@
 #ifndef __AUDACITY_EFFECT_REVERB__
 #define __AUDACITY_EFFECT_REVERB__
 
+#include <vector>
+
 #include "Effect.h"
 
 class wxCheckBox;
@@ -21,7 +23,7 @@ class ShuttleGui;
 
 #define REVERB_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Reverb") }
 
-struct Reverb_priv_t;
+struct EffectReverbState;
 
 class EffectReverb final : public Effect
 {
@@ -52,6 +54,7 @@ public:
    // EffectDefinitionInterface implementation
 
    EffectType GetType() override;
+   bool SupportsRealtime() override;
 
    // EffectClientInterface implementation
 
@@ -60,6 +63,13 @@ public:
    bool ProcessInitialize(sampleCount totalLen, ChannelNames chanMap = NULL) override;
    bool ProcessFinalize() override;
    size_t ProcessBlock(float **inBlock, float **outBlock, size_t blockLen) override;
+   bool RealtimeInitialize() override;
+   bool RealtimeAddProcessor(unsigned numChannels, float sampleRate) override;
+   bool RealtimeFinalize() override;
+   size_t RealtimeProcess(int group,
+                               float **inbuf,
+                               float **outbuf,
+                               size_t numSamples) override;
    bool DefineParams( ShuttleParams & S ) override;
    bool GetAutomationParameters(CommandParameters & parms) override;
    bool SetAutomationParameters(CommandParameters & parms) override;
@@ -78,6 +88,11 @@ private:
 
    void SetTitle(const wxString & name = {});
 
+   size_t InstanceProcess(EffectReverbState & data,
+                               float **inBlock,
+                               float **outBlock,
+                               size_t blockLen);
+
 #define SpinSliderHandlers(n) \
    void On ## n ## Slider(wxCommandEvent & evt); \
    void On ## n ## Text(wxCommandEvent & evt);
@@ -94,9 +109,11 @@ private:
 
 #undef SpinSliderHandlers
 
+   void OnWetOnly(wxCommandEvent & evt);
+
 private:
-   unsigned mNumChans {};
-   Reverb_priv_t *mP;
+   std::unique_ptr<EffectReverbState> mMaster;
+   std::vector< std::unique_ptr<EffectReverbState> > mSlaves;
 
    Params mParams;
 
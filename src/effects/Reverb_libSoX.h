@@ -268,3 +268,107 @@ static void reverb_delete(reverb_t * p)
    fifo_delete(&p->input_fifo);
 }
 
+
+/* For realtime processing, which changes the parameters of a running reverb
+   and must not allocate while it does:  the buffers are made for the largest
+   room and stereo depth and the longest pre-delay, and reverb_set() changes
+   only how much of them is used. */
+
+static void filter_array_allocate(filter_array_t * p, double rate)
+{
+   size_t i;
+   double r = rate * (1 / 44100.); /* Compensate for actual sample-rate */
+   for (i = 0; i < array_length(comb_lengths); ++i)
+   {
+      filter_t * pcomb = &p->comb[i];
+      pcomb->size = (size_t)(r * (comb_lengths[i] + stereo_adjust) + .5);
+      pcomb->ptr = lsx_zalloc(pcomb->buffer, pcomb->size);
+   }
+   for (i = 0; i < array_length(allpass_lengths); ++i)
+   {
+      filter_t * pallpass = &p->allpass[i];
+      pallpass->size = (size_t)(r * (allpass_lengths[i] + stereo_adjust) + .5);
+      pallpass->ptr = lsx_zalloc(pallpass->buffer, pallpass->size);
+   }
+}
+
+static void filter_resize(filter_t * p, size_t size)
+{
+   p->size = size;
+   if (p->ptr >= p->buffer + size)
+      p->ptr = p->buffer;
+}
+
+static void filter_array_set(filter_array_t * p, double rate,
+      double scale, double offset, double fc_highpass, double fc_lowpass)
+{
+   size_t i;
+   double r = rate * (1 / 44100.); /* Compensate for actual sample-rate */
+   for (i = 0; i < array_length(comb_lengths); ++i, offset = -offset)
+      filter_resize(&p->comb[i],
+         (size_t)(scale * r * (comb_lengths[i] + stereo_adjust * offset) + .5));
+   for (i = 0; i < array_length(allpass_lengths); ++i, offset = -offset)
+      filter_resize(&p->allpass[i],
+         (size_t)(r * (allpass_lengths[i] + stereo_adjust * offset) + .5));
+   { /* EQ: highpass */
+      one_pole_t * q = &p->one_pole[0];
+      q->a1 = -exp(-2 * M_PI * fc_highpass / rate);
+      q->b0 = (1 - q->a1)/2, q->b1 = -q->b0;
+   }
+   { /* EQ: lowpass */
+      one_pole_t * q = &p->one_pole[1];
+      q->a1 = -exp(-2 * M_PI * fc_lowpass / rate);
+      q->b0 = 1 + q->a1, q->b1 = 0;
+   }
+}
+
+static void reverb_allocate(reverb_t * p, double sample_rate_Hz,
+      double max_pre_delay_ms,
+      size_t chans,          /* 2 for stereo depth */
+      size_t buffer_size,
+      float * * out)
+{
+   size_t i, max_delay = max_pre_delay_ms / 1000 * sample_rate_Hz + .5;
+   memset(p, 0, sizeof(*p));
+   fifo_create(&p->input_fifo, sizeof(float));
+   /* Room for the pre-delay and a buffer of input, so that fifo_reserve()
+      moves the data instead of growing */
+   p->input_fifo.allocation =
+      FIFO_MIN + (max_delay + buffer_size) * p->input_fifo.item_size;
+   p->input_fifo.data =
+      (char *)realloc(p->input_fifo.data, p->input_fifo.allocation);
+   for (i = 0; i < chans; ++i) {
+      filter_array_allocate(p->chan + i, sample_rate_Hz);
+      out[i] = lsx_zalloc(p->out[i], buffer_size);
+   }
+}
+
+static void reverb_set(reverb_t * p, double sample_rate_Hz,
+      double wet_gain_dB,
+      double room_scale,     /* % */
+      double reverberance,   /* % */
+      double hf_damping,     /* % */
+      double pre_delay_ms,
+      double stereo_depth,
+      double tone_low,       /* % */
+      double tone_high)      /* % */
+{
+   size_t i, delay = pre_delay_ms / 1000 * sample_rate_Hz + .5;
+   size_t queued = (p->input_fifo.end - p->input_fifo.begin) / p->input_fifo.item_size;
+   double scale = room_scale / 100 * .9 + .1;
+   double depth = stereo_depth / 100;
+   double a =  -1 /  log(1 - /**/.3 /**/);           /* Set minimum feedback */
+   double b = 100 / (log(1 - /**/.98/**/) * a + 1);  /* Set maximum feedback */
+   double fc_highpass = midi_to_freq(72 - tone_low / 100 * 48);
+   double fc_lowpass  = midi_to_freq(72 + tone_high/ 100 * 48);
+   p->feedback = 1 - exp((reverberance - b) / (a * b));
+   p->hf_damping = hf_damping / 100 * .3 + .2;
+   p->gain = dB_to_linear(wet_gain_dB) * .015;
+   /* Between blocks, the input fifo holds just the pre-delay */
+   if (delay > queued)
+      memset(fifo_write(&p->input_fifo, delay - queued, 0), 0, (delay - queued) * sizeof(float));
+   else
+      fifo_read(&p->input_fifo, queued - delay, NULL);
+   for (i = 0; i < 2 && p->out[i]; ++i)
+      filter_array_set(p->chan + i, sample_rate_Hz, scale, i * depth, fc_highpass, fc_lowpass);
+}
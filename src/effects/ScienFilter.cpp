@@ -35,8 +35,10 @@ a graph for EffectScienFilter.
 #include "../Audacity.h"
 #include "ScienFilter.h"
 
+#include <algorithm>
 #include <math.h>
 #include <float.h>
+#include <thread>
 
 #include <wx/setup.h> // for wxUSE_* macros
 
@@ -210,6 +212,15 @@ EffectType EffectScienFilter::GetType()
    return EffectTypeProcess;
 }
 
+bool EffectScienFilter::SupportsRealtime()
+{
+#if defined(EXPERIMENTAL_REALTIME_AUDACITY_EFFECTS)
+   return true;
+#else
+   return false;
+#endif
+}
+
 // EffectClientInterface implementation
 
 unsigned EffectScienFilter::GetAudioInCount()
@@ -224,25 +235,51 @@ unsigned EffectScienFilter::GetAudioOutCount()
 
 bool EffectScienFilter::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelNames WXUNUSED(chanMap))
 {
-   for (int iPair = 0; iPair < (mOrder + 1) / 2; iPair++)
-      mpBiquad[iPair].Reset();
+   InstanceInit(mMaster, mSampleRate);
 
    return true;
 }
 
 size_t EffectScienFilter::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
-   float *ibuf = inBlock[0];
-   for (int iPair = 0; iPair < (mOrder + 1) / 2; iPair++)
-   {
-      mpBiquad[iPair].pfIn = ibuf;
-      mpBiquad[iPair].pfOut = outBlock[0];
-      mpBiquad[iPair].Process(blockLen);
-      ibuf = outBlock[0];
-   }
+   return InstanceProcess(mMaster, inBlock, outBlock, blockLen);
+}
 
-   return blockLen;
+bool EffectScienFilter::RealtimeInitialize()
+{
+   SetBlockSize(512);
+
+   mSlaves.clear();
+
+   return true;
+}
+
+bool EffectScienFilter::RealtimeAddProcessor(unsigned WXUNUSED(numChannels), float sampleRate)
+{
+   auto slave = std::make_unique<EffectScienFilterState>();
+
+   InstanceInit(*slave, sampleRate);
+
+   mSlaves.push_back(std::move(slave));
+
+   return true;
+}
+
+bool EffectScienFilter::RealtimeFinalize()
+{
+   mSlaves.clear();
+
+   return true;
+}
+
+size_t EffectScienFilter::RealtimeProcess(int group,
+                                               float **inbuf,
+                                               float **outbuf,
+                                               size_t numSamples)
+{
+   return InstanceProcess(*mSlaves[group], inbuf, outbuf, numSamples);
 }
+
 bool EffectScienFilter::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_ENUM_PARAM( mFilterType, Type, kTypeStrings, nTypes );
    S.SHUTTLE_ENUM_PARAM( mFilterSubtype, Subtype, kSubTypeStrings, nSubTypes );
@@ -572,6 +609,79 @@ bool EffectScienFilter::TransferDataFromWindow()
 
 // EffectScienFilter implementation
 
+void EffectScienFilter::InstanceInit(EffectScienFilterState & data, float sampleRate)
+{
+   data.biquads.reinit(size_t( MAX_Order / 2 ), true);
+   data.order = mOrder;
+   data.nyquist = sampleRate / 2.0;
+   for (auto &coefficients : data.coefficients)
+      coefficients.reinit(size_t( MAX_Order / 2 ), true);
+   data.current = 0;
+   data.reading = -1;
+   PublishCoefficients(data);
+}
+
+// Fill the set of coefficients that the processor is not reading, and
+// switch it to that set.  The processor may still be copying from the set
+// published before the last one; wait for it.
+void EffectScienFilter::PublishCoefficients(EffectScienFilterState & data)
+{
+   const int spare = 1 - data.current.load();
+   while (data.reading.load() == spare)
+      std::this_thread::yield();
+
+   CalcCoefficients(data.nyquist, data.coefficients[spare].get());
+   data.orders[spare] = mOrder;
+   data.current.store(spare);
+}
+
+size_t EffectScienFilter::InstanceProcess(EffectScienFilterState & data,
+                                               float **inBlock,
+                                               float **outBlock,
+                                               size_t blockLen)
+{
+   // Take the latest coefficients, making sure that PublishCoefficients()
+   // did not pick the same set to fill before it was marked as read
+   int set;
+   do
+   {
+      set = data.current.load();
+      data.reading.store(set);
+   } while (data.current.load() != set);
+
+   // A filter of another order starts over
+   if (data.order != data.orders[set])
+   {
+      for (int iPair = 0; iPair < MAX_Order / 2; iPair++)
+         data.biquads[iPair].Reset();
+      data.order = data.orders[set];
+   }
+
+   const auto &coefficients = data.coefficients[set];
+   for (int iPair = 0; iPair < (data.order + 1) / 2; iPair++)
+   {
+      auto &biquad = data.biquads[iPair];
+      std::copy(coefficients[iPair].fNumerCoeffs,
+                coefficients[iPair].fNumerCoeffs + 3, biquad.fNumerCoeffs);
+      std::copy(coefficients[iPair].fDenomCoeffs,
+                coefficients[iPair].fDenomCoeffs + 2, biquad.fDenomCoeffs);
+   }
+
+   data.reading.store(-1);
+
+   float *ibuf = inBlock[0];
+   for (int iPair = 0; iPair < (data.order + 1) / 2; iPair++)
+   {
+      auto &biquad = data.biquads[iPair];
+      biquad.pfIn = ibuf;
+      biquad.pfOut = outBlock[0];
+      biquad.Process(blockLen);
+      ibuf = outBlock[0];
+   }
+
+   return blockLen;
+}
+
 //
 // Retrieve data from the window
 //
@@ -622,9 +732,20 @@ bool EffectScienFilter::TransferGraphLimitsFromWindow()
 }
 
 bool EffectScienFilter::CalcFilter()
+{
+   CalcCoefficients(mNyquist, mpBiquad.get());
+
+   // Realtime processors get coefficients for their own rates
+   for (auto &slave : mSlaves)
+      PublishCoefficients(*slave);
+
+   return true;
+}
+
+void EffectScienFilter::CalcCoefficients(double nyquist, Biquad *biquads)
 {
    // Set up the coefficients in all the biquads
-   float fNorm = mCutoff / mNyquist;
+   float fNorm = mCutoff / nyquist;
    if (fNorm >= 0.9999)
       fNorm = 0.9999F;
    float fC = tan (PI * fNorm / 2);
@@ -643,14 +764,14 @@ bool EffectScienFilter::CalcFilter()
             float fSPoleX = fC * cos (PI - (iPair + 0.5) * PI / mOrder);
             float fSPoleY = fC * sin (PI - (iPair + 0.5) * PI / mOrder);
             BilinTransform (fSPoleX, fSPoleY, &fZPoleX, &fZPoleY);
-            mpBiquad[iPair].fNumerCoeffs [0] = 1;
+            biquads[iPair].fNumerCoeffs [0] = 1;
             if (mFilterSubtype == kLowPass)		// LOWPASS
-               mpBiquad[iPair].fNumerCoeffs [1] = 2;
+               biquads[iPair].fNumerCoeffs [1] = 2;
             else
-               mpBiquad[iPair].fNumerCoeffs [1] = -2;
-            mpBiquad[iPair].fNumerCoeffs [2] = 1;
-            mpBiquad[iPair].fDenomCoeffs [0] = -2 * fZPoleX;
-            mpBiquad[iPair].fDenomCoeffs [1] = square(fZPoleX) + square(fZPoleY);
+               biquads[iPair].fNumerCoeffs [1] = -2;
+            biquads[iPair].fNumerCoeffs [2] = 1;
+            biquads[iPair].fDenomCoeffs [0] = -2 * fZPoleX;
+            biquads[iPair].fDenomCoeffs [1] = square(fZPoleX) + square(fZPoleY);
             if (mFilterSubtype == kLowPass)		// LOWPASS
                fDCPoleDistSqr *= Calc2D_DistSqr (1, 0, fZPoleX, fZPoleY);
             else
@@ -663,14 +784,14 @@ bool EffectScienFilter::CalcFilter()
          float fSPoleX = -fC;
          float fSPoleY = 0;
          BilinTransform (fSPoleX, fSPoleY, &fZPoleX, &fZPoleY);
-         mpBiquad[0].fNumerCoeffs [0] = 1;
+         biquads[0].fNumerCoeffs [0] = 1;
          if (mFilterSubtype == kLowPass)		// LOWPASS
-            mpBiquad[0].fNumerCoeffs [1] = 1;
+            biquads[0].fNumerCoeffs [1] = 1;
          else
-            mpBiquad[0].fNumerCoeffs [1] = -1;
-         mpBiquad[0].fNumerCoeffs [2] = 0;
-         mpBiquad[0].fDenomCoeffs [0] = -fZPoleX;
-         mpBiquad[0].fDenomCoeffs [1] = 0;
+            biquads[0].fNumerCoeffs [1] = -1;
+         biquads[0].fNumerCoeffs [2] = 0;
+         biquads[0].fDenomCoeffs [0] = -fZPoleX;
+         biquads[0].fDenomCoeffs [1] = 0;
          if (mFilterSubtype == kLowPass)		// LOWPASS
             fDCPoleDistSqr = 1 - fZPoleX;
          else
@@ -680,23 +801,23 @@ bool EffectScienFilter::CalcFilter()
             fSPoleX = fC * cos (PI - iPair * PI / mOrder);
             fSPoleY = fC * sin (PI - iPair * PI / mOrder);
             BilinTransform (fSPoleX, fSPoleY, &fZPoleX, &fZPoleY);
-            mpBiquad[iPair].fNumerCoeffs [0] = 1;
+            biquads[iPair].fNumerCoeffs [0] = 1;
             if (mFilterSubtype == kLowPass)		// LOWPASS
-               mpBiquad[iPair].fNumerCoeffs [1] = 2;
+               biquads[iPair].fNumerCoeffs [1] = 2;
             else
-               mpBiquad[iPair].fNumerCoeffs [1] = -2;
-            mpBiquad[iPair].fNumerCoeffs [2] = 1;
-            mpBiquad[iPair].fDenomCoeffs [0] = -2 * fZPoleX;
-            mpBiquad[iPair].fDenomCoeffs [1] = square(fZPoleX) + square(fZPoleY);
+               biquads[iPair].fNumerCoeffs [1] = -2;
+            biquads[iPair].fNumerCoeffs [2] = 1;
+            biquads[iPair].fDenomCoeffs [0] = -2 * fZPoleX;
+            biquads[iPair].fDenomCoeffs [1] = square(fZPoleX) + square(fZPoleY);
             if (mFilterSubtype == kLowPass)		// LOWPASS
                fDCPoleDistSqr *= Calc2D_DistSqr (1, 0, fZPoleX, fZPoleY);
             else
                fDCPoleDistSqr *= Calc2D_DistSqr (-1, 0, fZPoleX, fZPoleY);		// distance from Nyquist
          }
       }
-      mpBiquad[0].fNumerCoeffs [0] *= fDCPoleDistSqr / (1 << mOrder);	// mult by DC dist from poles, divide by dist from zeroes
-      mpBiquad[0].fNumerCoeffs [1] *= fDCPoleDistSqr / (1 << mOrder);
-      mpBiquad[0].fNumerCoeffs [2] *= fDCPoleDistSqr / (1 << mOrder);
+      biquads[0].fNumerCoeffs [0] *= fDCPoleDistSqr / (1 << mOrder);	// mult by DC dist from poles, divide by dist from zeroes
+      biquads[0].fNumerCoeffs [1] *= fDCPoleDistSqr / (1 << mOrder);
+      biquads[0].fNumerCoeffs [2] *= fDCPoleDistSqr / (1 << mOrder);
       break;
 
    case kChebyshevTypeI:     // Chebyshev Type 1
@@ -722,18 +843,18 @@ bool EffectScienFilter::CalcFilter()
             fDCPoleDistSqr = Calc2D_DistSqr (-1, 0, fZPoleX, fZPoleY);		// distance from Nyquist
             fDCPoleDistSqr /= 2*2;  // dist from zero at Nyquist
          }
-         mpBiquad[iPair].fNumerCoeffs [0] = fDCPoleDistSqr;
-         mpBiquad[iPair].fNumerCoeffs [1] = -2 * fZZeroX * fDCPoleDistSqr;
-         mpBiquad[iPair].fNumerCoeffs [2] = fDCPoleDistSqr;
-         mpBiquad[iPair].fDenomCoeffs [0] = -2 * fZPoleX;
-         mpBiquad[iPair].fDenomCoeffs [1] = square(fZPoleX) + square(fZPoleY);
+         biquads[iPair].fNumerCoeffs [0] = fDCPoleDistSqr;
+         biquads[iPair].fNumerCoeffs [1] = -2 * fZZeroX * fDCPoleDistSqr;
+         biquads[iPair].fNumerCoeffs [2] = fDCPoleDistSqr;
+         biquads[iPair].fDenomCoeffs [0] = -2 * fZPoleX;
+         biquads[iPair].fDenomCoeffs [1] = square(fZPoleX) + square(fZPoleY);
       }
       if ((mOrder & 1) == 0)
       {
          float fTemp = DB_TO_LINEAR(-wxMax(0.001, mRipple));      // at DC the response is down R dB (for even-order)
-         mpBiquad[0].fNumerCoeffs [0] *= fTemp;
-         mpBiquad[0].fNumerCoeffs [1] *= fTemp;
-         mpBiquad[0].fNumerCoeffs [2] *= fTemp;
+         biquads[0].fNumerCoeffs [0] *= fTemp;
+         biquads[0].fNumerCoeffs [1] *= fTemp;
+         biquads[0].fNumerCoeffs [2] *= fTemp;
       }
       else
       {
@@ -755,11 +876,11 @@ bool EffectScienFilter::CalcFilter()
             fDCPoleDistSqr = sqrt(Calc2D_DistSqr (-1, 0, fZPoleX, fZPoleY));		// distance from Nyquist
             fDCPoleDistSqr /= 2;  // dist from zero at Nyquist
          }
-         mpBiquad[(mOrder-1)/2].fNumerCoeffs [0] = fDCPoleDistSqr;
-         mpBiquad[(mOrder-1)/2].fNumerCoeffs [1] = -fZZeroX * fDCPoleDistSqr;
-         mpBiquad[(mOrder-1)/2].fNumerCoeffs [2] = 0;
-         mpBiquad[(mOrder-1)/2].fDenomCoeffs [0] = -fZPoleX;
-         mpBiquad[(mOrder-1)/2].fDenomCoeffs [1] = 0;
+         biquads[(mOrder-1)/2].fNumerCoeffs [0] = fDCPoleDistSqr;
+         biquads[(mOrder-1)/2].fNumerCoeffs [1] = -fZZeroX * fDCPoleDistSqr;
+         biquads[(mOrder-1)/2].fNumerCoeffs [2] = 0;
+         biquads[(mOrder-1)/2].fDenomCoeffs [0] = -fZPoleX;
+         biquads[(mOrder-1)/2].fDenomCoeffs [1] = 0;
       }
       break;
 
@@ -793,11 +914,11 @@ bool EffectScienFilter::CalcFilter()
             fDCPoleDistSqr = Calc2D_DistSqr (-1, 0, fZPoleX, fZPoleY);		// distance from Nyquist
             fDCPoleDistSqr /= Calc2D_DistSqr (-1, 0, fZZeroX, fZZeroY);
          }
-         mpBiquad[iPair].fNumerCoeffs [0] = fDCPoleDistSqr;
-         mpBiquad[iPair].fNumerCoeffs [1] = -2 * fZZeroX * fDCPoleDistSqr;
-         mpBiquad[iPair].fNumerCoeffs [2] = (square(fZZeroX) + square(fZZeroY)) * fDCPoleDistSqr;
-         mpBiquad[iPair].fDenomCoeffs [0] = -2 * fZPoleX;
-         mpBiquad[iPair].fDenomCoeffs [1] = square(fZPoleX) + square(fZPoleY);
+         biquads[iPair].fNumerCoeffs [0] = fDCPoleDistSqr;
+         biquads[iPair].fNumerCoeffs [1] = -2 * fZZeroX * fDCPoleDistSqr;
+         biquads[iPair].fNumerCoeffs [2] = (square(fZZeroX) + square(fZZeroY)) * fDCPoleDistSqr;
+         biquads[iPair].fDenomCoeffs [0] = -2 * fZPoleX;
+         biquads[iPair].fDenomCoeffs [1] = square(fZPoleX) + square(fZPoleY);
       }
       // Now, if it's odd order, we have one more to do
       if (mOrder & 1)
@@ -822,15 +943,14 @@ bool EffectScienFilter::CalcFilter()
             fDCPoleDistSqr = sqrt(Calc2D_DistSqr (-1, 0, fZPoleX, fZPoleY));		// distance from Nyquist
             fDCPoleDistSqr /= 2;
          }
-         mpBiquad[iPair].fNumerCoeffs [0] = fDCPoleDistSqr;
-         mpBiquad[iPair].fNumerCoeffs [1] = -fZZeroX * fDCPoleDistSqr;
-         mpBiquad[iPair].fNumerCoeffs [2] = 0;
-         mpBiquad[iPair].fDenomCoeffs [0] = -fZPoleX;
-         mpBiquad[iPair].fDenomCoeffs [1] = 0;
+         biquads[iPair].fNumerCoeffs [0] = fDCPoleDistSqr;
+         biquads[iPair].fNumerCoeffs [1] = -fZZeroX * fDCPoleDistSqr;
+         biquads[iPair].fNumerCoeffs [2] = 0;
+         biquads[iPair].fDenomCoeffs [0] = -fZPoleX;
+         biquads[iPair].fDenomCoeffs [1] = 0;
       }
       break;
    }
-   return true;
 }
 
 double EffectScienFilter::ChebyPoly(int Order, double NormFreq)   // NormFreq = 1 at the f0 point (where response is R dB down)
@@ -916,6 +1036,7 @@ void EffectScienFilter::OnOrder(wxCommandEvent & WXUNUSED(evt))
 {
    mOrderIndex = mFilterOrderCtl->GetSelection();
    mOrder = mOrderIndex + 1;	// 0..n-1 -> 1..n
+   CalcFilter();
    mPanel->Refresh(false);
 }
 
@@ -923,12 +1044,14 @@ void EffectScienFilter::OnFilterType(wxCommandEvent & WXUNUSED(evt))
 {
    mFilterType = mFilterTypeCtl->GetSelection();
    EnableDisableRippleCtl(mFilterType);
+   CalcFilter();
    mPanel->Refresh(false);
 }
 
 void EffectScienFilter::OnFilterSubtype(wxCommandEvent & WXUNUSED(evt))
 {
    mFilterSubtype = mFilterSubTypeCtl->GetSelection();
+   CalcFilter();
    mPanel->Refresh(false);
 }
 
@@ -939,6 +1062,7 @@ void EffectScienFilter::OnCutoff(wxCommandEvent & WXUNUSED(evt))
       return;
    }
 
+   CalcFilter();
    mPanel->Refresh(false);
 }
 
@@ -949,6 +1073,7 @@ void EffectScienFilter::OnRipple(wxCommandEvent & WXUNUSED(evt))
       return;
    }
 
+   CalcFilter();
    mPanel->Refresh(false);
 }
 
@@ -959,6 +1084,7 @@ void EffectScienFilter::OnStopbandRipple(wxCommandEvent & WXUNUSED(evt))
       return;
    }
 
+   CalcFilter();
    mPanel->Refresh(false);
 }
 
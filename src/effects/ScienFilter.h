@@ -15,6 +15,9 @@ Vaughan Johnson (Preview)
 
 #include <wx/setup.h> // for wxUSE_* macros
 
+#include <atomic>
+#include <vector>
+
 #include "Biquad.h"
 
 #include "Effect.h"
@@ -31,6 +34,24 @@ class ShuttleGui;
 
 class EffectScienFilterPanel;
 
+class EffectScienFilterState
+{
+public:
+   // The filter history of each section; the coefficients are copied
+   // in at each block
+   ArrayOf<Biquad> biquads;
+   int order;
+   double nyquist;
+
+   // Coefficients for the rate of this processor, in two sets, so that
+   // the main thread fills one while the audio thread reads the other
+   ArrayOf<Biquad> coefficients[2];
+   int orders[2];
+   std::atomic<int> current;
+   // The set being read, or -1
+   std::atomic<int> reading;
+};
+
 class EffectScienFilter final : public Effect
 {
 public:
@@ -46,6 +67,7 @@ public:
    // EffectDefinitionInterface implementation
 
    EffectType GetType() override;
+   bool SupportsRealtime() override;
 
    // EffectClientInterface implementation
 
@@ -53,6 +75,13 @@ public:
    unsigned GetAudioOutCount() override;
    bool ProcessInitialize(sampleCount totalLen, ChannelNames chanMap = NULL) override;
    size_t ProcessBlock(float **inBlock, float **outBlock, size_t blockLen) override;
+   bool RealtimeInitialize() override;
+   bool RealtimeAddProcessor(unsigned numChannels, float sampleRate) override;
+   bool RealtimeFinalize() override;
+   size_t RealtimeProcess(int group,
+                               float **inbuf,
+                               float **outbuf,
+                               size_t numSamples) override;
    bool DefineParams( ShuttleParams & S ) override;
    bool GetAutomationParameters(CommandParameters & parms) override;
    bool SetAutomationParameters(CommandParameters & parms) override;
@@ -68,8 +97,16 @@ public:
 private:
    // EffectScienFilter implementation
 
+   void InstanceInit(EffectScienFilterState & data, float sampleRate);
+   void PublishCoefficients(EffectScienFilterState & data);
+   size_t InstanceProcess(EffectScienFilterState & data,
+                               float **inBlock,
+                               float **outBlock,
+                               size_t blockLen);
+
    bool TransferGraphLimitsFromWindow();
    bool CalcFilter();
+   void CalcCoefficients(double nyquist, Biquad *biquads);
    double ChebyPoly (int Order, double NormFreq);
    float FilterMagnAtFreq(float Freq);
 
@@ -100,6 +137,9 @@ private:
    int mOrderIndex;
    ArrayOf<Biquad> mpBiquad;
 
+   EffectScienFilterState mMaster;
+   std::vector< std::unique_ptr<EffectScienFilterState> > mSlaves;
+
    double mdBMax;
    double mdBMin;
    bool mEditingBatchParams;
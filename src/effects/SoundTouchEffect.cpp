@@ -17,11 +17,17 @@ effect that uses SoundTouch to do its processing (ChangeTempo
 #if USE_SOUNDTOUCH
 #include "SoundTouchEffect.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
 #include <math.h>
 
 #include "../LabelTrack.h"
+#include "../ThreadPool.h"
 #include "../WaveTrack.h"
 #include "../NoteTrack.h"
+#include "TimeWarper.h"
 
 // Soundtouch defines these as well, which are also in generated configmac.h
 // and configunix.h, so get rid of them before including,
@@ -68,9 +74,8 @@ bool EffectSoundTouch::ProcessNoteTrack(NoteTrack *nt, const TimeWarper &warper)
 
 bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
 {
-   // Assumes that mSoundTouch has already been initialized
-   // by the subclass for subclass-specific parameters. The
-   // time warper should also be set.
+   // Assumes that the subclass makes SoundTouch objects with its
+   // specific parameters. The time warper should also be set.
 
    // Check if this effect will alter the selection length; if so, we need
    // to operate on sync-lock selected tracks.
@@ -138,9 +143,6 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
                auto start = leftTrack->TimeToLongSamples(mCurT0);
                auto end = leftTrack->TimeToLongSamples(mCurT1);
 
-               //Inform soundtouch there's 2 channels
-               mSoundTouch->setChannels(2);
-
                //ProcessStereo() (implemented below) processes a stereo track
                if (!ProcessStereo(leftTrack, rightTrack, start, end, warper))
                   bGoodResult = false;
@@ -150,9 +152,6 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
                auto start = leftTrack->TimeToLongSamples(mCurT0);
                auto end = leftTrack->TimeToLongSamples(mCurT1);
 
-               //Inform soundtouch there's a single channel
-               mSoundTouch->setChannels(1);
-
                //ProcessOne() (implemented below) processes a single track
                if (!ProcessOne(leftTrack, start, end, warper))
                   bGoodResult = false;
@@ -176,74 +175,19 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
    return bGoodResult;
 }
 
-void EffectSoundTouch::End()
-{
-   mSoundTouch.reset();
-}
-
-//ProcessOne() takes a track, transforms it to bunch of buffer-blocks,
-//and executes ProcessSoundTouch on these blocks
+//ProcessOne() takes a track, stretches it in segments, and puts
+//the result in place of the original
 bool EffectSoundTouch::ProcessOne(WaveTrack *track,
                                   sampleCount start, sampleCount end,
                                   const TimeWarper &warper)
 {
-   mSoundTouch->setSampleRate((unsigned int)(track->GetRate()+0.5));
-
    auto outputTrack = mFactory->NewWaveTrack(track->GetSampleFormat(), track->GetRate());
 
-   //Get the length of the buffer (as double). len is
-   //used simple to calculate a progress meter, so it is easier
-   //to make it a double now than it is to do it later
-   auto len = (end - start).as_double();
-
-   {
-      //Initiate a processing buffer.  This buffer will (most likely)
-      //be shorter than the length of the track being processed.
-      Floats buffer{ track->GetMaxBlockSize() };
-
-      //Go through the track one buffer at a time. s counts which
-      //sample the current buffer starts at.
-      auto s = start;
-      while (s < end) {
-         //Get a block of samples (smaller than the size of the buffer)
-         const auto block =
-            limitSampleBufferSize( track->GetBestBlockSize(s), end - s );
-
-         //Get the samples from the track and put them in the buffer
-         track->Get((samplePtr)buffer.get(), floatSample, s, block);
-
-         //Add samples to SoundTouch
-         mSoundTouch->putSamples(buffer.get(), block);
-
-         //Get back samples from SoundTouch
-         unsigned int outputCount = mSoundTouch->numSamples();
-         if (outputCount > 0) {
-            Floats buffer2{ outputCount };
-            mSoundTouch->receiveSamples(buffer2.get(), outputCount);
-            outputTrack->Append((samplePtr)buffer2.get(), floatSample, outputCount);
-         }
-
-         //Increment s one blockfull of samples
-         s += block;
-
-         //Update the Progress meter
-         if (TrackProgress(mCurTrackNum, (s - start).as_double() / len))
-            return false;
-      }
-
-      // Tell SoundTouch to finish processing any remaining samples
-      mSoundTouch->flush();   // this should only be used for changeTempo - it dumps data otherwise with pRateTransposer->clear();
-
-      unsigned int outputCount = mSoundTouch->numSamples();
-      if (outputCount > 0) {
-         Floats buffer2{ outputCount };
-         mSoundTouch->receiveSamples(buffer2.get(), outputCount);
-         outputTrack->Append((samplePtr)buffer2.get(), floatSample, outputCount);
-      }
-
-      // Flush the output WaveTrack (since it's buffered, too)
-      outputTrack->Flush();
-   }
+   const double ratio = (warper.Warp(mCurT1) - warper.Warp(mCurT0)) /
+      (mCurT1 - mCurT0);
+   WaveTrack *const outputs[] = { outputTrack.get() };
+   if (!ProcessSegments(&track, outputs, 1, start, end, ratio))
+      return false;
 
    // Take the output track and insert it in place of the original
    // sample data
@@ -260,87 +204,18 @@ bool EffectSoundTouch::ProcessStereo(
    WaveTrack* leftTrack, WaveTrack* rightTrack,
    sampleCount start, sampleCount end, const TimeWarper &warper)
 {
-   mSoundTouch->setSampleRate((unsigned int)(leftTrack->GetRate() + 0.5));
-
    auto outputLeftTrack = mFactory->NewWaveTrack(leftTrack->GetSampleFormat(),
                                                        leftTrack->GetRate());
    auto outputRightTrack = mFactory->NewWaveTrack(rightTrack->GetSampleFormat(),
                                                         rightTrack->GetRate());
 
-   //Get the length of the buffer (as double). len is
-   //used simple to calculate a progress meter, so it is easier
-   //to make it a double now than it is to do it later
-   double len = (end - start).as_double();
-
-   //Initiate a processing buffer.  This buffer will (most likely)
-   //be shorter than the length of the track being processed.
-   // Make soundTouchBuffer twice as big as MaxBlockSize for each channel,
-   // because Soundtouch wants them interleaved, i.e., each
-   // Soundtouch sample is left-right pair.
-   auto maxBlockSize = leftTrack->GetMaxBlockSize();
-   {
-      Floats leftBuffer{ maxBlockSize };
-      Floats rightBuffer{ maxBlockSize };
-      Floats soundTouchBuffer{ maxBlockSize * 2 };
-
-      // Go through the track one stereo buffer at a time.
-      // sourceSampleCount counts the sample at which the current buffer starts,
-      // per channel.
-      auto sourceSampleCount = start;
-      while (sourceSampleCount < end) {
-         auto blockSize = limitSampleBufferSize(
-            leftTrack->GetBestBlockSize(sourceSampleCount),
-            end - sourceSampleCount
-         );
-
-         // Get the samples from the tracks and put them in the buffers.
-         leftTrack->Get((samplePtr)(leftBuffer.get()), floatSample, sourceSampleCount, blockSize);
-         rightTrack->Get((samplePtr)(rightBuffer.get()), floatSample, sourceSampleCount, blockSize);
-
-         // Interleave into soundTouchBuffer.
-         for (decltype(blockSize) index = 0; index < blockSize; index++) {
-            soundTouchBuffer[index * 2] = leftBuffer[index];
-            soundTouchBuffer[(index * 2) + 1] = rightBuffer[index];
-         }
-
-         //Add samples to SoundTouch
-         mSoundTouch->putSamples(soundTouchBuffer.get(), blockSize);
-
-         //Get back samples from SoundTouch
-         unsigned int outputCount = mSoundTouch->numSamples();
-         if (outputCount > 0)
-            this->ProcessStereoResults(outputCount, outputLeftTrack.get(), outputRightTrack.get());
-
-         //Increment sourceSampleCount one blockfull of samples
-         sourceSampleCount += blockSize;
-
-         //Update the Progress meter
-         // mCurTrackNum is left track. Include right track.
-         int nWhichTrack = mCurTrackNum;
-         double frac = (sourceSampleCount - start).as_double() / len;
-         if (frac < 0.5)
-            frac *= 2.0; // Show twice as far for each track, because we're doing 2 at once.
-         else
-         {
-            nWhichTrack++;
-            frac -= 0.5;
-            frac *= 2.0; // Show twice as far for each track, because we're doing 2 at once.
-         }
-         if (TrackProgress(nWhichTrack, frac))
-            return false;
-      }
-
-      // Tell SoundTouch to finish processing any remaining samples
-      mSoundTouch->flush();
-
-      unsigned int outputCount = mSoundTouch->numSamples();
-      if (outputCount > 0)
-         this->ProcessStereoResults(outputCount, outputLeftTrack.get(), outputRightTrack.get());
-
-      // Flush the output WaveTracks (since they're buffered, too)
-      outputLeftTrack->Flush();
-      outputRightTrack->Flush();
-   }
+   const double ratio = (warper.Warp(mCurT1) - warper.Warp(mCurT0)) /
+      (mCurT1 - mCurT0);
+   WaveTrack *const tracks[] = { leftTrack, rightTrack };
+   WaveTrack *const outputs[] =
+      { outputLeftTrack.get(), outputRightTrack.get() };
+   if (!ProcessSegments(tracks, outputs, 2, start, end, ratio))
+      return false;
 
    // Take the output tracks and insert in place of the original
    // sample data.
@@ -359,24 +234,224 @@ bool EffectSoundTouch::ProcessStereo(
    return true;
 }
 
-bool EffectSoundTouch::ProcessStereoResults(const size_t outputCount,
-                                            WaveTrack* outputLeftTrack,
-                                            WaveTrack* outputRightTrack)
+namespace {
+// A stretch of the selection given to its own SoundTouch object
+struct Segment
 {
-   Floats outputSoundTouchBuffer{ outputCount * 2 };
-   mSoundTouch->receiveSamples(outputSoundTouchBuffer.get(), outputCount);
-
-   // Dis-interleave outputSoundTouchBuffer into separate track buffers.
-   Floats outputLeftBuffer{ outputCount };
-   Floats outputRightBuffer{ outputCount };
-   for (unsigned int index = 0; index < outputCount; index++)
-   {
-      outputLeftBuffer[index] = outputSoundTouchBuffer[index*2];
-      outputRightBuffer[index] = outputSoundTouchBuffer[(index*2)+1];
+   // Input, including overlap with the neighbours
+   sampleCount feedStart, feedEnd;
+   // Interleaved output
+   std::vector<float> output;
+   // First frame of output not yet appended
+   size_t begin{ 0 };
+};
+}
+
+// Stretches long selections in segments on worker threads.  Each segment
+// starts early and ends late, so that its SoundTouch object settles before
+// the part that is kept.  Neighbouring segments are joined with a short
+// crossfade, after shifting the later one by the lag that best matches the
+// earlier one, as SoundTouch itself joins its overlapping windows.  That
+// shift, at most MaxLagSeconds at each join, bounds how far the result may
+// drift from what one SoundTouch object would produce.
+bool EffectSoundTouch::ProcessSegments(
+   WaveTrack *const *tracks, WaveTrack *const *outputs, unsigned nChannels,
+   sampleCount start, sampleCount end, double ratio)
+{
+   static const double CrossfadeSeconds = 0.030;
+   static const double MaxLagSeconds = 0.015;
+
+   const auto rate = tracks[0]->GetRate();
+   const auto fadeLen = std::max<size_t>(2, CrossfadeSeconds * rate);
+   const auto maxLag = size_t(MaxLagSeconds * rate);
+   // Input samples of overlap, enough for both the crossfade and the lag,
+   // with room for SoundTouch to settle
+   const auto pad = std::max<size_t>(8192,
+      size_t(4 * (fadeLen / 2 + maxLag) / std::min(1.0, ratio)));
+   // Input samples kept of each segment, limiting its output to a few
+   // million samples
+   const auto segmentLen = std::max<size_t>(8 * pad,
+      size_t(std::min(1.0, 1.0 / ratio) * (1 << 21)));
+
+   const auto len = end - start;
+   if (len <= 0)
+      return true;
+   const auto nSegments =
+      ((len + segmentLen - 1) / segmentLen).as_size_t();
+   auto &pool = ThreadPool::Get();
+
+   std::atomic<long long> samplesDone{ 0 };
+   std::atomic<bool> cancelling{ false };
+   const double totalSamples =
+      len.as_double() + 2.0 * pad * (nSegments - 1);
+   const auto progress = [&] {
+      double frac = samplesDone / totalSamples;
+      int nWhichTrack = mCurTrackNum;
+      if (nChannels > 1) {
+         // Show twice as far for each track, because we're doing 2 at once.
+         frac *= 2.0;
+         if (frac >= 1.0)
+            nWhichTrack++, frac -= 1.0;
+      }
+      return TrackProgress(nWhichTrack, frac);
+   };
+
+   // Stretch a segment on a worker thread
+   const auto stretch = [&](Segment &segment) {
+      auto soundTouch = MakeSoundTouch();
+      soundTouch->setSampleRate((unsigned int)(rate + 0.5));
+      soundTouch->setChannels(nChannels);
+
+      const auto maxBlockSize = tracks[0]->GetMaxBlockSize();
+      FloatBuffers buffers{ nChannels, maxBlockSize };
+      Floats soundTouchBuffer{ maxBlockSize * nChannels };
+      const auto receive = [&] {
+         const auto count = soundTouch->numSamples();
+         if (count > 0) {
+            const auto size = segment.output.size();
+            segment.output.resize(size + count * nChannels);
+            soundTouch->receiveSamples(segment.output.data() + size, count);
+         }
+      };
+
+      auto s = segment.feedStart;
+      while (s < segment.feedEnd) {
+         if (cancelling)
+            return;
+
+         const auto block = limitSampleBufferSize(
+            tracks[0]->GetBestBlockSize(s), segment.feedEnd - s );
+
+         // Get the samples from the tracks and interleave them
+         for (unsigned ii = 0; ii < nChannels; ++ii) {
+            tracks[ii]->Get((samplePtr)buffers[ii].get(), floatSample, s, block);
+            for (size_t index = 0; index < block; index++)
+               soundTouchBuffer[index * nChannels + ii] = buffers[ii][index];
+         }
+
+         soundTouch->putSamples(soundTouchBuffer.get(), block);
+         receive();
+
+         s += block;
+         samplesDone += block;
+      }
+
+      // Tell SoundTouch to finish processing any remaining samples
+      soundTouch->flush();
+      receive();
+   };
+
+   // Output frame of a segment that corresponds to an input sample
+   const auto frameOf = [&](const Segment &segment, sampleCount s) {
+      return size_t((s - segment.feedStart).as_double() * ratio + 0.5);
+   };
+
+   const auto append = [&](const float *data, size_t frames) {
+      Floats buffer{ frames };
+      for (unsigned ii = 0; ii < nChannels; ++ii) {
+         for (size_t index = 0; index < frames; ++index)
+            buffer[index] = data[index * nChannels + ii];
+         outputs[ii]->Append((samplePtr)buffer.get(), floatSample, frames);
+      }
+   };
+
+   // Append the output of prev up to the join with next, crossfade them,
+   // and leave next ready to append after the crossfade
+   const auto join = [&](Segment &prev, Segment &next, sampleCount at) {
+      const auto &p = prev.output;
+      const auto &n = next.output;
+      const auto prevFrames = p.size() / nChannels;
+      const auto nextFrames = n.size() / nChannels;
+      // Fit the fade and the lags within both outputs, in case SoundTouch
+      // produced less than expected
+      const auto pAt = std::max(prev.begin,
+         std::min(prevFrames, frameOf(prev, at)));
+      const auto nAt = std::min(nextFrames, frameOf(next, at));
+      auto half = fadeLen / 2;
+      half = std::min(half, pAt - prev.begin);
+      half = std::min(half, prevFrames - pAt);
+      half = std::min(half, nAt);
+      half = std::min(half, nextFrames - nAt);
+      const auto lagDown = std::min(maxLag, nAt - std::min(nAt, half));
+      const auto lagUp = std::min(maxLag,
+         nextFrames - std::min(nextFrames, nAt + half));
+
+      // Find the lag of next that correlates best with prev over the fade
+      const float *pFade = p.data() + (pAt - half) * nChannels;
+      const auto count = 2 * half * nChannels;
+      long long bestLag = 0;
+      double best = -std::numeric_limits<double>::infinity();
+      for (long long lag = -(long long)lagDown; lag <= (long long)lagUp; ++lag) {
+         const float *nFade = n.data() + (nAt + lag - half) * nChannels;
+         double product = 0, energy = 0;
+         for (size_t ii = 0; ii < count; ++ii)
+            product += pFade[ii] * nFade[ii], energy += nFade[ii] * nFade[ii];
+         const auto score = (energy > 0) ? product / sqrt(energy) : 0;
+         if (score > best)
+            best = score, bestLag = lag;
+      }
+
+      append(p.data() + prev.begin * nChannels, pAt - half - prev.begin);
+
+      const float *nFade = n.data() + (nAt + bestLag - half) * nChannels;
+      std::vector<float> fade(count);
+      for (size_t frame = 0; frame < 2 * half; ++frame) {
+         const float fi = (frame + 0.5f) / (2 * half);
+         for (unsigned ii = 0; ii < nChannels; ++ii) {
+            const auto index = frame * nChannels + ii;
+            fade[index] = pFade[index] * (1.0f - fi) + nFade[index] * fi;
+         }
+      }
+      append(fade.data(), 2 * half);
+      next.begin = nAt + bestLag + half;
+   };
+
+   // Stretch as many segments at once as there are threads, and append
+   // their results in order of time
+   Segment prev;
+   size_t segment = 0;
+   while (segment < nSegments) {
+      std::vector<Segment> round(
+         std::min(pool.GetThreadCount(), nSegments - segment));
+      {
+         ThreadPool::Batch batch{ pool };
+         for (size_t ii = 0; ii < round.size(); ++ii) {
+            const auto first = start + (segment + ii) * segmentLen;
+            const auto last = std::min(end, first + segmentLen);
+            auto &seg = round[ii];
+            seg.feedStart = (first == start) ? start : first - pad;
+            seg.feedEnd = (last == end) ? end : last + pad;
+            seg.begin = 0;
+            batch.Add( [&stretch, &seg]{ stretch(seg); } );
+         }
+
+         bool cancelled = false;
+         while (!batch.WaitFor(100)) {
+            if (!cancelled && progress())
+               cancelled = true, cancelling = true;
+         }
+         batch.Wait();
+         if (cancelled)
+            return false;
+      }
+
+      for (auto &seg : round) {
+         if (segment > 0)
+            join(prev, seg, start + segment * segmentLen);
+         prev = std::move(seg);
+         ++segment;
+      }
+
+      if (progress())
+         return false;
    }
 
-   outputLeftTrack->Append((samplePtr)outputLeftBuffer.get(), floatSample, outputCount);
-   outputRightTrack->Append((samplePtr)outputRightBuffer.get(), floatSample, outputCount);
+   append(prev.output.data() + prev.begin * nChannels,
+      prev.output.size() / nChannels - prev.begin);
+
+   for (unsigned ii = 0; ii < nChannels; ++ii)
+      // Flush the output WaveTrack (since it's buffered, too)
+      outputs[ii]->Flush();
 
    return true;
 }
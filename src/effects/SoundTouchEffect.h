@@ -33,10 +33,6 @@ class EffectSoundTouch /* not final */ : public Effect
 {
 public:
    
-   // Effect implementation
-
-   void End() override;
-
    // EffectSoundTouch implementation
 
 #ifdef USE_MIDI
@@ -50,7 +46,10 @@ protected:
 
    bool ProcessWithTimeWarper(const TimeWarper &warper);
 
-   std::unique_ptr<soundtouch::SoundTouch> mSoundTouch;
+   /// Makes a SoundTouch object with the settings of the effect.  Long
+   /// selections are stretched in segments, each with its own object.
+   virtual std::unique_ptr<soundtouch::SoundTouch> MakeSoundTouch() = 0;
+
    double mCurT0;
    double mCurT1;
 
@@ -65,9 +64,9 @@ private:
    bool ProcessStereo(WaveTrack* leftTrack, WaveTrack* rightTrack,
                      sampleCount start, sampleCount end,
                       const TimeWarper &warper);
-   bool ProcessStereoResults(const size_t outputCount,
-                              WaveTrack* outputLeftTrack,
-                              WaveTrack* outputRightTrack);
+   bool ProcessSegments(WaveTrack *const *tracks, WaveTrack *const *outputs,
+                        unsigned nChannels,
+                        sampleCount start, sampleCount end, double ratio);
 
    int    mCurTrackNum;
 
@@ -32,6 +32,7 @@
 #include "../ProjectSettings.h"
 #include "../Shuttle.h"
 #include "../ShuttleGui.h"
+#include "../SilenceFinder.h"
 #include "../WaveTrack.h"
 #include "../widgets/valnum.h"
 #include "../widgets/AudacityMessageBox.h"
@@ -615,6 +616,8 @@ bool EffectTruncSilence::Analyze(RegionList& silenceList,
    // Allocate buffer
    Floats buffer{ blockLen };
 
+   SilenceFinder finder{ *wt, float(truncDbSilenceThreshold) };
+
    // Loop through current track
    while (*index < end) {
       if (inputLength && ((outLength >= previewLen) || (*index - start > wt->TimeToLongSamples(*minInputLength)))) {
@@ -677,8 +680,31 @@ bool EffectTruncSilence::Analyze(RegionList& silenceList,
       }
       // End of optimization
 
-      // Limit size of current block if we've reached the end
-      auto count = limitSampleBufferSize( blockLen, end - *index );
+      // Skip what the block summaries classify without reading samples.
+      // When previewing, only silence may be skipped, because the
+      // output length must be counted sample by sample.
+      const auto run = finder.Classify(*index, end);
+      if (run.kind == SilenceFinder::kSilent &&
+          !(inputLength && ((outLength >= previewLen) || (outLength > wt->TimeToLongSamples(*minInputLength))))) {
+         *silentFrame += run.length;
+         *index += run.length;
+         continue;
+      }
+      if (run.kind == SilenceFinder::kLoud && !inputLength) {
+         if (*silentFrame >= minSilenceFrames) {
+            trackSilences.push_back(Region(
+               wt->LongSamplesToTime(*index - *silentFrame),
+               wt->LongSamplesToTime(*index)
+            ));
+         }
+         *silentFrame = 0;
+         *index += run.length;
+         continue;
+      }
+
+      // Limit size of current block if we've reached the end, or the
+      // samples of another kind
+      auto count = limitSampleBufferSize( blockLen, run.length );
 
       // Fill buffer
       wt->Get((samplePtr)(buffer.get()), floatSample, *index, count);
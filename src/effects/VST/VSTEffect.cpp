@@ -1566,6 +1566,13 @@ bool VSTEffect::RealtimeProcessEnd()
    return true;
 }
 
+bool VSTEffect::SupportsParallelProcessing()
+{
+   // The master instance runs at the end of each cycle, and many plug-ins
+   // are not safe to call from several threads
+   return false;
+}
+
 ///
 /// Some history...
 ///
@@ -188,6 +188,11 @@ size_t EffectWahwah::RealtimeProcess(int group,
    return InstanceProcess(mSlaves[group], inbuf, outbuf, numSamples);
 }
 
+bool EffectWahwah::SupportsParallelProcessing()
+{
+   return true;
+}
+
 bool EffectWahwah::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mFreq, Freq );
    S.SHUTTLE_PARAM( mPhase, Phase );
@@ -1428,6 +1428,12 @@ bool AudioUnitEffect::RealtimeProcessEnd()
    return true;
 }
 
+bool AudioUnitEffect::SupportsParallelProcessing()
+{
+   // The master instance runs at the end of each cycle
+   return false;
+}
+
 bool AudioUnitEffect::ShowInterface(wxWindow *parent, bool forceModal)
 {
    if (mDialog)
@@ -100,6 +100,7 @@ public:
                                        float **outbuf,
                                        size_t numSamples) override;
    bool RealtimeProcessEnd() override;
+   bool SupportsParallelProcessing() override;
 
    bool ShowInterface(wxWindow *parent, bool forceModal = false) override;
 
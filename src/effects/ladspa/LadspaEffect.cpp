@@ -625,6 +625,7 @@ LadspaEffect::LadspaEffect(const wxString & path, int index)
    mBlockSize = 0;
 
    mLatencyPort = -1;
+   mLatencyDone = false;
 
    mDialog = NULL;
    mParent = NULL;
@@ -993,6 +994,8 @@ size_t LadspaEffect::ProcessBlock(float **inBlock, float **outBlock, size_t bloc
 
 bool LadspaEffect::RealtimeInitialize()
 {
+   mLatencyDone = false;
+
    return true;
 }
 
@@ -1060,6 +1063,12 @@ bool LadspaEffect::RealtimeProcessEnd()
    return true;
 }
 
+bool LadspaEffect::SupportsParallelProcessing()
+{
+   // All instances write the same output controls, including any latency
+   return mNumOutputControls == 0;
+}
+
 bool LadspaEffect::ShowInterface(wxWindow *parent, bool forceModal)
 {
    if (mDialog)
@@ -812,6 +812,8 @@ bool LV2Effect::RealtimeInitialize()
 
    lilv_instance_activate(mMaster);
 
+   mLatencyDone = false;
+
    return true;
 }
 
@@ -915,6 +917,13 @@ bool LV2Effect::RealtimeProcessEnd()
    return true;
 }
 
+bool LV2Effect::SupportsParallelProcessing()
+{
+   // Instances share the control values and the master instance runs
+   // at the end of each cycle
+   return false;
+}
+
 bool LV2Effect::ShowInterface(wxWindow *parent, bool forceModal)
 {
    if (mDialog)
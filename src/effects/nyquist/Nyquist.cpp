@@ -30,6 +30,7 @@ effects from this one class.
 #include "../../Experimental.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 
 #include <locale.h>
@@ -46,6 +47,7 @@ effects from this one class.
 #include <wx/sstream.h>
 #include <wx/stattext.h>
 #include <wx/textdlg.h>
+#include <wx/thread.h>
 #include <wx/tokenzr.h>
 #include <wx/txtstrm.h>
 #include <wx/valgen.h>
@@ -851,7 +853,9 @@ bool NyquistEffect::Process()
          wxString prevlocale = wxSetlocale(LC_NUMERIC, NULL);
          wxSetlocale(LC_NUMERIC, wxString(wxT("C")));
 
-         nyx_init();
+         // The first call loads the whole Nyquist runtime, which takes a
+         // while, so it is evaluated like the rest
+         Evaluate( [] { nyx_init(); } );
          nyx_set_os_callback(StaticOSCallback, (void *)this);
          nyx_capture_output(StaticOutputCallback, (void *)this);
 
@@ -1317,18 +1321,19 @@ bool NyquistEffect::ProcessOne()
    }
 
    // Put the fetch buffers in a clean initial state
-   for (size_t i = 0; i < mCurNumChannels; i++)
-      mCurBuffer[i].Free();
+   FreeFetchBuffers();
 
    // Guarantee release of memory when done
    auto cleanup = finally( [&] {
-      for (size_t i = 0; i < mCurNumChannels; i++)
-         mCurBuffer[i].Free();
+      FreeFetchBuffers();
    } );
 
    // Evaluate the expression, which may invoke the get callback, but often does
    // not, leaving that to delayed evaluation of the output sound
-   rval = nyx_eval_expression(cmd.mb_str(wxConvUTF8));
+   {
+      const auto expression = cmd.mb_str(wxConvUTF8);
+      Evaluate( [&] { rval = nyx_eval_expression(expression); } );
+   }
 
    // If we're not showing debug window, log errors and warnings:
    if (!mDebugOutput.empty() && !mDebug && !mTrace) {
@@ -1459,18 +1464,20 @@ bool NyquistEffect::ProcessOne()
       }
 
       outputTrack[i] = mFactory->NewWaveTrack(format, rate);
-
-      // Clean the initial buffer states again for the get callbacks
-      // -- is this really needed?
-      mCurBuffer[i].Free();
    }
 
+   // Clean the initial buffer states again for the get callbacks
+   // -- is this really needed?
+   FreeFetchBuffers();
+
    // Now fully evaluate the sound
    int success;
    {
       auto vr0 = valueRestorer( mOutputTrack[0], outputTrack[0].get() );
       auto vr1 = valueRestorer( mOutputTrack[1], outputTrack[1].get() );
-      success = nyx_get_audio(StaticPutCallback, (void *)this);
+      Evaluate( [&] {
+         success = nyx_get_audio(StaticPutCallback, (void *)this);
+      } );
    }
 
    // See if GetCallback found read errors
@@ -2231,6 +2238,9 @@ int NyquistEffect::StaticGetCallback(float *buffer, int channel,
 int NyquistEffect::GetCallback(float *buffer, int ch,
                                long start, long len, long WXUNUSED(totlen))
 {
+   if (mCancelling)
+      return -1;
+
    if (mCurBuffer[ch].ptr()) {
       if ((mCurStart[ch] + start) < mCurBufferStart[ch] ||
           (mCurStart[ch] + start)+len >
@@ -2240,22 +2250,40 @@ int NyquistEffect::GetCallback(float *buffer, int ch,
    }
 
    if (!mCurBuffer[ch].ptr()) {
-      mCurBufferStart[ch] = (mCurStart[ch] + start);
-      mCurBufferLen[ch] = mCurTrack[ch]->GetBestBlockSize(mCurBufferStart[ch]);
+      try {
+         // Nyquist reads forward, so the block read ahead is usually the
+         // one wanted
+         if (mPrefetch[ch]) {
+            auto prefetch = std::move(mPrefetch[ch]);
+            prefetch->Wait();
+            if ((mCurStart[ch] + start) >= mNextBufferStart[ch] &&
+                (mCurStart[ch] + start)+len <=
+                mNextBufferStart[ch]+mNextBufferLen[ch]) {
+               mCurBuffer[ch].Swap(mNextBuffer[ch]);
+               mCurBufferStart[ch] = mNextBufferStart[ch];
+               mCurBufferLen[ch] = mNextBufferLen[ch];
+            }
+         }
 
-      if (mCurBufferLen[ch] < (size_t) len) {
-         mCurBufferLen[ch] = mCurTrack[ch]->GetIdealBlockSize();
-      }
+         if (!mCurBuffer[ch].ptr()) {
+            mCurBufferStart[ch] = (mCurStart[ch] + start);
+            mCurBufferLen[ch] = mCurTrack[ch]->GetBestBlockSize(mCurBufferStart[ch]);
 
-      mCurBufferLen[ch] =
-         limitSampleBufferSize( mCurBufferLen[ch],
-                                mCurStart[ch] + mCurLen - mCurBufferStart[ch] );
+            if (mCurBufferLen[ch] < (size_t) len) {
+               mCurBufferLen[ch] = mCurTrack[ch]->GetIdealBlockSize();
+            }
 
-      mCurBuffer[ch].Allocate(mCurBufferLen[ch], floatSample);
-      try {
-         mCurTrack[ch]->Get(
-            mCurBuffer[ch].ptr(), floatSample,
-            mCurBufferStart[ch], mCurBufferLen[ch]);
+            mCurBufferLen[ch] =
+               limitSampleBufferSize( mCurBufferLen[ch],
+                                      mCurStart[ch] + mCurLen - mCurBufferStart[ch] );
+
+            mCurBuffer[ch].Allocate(mCurBufferLen[ch], floatSample);
+            mCurTrack[ch]->Get(
+               mCurBuffer[ch].ptr(), floatSample,
+               mCurBufferStart[ch], mCurBufferLen[ch]);
+         }
+
+         StartPrefetch(ch);
       }
       catch ( ... ) {
          // Save the exception object for re-throw when out of the library
@@ -2271,6 +2299,7 @@ int NyquistEffect::GetCallback(float *buffer, int ch,
                (samplePtr)buffer, floatSample,
                len);
 
+   // The main thread shows the progress
    if (ch == 0) {
       double progress = mScale *
          ( (start+len)/ mCurLen.as_double() );
@@ -2278,15 +2307,45 @@ int NyquistEffect::GetCallback(float *buffer, int ch,
       if (progress > mProgressIn) {
          mProgressIn = progress;
       }
-
-      if (TotalProgress(mProgressIn+mProgressOut+mProgressTot)) {
-         return -1;
-      }
    }
 
    return 0;
 }
 
+// Starts reading the block after the current one of the channel, if the
+// selection goes on
+void NyquistEffect::StartPrefetch(int ch)
+{
+   const auto start = mCurBufferStart[ch] + mCurBufferLen[ch];
+   const auto end = mCurStart[ch] + mCurLen;
+   if (start >= end)
+      return;
+
+   const auto len = limitSampleBufferSize(
+      std::max(mCurTrack[ch]->GetBestBlockSize(start), mCurBufferLen[ch]),
+      end - start );
+   mNextBufferStart[ch] = start;
+   mNextBufferLen[ch] = len;
+   mNextBuffer[ch].Allocate(len, floatSample);
+
+   const auto track = mCurTrack[ch];
+   const auto buffer = mNextBuffer[ch].ptr();
+   mPrefetch[ch] = std::make_unique<ThreadPool::Batch>(ThreadPool::Get());
+   mPrefetch[ch]->Add( [=] {
+      track->Get(buffer, floatSample, start, len);
+   } );
+}
+
+void NyquistEffect::FreeFetchBuffers()
+{
+   for (size_t i = 0; i < mCurNumChannels; i++) {
+      // Waits for a pending read, before its buffer goes
+      mPrefetch[i].reset();
+      mNextBuffer[i].Free();
+      mCurBuffer[i].Free();
+   }
+}
+
 int NyquistEffect::StaticPutCallback(float *buffer, int channel,
                                      long start, long len, long totlen,
                                      void *userdata)
@@ -2300,16 +2359,16 @@ int NyquistEffect::PutCallback(float *buffer, int channel,
 {
    // Don't let C++ exceptions propagate through the Nyquist library
    return GuardedCall<int>( [&] {
+      if (mCancelling)
+         return -1;
+
+      // The main thread shows the progress
       if (channel == 0) {
          double progress = mScale*((float)(start+len)/totlen);
 
          if (progress > mProgressOut) {
             mProgressOut = progress;
          }
-
-         if (TotalProgress(mProgressIn+mProgressOut+mProgressTot)) {
-            return -1;
-         }
       }
 
       mOutputTrack[channel]->Append((samplePtr)buffer, floatSample, len);
@@ -2354,19 +2413,111 @@ void NyquistEffect::OSCallback()
       nyx_continue();
    }
 
-   // LLL:  STF figured out that yielding while the effect is being applied
-   //       produces an EXTREME slowdown.  It appears that yielding is not
-   //       really necessary on Linux and Windows.
-   //
-   //       However, on the Mac, the spinning cursor appears during longer
-   //       Nyquist processing and that may cause the user to think Audacity
-   //       has crashed or hung.  In addition, yielding or not on the Mac
-   //       doesn't seem to make much of a difference in execution time.
-   //
-   //       So, yielding on the Mac only...
-#if defined(__WXMAC__)
-   wxYieldIfNeeded();
-#endif
+   // This is called on the evaluating thread, so there is no yielding
+   // here; the main thread keeps the user interface going in Evaluate()
+}
+
+namespace {
+
+// XLisp recurses deeply on the C stack, so evaluation gets a thread with
+// a stack as big as a main thread's
+const unsigned EvaluationStackSize = 8 * 1024 * 1024;
+
+class NyquistEvaluationThread final : public wxThread
+{
+public:
+   explicit NyquistEvaluationThread(std::function<void()> run)
+      : wxThread{ wxTHREAD_JOINABLE }
+      , mRun{ std::move(run) }
+   {}
+
+   ExitCode Entry() override
+   {
+      mRun();
+      return 0;
+   }
+
+private:
+   std::function<void()> mRun;
+};
+
+// The effect whose evaluation runs on this thread, if any
+thread_local NyquistEffect *sEvaluatingEffect = nullptr;
+
+}
+
+// Runs an evaluation by the interpreter on a thread of its own.  Meanwhile
+// the main thread shows the progress that the callbacks record, passes
+// cancellation back to them, and makes the calls that the evaluation
+// needs made there.
+void NyquistEffect::Evaluate(const std::function<void()> &evaluation)
+{
+   mEvaluationDone = false;
+   mMainThreadCall = nullptr;
+   mCancelling = false;
+
+   NyquistEvaluationThread thread{ [&] {
+      sEvaluatingEffect = this;
+      evaluation();
+      sEvaluatingEffect = nullptr;
+
+      std::lock_guard<std::mutex> lock{ mEvaluationMutex };
+      mEvaluationDone = true;
+      mEvaluationCondition.notify_all();
+   } };
+   if (thread.Create(EvaluationStackSize) != wxTHREAD_NO_ERROR ||
+       thread.Run() != wxTHREAD_NO_ERROR) {
+      // Without a thread, evaluate here as before
+      evaluation();
+      mEvaluationDone = true;
+      return;
+   }
+
+   std::unique_lock<std::mutex> lock{ mEvaluationMutex };
+   while (!mEvaluationDone) {
+      if (mMainThreadCall) {
+         lock.unlock();
+         (*mMainThreadCall)();
+         lock.lock();
+         mMainThreadCall = nullptr;
+         mEvaluationCondition.notify_all();
+         continue;
+      }
+
+      lock.unlock();
+      if (!mCancelling && TotalProgress(mProgressIn+mProgressOut+mProgressTot)) {
+         // The callbacks fail from now on, and evaluation that does not
+         // call them is stopped
+         mCancelling = true;
+         mStop = true;
+      }
+      lock.lock();
+
+      mEvaluationCondition.wait_for(lock, std::chrono::milliseconds(100),
+         [this]{ return mEvaluationDone || mMainThreadCall; });
+   }
+   lock.unlock();
+
+   thread.Wait();
+}
+
+void NyquistEffect::CallOnMainThread(const std::function<void()> &call)
+{
+   const auto effect = sEvaluatingEffect;
+   if (!effect) {
+      call();
+      return;
+   }
+
+   // The call may change the tracks, so finish the reads ahead before it
+   // and read the samples again after it
+   effect->FreeFetchBuffers();
+
+   std::unique_lock<std::mutex> lock{ effect->mEvaluationMutex };
+   effect->mMainThreadCall = &call;
+   effect->mEvaluationCondition.notify_all();
+   effect->mEvaluationCondition.wait(lock,
+      [effect]{ return effect->mMainThreadCall == nullptr; });
 }
 
 FilePaths NyquistEffect::GetNyquistSearchPath()
@@ -3230,8 +3381,11 @@ LVAL xlc_aud_do(void)
     /* setup the string pointer */
     leftp = getstring(src);
 
-    // Go call my real function here...
-    dst = (LVAL)ExecForLisp( (char *)leftp );
+    // Go call my real function here, on the main thread, which owns the
+    // project and the user interface
+    NyquistEffect::CallOnMainThread( [&] {
+       dst = (LVAL)ExecForLisp( (char *)leftp );
+    } );
 
     //dst = cons(dst, (LVAL)1);
     /* return the new string */
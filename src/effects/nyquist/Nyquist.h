@@ -12,6 +12,13 @@
 #define __AUDACITY_EFFECT_NYQUIST__
 
 #include "../Effect.h"
+#include "../../ThreadPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 
 #include "nyx.h"
 
@@ -132,6 +139,10 @@ private:
 
    static FilePaths GetNyquistSearchPath();
 
+   /// On the thread evaluating Nyquist, runs the call on the main thread
+   /// and waits for it; on other threads, just runs it
+   static void CallOnMainThread(const std::function<void()> &call);
+
    static wxString NyquistToWxString(const char *nyqString);
    wxString EscapeString(const wxString & inStr);
    static std::vector<EnumValueSymbol> ParseChoice(const wxString & text);
@@ -152,6 +163,10 @@ private:
    void OutputCallback(int c);
    void OSCallback();
 
+   void Evaluate(const std::function<void()> &evaluation);
+   void StartPrefetch(int ch);
+   void FreeFetchBuffers();
+
    void ParseFile();
    bool ParseCommand(const wxString & cmd);
    bool ParseProgram(wxInputStream & stream);
@@ -193,9 +208,9 @@ private:
    wxFileName        mFileName;  ///< Name of the Nyquist script file this effect is loaded from
    wxDateTime        mFileModified; ///< When the script was last modified on disk
 
-   bool              mStop;
-   bool              mBreak;
-   bool              mCont;
+   std::atomic<bool> mStop;
+   std::atomic<bool> mBreak;
+   std::atomic<bool> mCont;
 
    bool              mFoundType;
    bool              mCompiler;
@@ -250,8 +265,10 @@ private:
    double            mOutputTime;
    unsigned          mCount;
    unsigned          mNumSelectedChannels;
-   double            mProgressIn;
-   double            mProgressOut;
+   // Set by the callbacks on the evaluating thread, and shown by the
+   // main thread
+   std::atomic<double> mProgressIn;
+   std::atomic<double> mProgressOut;
    double            mProgressTot;
    double            mScale;
 
@@ -259,6 +276,13 @@ private:
    sampleCount       mCurBufferStart[2];
    size_t            mCurBufferLen[2];
 
+   // The block after mCurBuffer, read on the thread pool while Nyquist
+   // works on the current one
+   SampleBuffer      mNextBuffer[2];
+   sampleCount       mNextBufferStart[2];
+   size_t            mNextBufferLen[2];
+   std::unique_ptr<ThreadPool::Batch> mPrefetch[2];
+
    WaveTrack        *mOutputTrack[2];
 
    wxArrayString     mCategories;
@@ -274,6 +298,13 @@ private:
 
    std::exception_ptr mpException {};
 
+   // Hand-off between the evaluating thread and the main thread
+   std::mutex        mEvaluationMutex;
+   std::condition_variable mEvaluationCondition;
+   const std::function<void()> *mMainThreadCall{};
+   bool              mEvaluationDone{ true };
+   std::atomic<bool> mCancelling{ false };
+
    DECLARE_EVENT_TABLE()
 
    friend class NyquistEffectsModule;
@@ -4,11 +4,13 @@
 #include <wx/bmpbuttn.h>
 #include <wx/textctrl.h>
 #include <wx/frame.h>
+#include <wx/timer.h>
+#include <wx/weakref.h>
 
 #include "../AboutDialog.h"
 #include "../AllThemeResources.h"
 #include "../AudacityLogger.h"
-#include "../AudioIOBase.h"
+#include "../AudioIO.h"
 #include "../CommonCommandFlags.h"
 #include "../CrashReport.h"
 #include "../Dependencies.h"
@@ -275,6 +277,118 @@ void QuickFixDialog::OnFix(wxCommandEvent &event)
       pWin->SetFocus( );
 }
 
+/** @brief Modeless dialog showing the audio engine's health counters,
+ * refreshed while it is shown and a stream runs.
+ */
+class AudioHealthDialog final : public wxDialogWrapper
+{
+public:
+   AudioHealthDialog(wxWindow * pParent);
+   void Activate();
+
+private:
+   void Update();
+
+   void OnAudioIO(wxCommandEvent &event);
+   void OnTimer(wxTimerEvent &event);
+   void OnReset(wxCommandEvent &event);
+   void OnCancel(wxCommandEvent &event);
+
+   wxTextCtrl *mText;
+   wxTimer mTimer;
+   DECLARE_EVENT_TABLE()
+};
+
+#define ResetButtonID         7031
+#define HealthTimerID         7032
+
+BEGIN_EVENT_TABLE(AudioHealthDialog, wxDialogWrapper)
+   EVT_BUTTON(ResetButtonID,  AudioHealthDialog::OnReset)
+   EVT_BUTTON(wxID_CANCEL,    AudioHealthDialog::OnCancel)
+   EVT_TIMER(HealthTimerID,   AudioHealthDialog::OnTimer)
+END_EVENT_TABLE();
+
+AudioHealthDialog::AudioHealthDialog(wxWindow * pParent) :
+      wxDialogWrapper(pParent, wxID_ANY, _("Audio Engine Health"),
+            wxDefaultPosition, wxDefaultSize,
+            wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER )
+   , mTimer(this, HealthTimerID)
+{
+   SetName(GetTitle());
+   ShuttleGui S(this, eIsCreating);
+   S.StartVerticalLay();
+   {
+      S.SetStyle(wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP);
+      mText = S.Id(wxID_STATIC).AddTextWindow(wxT(""));
+      S.StartHorizontalLay(wxALIGN_CENTER_HORIZONTAL, 0);
+      {
+         S.Id(ResetButtonID).AddButton(_("&Reset"));
+         S.AddStandardButtons(eCloseButton);
+      }
+      S.EndHorizontalLay();
+   }
+   S.EndVerticalLay();
+
+   SetSize(420, 600);
+
+   wxTheApp->Bind(EVT_AUDIOIO_PLAYBACK, &AudioHealthDialog::OnAudioIO, this);
+   wxTheApp->Bind(EVT_AUDIOIO_CAPTURE, &AudioHealthDialog::OnAudioIO, this);
+   wxTheApp->Bind(EVT_AUDIOIO_MONITOR, &AudioHealthDialog::OnAudioIO, this);
+}
+
+void AudioHealthDialog::Activate()
+{
+   Update();
+   auto gAudioIO = AudioIO::Get();
+   if (gAudioIO && gAudioIO->IsStreamActive())
+      // Often enough to watch, seldom enough not to disturb the audio
+      mTimer.Start(500);
+   Show();
+   Raise();
+}
+
+void AudioHealthDialog::Update()
+{
+   auto gAudioIO = AudioIO::Get();
+   if (gAudioIO)
+      mText->ChangeValue(gAudioIO->mHealth.Report());
+}
+
+void AudioHealthDialog::OnAudioIO(wxCommandEvent &event)
+{
+   event.Skip();
+   if (!IsShown())
+      return;
+
+   if (event.GetInt())
+      mTimer.Start(500);
+   else {
+      // Show the final counts of the stream, then stop polling
+      mTimer.Stop();
+      Update();
+   }
+}
+
+void AudioHealthDialog::OnTimer(wxTimerEvent & WXUNUSED(event))
+{
+   Update();
+}
+
+void AudioHealthDialog::OnReset(wxCommandEvent & WXUNUSED(event))
+{
+   // Racing with the audio threads can only lose a few counts
+   auto gAudioIO = AudioIO::Get();
+   if (gAudioIO)
+      gAudioIO->mHealth.Reset();
+   Update();
+}
+
+void AudioHealthDialog::OnCancel(wxCommandEvent & WXUNUSED(event))
+{
+   mTimer.Stop();
+   Hide();
+}
+
 }
 
 namespace HelpActions {
@@ -317,6 +431,21 @@ void OnAudioDeviceInfo(const CommandContext &context)
       _("Audio Device Info"), wxT("deviceinfo.txt") );
 }
 
+void OnAudioHealth(const CommandContext &context)
+{
+   auto &project = context.project;
+   // One window at a time, kept while hidden, owned by the last project
+   // that asked for it
+   static wxWeakRef< AudioHealthDialog > sDialog;
+   if (!sDialog || sDialog->GetParent() != &GetProjectFrame( project ))
+   {
+      if (sDialog)
+         sDialog->Destroy();
+      sDialog = safenew AudioHealthDialog( &GetProjectFrame( project ) );
+   }
+   sDialog->Activate();
+}
+
 #ifdef EXPERIMENTAL_MIDI_OUT
 void OnMidiDeviceInfo(const CommandContext &context)
 {
@@ -443,6 +572,9 @@ MenuTable::BaseItemPtr HelpMenu( AudacityProject & )
          Command( wxT("DeviceInfo"), XXO("Au&dio Device Info..."),
             FN(OnAudioDeviceInfo),
             AudioIONotBusyFlag ),
+         Command( wxT("AudioHealth"), XXO("Audio &Engine Health..."),
+            FN(OnAudioHealth),
+            AlwaysEnabledFlag ),
    #ifdef EXPERIMENTAL_MIDI_OUT
          Command( wxT("MidiDeviceInfo"), XXO("&MIDI Device Info..."),
             FN(OnMidiDeviceInfo),
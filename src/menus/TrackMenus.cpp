@@ -2,6 +2,7 @@
 #include "../Experimental.h"
 
 #include "../CommonCommandFlags.h"
+#include "../FrozenTracks.h"
 #include "../LabelTrack.h"
 #include "../Menus.h"
 #include "../MissingAliasFileDialog.h"
@@ -786,6 +787,46 @@ void OnResample(const CommandContext &context)
    window.FinishAutoScroll();
 }
 
+void OnFreezeTracks(const CommandContext &context)
+{
+   auto &project = context.project;
+   auto &tracks = TrackList::Get( project );
+   auto &frozenTracks = FrozenTracks::Get( project );
+   const auto rate = ProjectSettings::Get( project ).GetRate();
+
+   auto channels = tracks.Selected< const WaveTrack >();
+   const auto nChannels = channels.size();
+   if (nChannels == 0)
+      return;
+
+   ProgressDialog progress(_("Freeze"), _("Rendering tracks for playback"));
+   int ndx = 0;
+   for (auto wt : channels)
+   {
+      // Renderings still up to date need not be made again
+      if (!frozenTracks.Find( *wt, rate ) &&
+          !frozenTracks.Freeze( *wt, rate, [&]( double fraction ){
+             return progress.Update( ndx + fraction, (double)nChannels ) ==
+                ProgressResult::Success;
+          } ))
+         return;
+      ++ndx;
+   }
+
+   ProjectStatus::Get( project ).Set(
+      wxString::Format(_("Froze %d channel(s) for playback"), ndx) );
+}
+
+void OnUnfreezeTracks(const CommandContext &context)
+{
+   auto &project = context.project;
+   auto &tracks = TrackList::Get( project );
+   auto &frozenTracks = FrozenTracks::Get( project );
+
+   for (auto wt : tracks.Selected< const WaveTrack >())
+      frozenTracks.Unfreeze( *wt );
+}
+
 void OnRemoveTracks(const CommandContext &context)
 {
    TrackUtilities::DoRemoveTracks( context.project );
@@ -1295,6 +1336,13 @@ MenuTable::BaseItemPtr TracksMenu( AudacityProject & )
       Command( wxT("Resample"), XXO("&Resample..."), FN(OnResample),
          AudioIONotBusyFlag | WaveTracksSelectedFlag ),
 
+      Command( wxT("FreezeTracks"), XXO("&Freeze Tracks"),
+         FN(OnFreezeTracks),
+         AudioIONotBusyFlag | WaveTracksSelectedFlag ),
+      Command( wxT("UnfreezeTracks"), XXO("Unfree&ze Tracks"),
+         FN(OnUnfreezeTracks),
+         AudioIONotBusyFlag | WaveTracksSelectedFlag ),
+
       Separator(),
 
       Command( wxT("RemoveTracks"), XXO("Remo&ve Tracks"), FN(OnRemoveTracks),
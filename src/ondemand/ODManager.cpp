@@ -19,6 +19,7 @@ ODTask requests and internals.
 
 #include "ODTask.h"
 #include "ODWaveTrackTaskQueue.h"
+#include "../Profiler.h"
 #include "../Project.h"
 #include <NonGuiThread.h>
 #include <wx/utils.h>
@@ -116,6 +117,7 @@ void *ODTaskThread::Entry()
 
 #endif
 {
+   Profiler::Instance()->SetThreadName("On-Demand");
    //TODO: Figure out why this has no effect at all.
    //wxThread::This()->SetPriority( 40);
    //Do at least 5 percent of the task
@@ -25,8 +25,7 @@ in a background thread.
 #include "../WaveTrack.h"
 #include "../Project.h"
 #include "../UndoManager.h"
-//temporarily commented out till it is added to all projects
-//#include "../Profiler.h"
+#include "../Profiler.h"
 
 
 wxDEFINE_EVENT(EVT_ODTASK_COMPLETE, wxCommandEvent);
@@ -70,6 +69,7 @@ void ODTask::TerminateAndBlock()
 /// will do the smallest unit of work possible
 void ODTask::DoSome(float amountWork)
 {
+   PROFILE_SCOPE("ODTask::DoSome");
    SetIsRunning(true);
    mBlockUntilTerminateMutex.Lock();
 
@@ -47,13 +47,22 @@ bool XMLFileReader::Parse(XMLTagHandler *baseHandler,
 
    mBaseHandler = baseHandler;
 
-   const size_t bufferSize = 16384;
-   char buffer[16384];
+   // Read directly into expat's own buffer, avoiding a copy of every chunk,
+   // and use large chunks so that big projects need fewer reads.
+   const size_t bufferSize = 256 * 1024;
    int done = 0;
    do {
+      void *buffer = XML_GetBuffer(mParser, bufferSize);
+      if (!buffer) {
+         mErrorStr.Printf(_("Error: %hs at line %lu"),
+                          XML_ErrorString(XML_GetErrorCode(mParser)),
+                          (long unsigned int)XML_GetCurrentLineNumber(mParser));
+         theXMLFile.Close();
+         return false;
+      }
       size_t len = fread(buffer, 1, bufferSize, theXMLFile.fp());
       done = (len < bufferSize);
-      if (!XML_Parse(mParser, buffer, len, done)) {
+      if (!XML_ParseBuffer(mParser, len, done)) {
          mErrorStr.Printf(_("Error: %hs at line %lu"),
                           XML_ErrorString(XML_GetErrorCode(mParser)),
                           (long unsigned int)XML_GetCurrentLineNumber(mParser));